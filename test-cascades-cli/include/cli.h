@@ -5,6 +5,7 @@
 #define CLI_H_
 
 #include <QFile>
+#include <QAbstractSocket>
 
 namespace truphone
 {
@@ -18,6 +19,9 @@ namespace cli
      * Internal data
      */
     class HarnessCliPrviate;
+    class Script;
+    class ResultsWriter;
+    class RecordWriter;
     /*!
      * \brief The HarnessCli class is responsible for
      * processing script files and recording the results to
@@ -31,22 +35,35 @@ namespace cli
         Q_OBJECT
         public:
             /*!
-             * \brief HarnessCli Create a new CLI
+             * \brief HarnessCli Create a new CLI that plays a script
              *
              * \param host The address of the target
              * \param port The port number to connect to on @c host
-             * \param isRecord @c true if we intend to record rather than replay
-             * \param inFile The input file to send to @c host
-             * \param outFile The output file that we record the XML results in
+             * \param script The compiled script to send to @c host
+             * \param results The writer for the results of the script
              * \param parent The parent object
              *
-             * @since test-cascades 1.0.0
+             * @since test-cascades 1.1.5
+             */
+            HarnessCli(QString host,
+                       quint16 port,
+                       const Script * const script,
+                       ResultsWriter * const results,
+                       QObject * parent = 0);
+            /*!
+             * \brief HarnessCli Create a new CLI that records the events
+             * from the target
+             *
+             * \param host The address of the target
+             * \param port The port number to connect to on @c host
+             * \param recorder The writer for the recorded script
+             * \param parent The parent object
+             *
+             * @since test-cascades 1.1.5
              */
             HarnessCli(QString host,
                        quint16 port,
-                       bool isRecord,
-                       QFile * const inFile,
-                       QFile * const outFile = NULL,
+                       RecordWriter * const recorder,
                        QObject * parent = 0);
             /*!
              * \brief ~HarnessCli Destructor
@@ -54,13 +71,89 @@ namespace cli
              * @since test-cascades 1.0.0
              */
             virtual ~HarnessCli();
+            /*!
+             * \brief setLabel Set the label used to prefix the console
+             * output, used when several targets are driven at once
+             *
+             * \param label The label, normally host:port
+             *
+             * @since test-cascades 1.1.5
+             */
+            void setLabel(const QString& label);
+            /*!
+             * \brief receivedWelcome Has the target sent its welcome
+             * message, i.e. did it pass the health check
+             *
+             * \return @c true once the welcome was received
+             *
+             * @since test-cascades 1.1.5
+             */
+            bool receivedWelcome() const;
+            /*!
+             * \brief setKeepAlive Keep the connection open once a script
+             * finishes so another can be played with @c play
+             *
+             * \param keepAlive @c true to keep the connection
+             *
+             * @since test-cascades 1.1.5
+             */
+            void setKeepAlive(const bool keepAlive);
+            /*!
+             * \brief setOnDevice Upload each script and have the target
+             * play it (with the @c run command) rather than sending the
+             * commands one at a time. The results are the same but the
+             * time between commands doesn't include a network round trip.
+             *
+             * \param onDevice @c true to play the scripts on the target
+             *
+             * @since test-cascades 1.1.5
+             */
+            void setOnDevice(const bool onDevice);
+            /*!
+             * \brief isIdle Is the connection open and waiting for a script
+             *
+             * \return @c true if @c play can be called
+             *
+             * @since test-cascades 1.1.5
+             */
+            bool isIdle() const;
+            /*!
+             * \brief play Play another script on the open connection. The
+             * target is sent @c reset first to restore the application's state.
+             *
+             * \param script The compiled script to send
+             * \param results The writer for the results of the script
+             *
+             * @since test-cascades 1.1.5
+             */
+            void play(const Script * const script, ResultsWriter * const results);
         protected:
         private:
+            friend class HarnessCliPrviate;
+            /*!
+             * \brief initialise Connect the signals and the socket
+             *
+             * \param host The address of the target
+             * \param port The port number to connect to on @c host
+             *
+             * @since test-cascades 1.1.5
+             */
+            void initialise(const QString& host, const quint16 port);
             /*!
              * \brief privateData Private data for the CLI class.
              */
             HarnessCliPrviate * const pData;
-    private slots:
+    signals:
+        /*!
+         * \brief finished Emitted when the script has finished or the
+         * target couldn't be reached. With keep alive on the connection
+         * stays open if the target is still there (see @c isIdle).
+         *
+         * \param exitCode @c EXIT_SUCCESS if the script passed
+         *
+         * @since test-cascades 1.1.5
+         */
+        void finished(int exitCode);
     private slots:
         /*!
          * \brief disconnected Slot for disconnection
@@ -93,6 +186,21 @@ namespace cli
          * @since test-cascades 1.1.0
          */
         void connectionTimeout(void);
+        /*!
+         * \brief socketError Occurs when the TCP connection can't be made
+         *
+         * \param error The socket error
+         *
+         * @since test-cascades 1.1.5
+         */
+        void socketError(QAbstractSocket::SocketError error);
+        /*!
+         * \brief flushRecording Write out the recording and console
+         * output buffered since the last flush
+         *
+         * @since test-cascades 1.1.5
+         */
+        void flushRecording(void);
     };
 }  // namespace cli
 }  // namespace cascades
@@ -0,0 +1,130 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#ifndef HISTOGRAM_H_
+#define HISTOGRAM_H_
+
+#include <QVector>
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+namespace cli
+{
+    /*!
+     * \brief The LatencyHistogram class is a log-linear (HDR style)
+     * histogram of latencies in microseconds.
+     *
+     * Values below 64 are counted exactly, above that every power of
+     * two is split into 32 linear buckets, so any recorded value is
+     * reported to within about 3% whatever its size. Recording is
+     * constant time and histograms can be merged.
+     *
+     * @since test-cascades 1.1.5
+     */
+    class LatencyHistogram
+    {
+        public:
+            /*!
+             * \brief LatencyHistogram Create an empty histogram
+             *
+             * @since test-cascades 1.1.5
+             */
+            LatencyHistogram();
+            /*!
+             * \brief record Record a latency
+             *
+             * \param us The latency in microseconds
+             *
+             * @since test-cascades 1.1.5
+             */
+            void record(const qint64 us);
+            /*!
+             * \brief merge Add another histogram to this one
+             *
+             * \param other The histogram to add
+             *
+             * @since test-cascades 1.1.5
+             */
+            void merge(const LatencyHistogram& other);
+            /*!
+             * \brief count The number of values recorded
+             *
+             * \return The count
+             *
+             * @since test-cascades 1.1.5
+             */
+            quint64 count() const
+            {
+                return this->total;
+            }
+            /*!
+             * \brief max The largest value recorded
+             *
+             * \return The exact maximum in microseconds
+             *
+             * @since test-cascades 1.1.5
+             */
+            qint64 max() const
+            {
+                return this->maximum;
+            }
+            /*!
+             * \brief percentile Get a percentile
+             *
+             * \param percent The percentile (0-100)
+             *
+             * \return The highest value in the bucket holding the
+             * percentile, capped at the maximum, in microseconds
+             *
+             * @since test-cascades 1.1.5
+             */
+            qint64 percentile(const double percent) const;
+        protected:
+        private:
+            /*!
+             * \brief SUB_BUCKETS The linear buckets per power of two
+             */
+            static const int SUB_BUCKETS = 32;
+            /*!
+             * \brief buckets The counts
+             */
+            QVector<quint64> buckets;
+            /*!
+             * \brief total The number of values recorded
+             */
+            quint64 total;
+            /*!
+             * \brief maximum The largest value recorded
+             */
+            qint64 maximum;
+            /*!
+             * \brief bucketFor Get the bucket for a value
+             *
+             * \param value The value
+             *
+             * \return The bucket index
+             *
+             * @since test-cascades 1.1.5
+             */
+            static int bucketFor(const quint64 value);
+            /*!
+             * \brief highestValueIn Get the highest value counted by a bucket
+             *
+             * \param bucket The bucket index
+             *
+             * \return The value
+             *
+             * @since test-cascades 1.1.5
+             */
+            static quint64 highestValueIn(const int bucket);
+    };
+}  // namespace cli
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
+
+#endif  // HISTOGRAM_H_
@@ -0,0 +1,156 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#ifndef RECORDER_H_
+#define RECORDER_H_
+
+#include <QByteArray>
+#include <QString>
+#include <zlib.h>
+
+class QFile;
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+namespace cli
+{
+    /*!
+     * \brief The RecordWriter class writes a recording to disk.
+     *
+     * Output is buffered and only written out in large blocks or when
+     * @c flush is called (the CLI does that periodically). It can be
+     * gzip compressed as it's written and split into segments of a
+     * bounded size: the first segment is the file itself, then
+     * @c file.2, @c file.3 and so on. The size is counted before
+     * compression. Segments only ever split between lines and, when
+     * compressed, each closed segment is a complete gzip file; the one
+     * open when the process is killed is only synced up to the last
+     * @c flush and has no gzip trailer.
+     *
+     * @since test-cascades 1.1.5
+     */
+    class RecordWriter
+    {
+        public:
+            /*!
+             * \brief RecordWriter Create a new writer
+             *
+             * \param fileName The file to record to
+             * \param compress @c true to gzip the output
+             * \param segmentSize Start a new segment after this many bytes
+             * of recording (before compression), 0 for no limit
+             *
+             * @since test-cascades 1.1.5
+             */
+            RecordWriter(const QString& fileName,
+                         const bool compress,
+                         const qint64 segmentSize);
+            /*!
+             * \brief ~RecordWriter Destructor, closes the recording
+             *
+             * @since test-cascades 1.1.5
+             */
+            virtual ~RecordWriter();
+            /*!
+             * \brief open Open the first segment
+             *
+             * \return @c false if the file couldn't be opened
+             *
+             * @since test-cascades 1.1.5
+             */
+            bool open(void);
+            /*!
+             * \brief write Add to the recording
+             *
+             * \param data The data received from the target
+             *
+             * @since test-cascades 1.1.5
+             */
+            void write(const QByteArray& data);
+            /*!
+             * \brief flush Write out everything buffered so far
+             *
+             * @since test-cascades 1.1.5
+             */
+            void flush(void);
+            /*!
+             * \brief close Flush and close the recording
+             *
+             * @since test-cascades 1.1.5
+             */
+            void close(void);
+        protected:
+        private:
+            /*!
+             * \brief FLUSH_SIZE Write the buffer out once it's this big
+             */
+            static const int FLUSH_SIZE;
+            /*!
+             * \brief baseName The file of the first segment
+             */
+            const QString baseName;
+            /*!
+             * \brief gzip @c true to compress the output
+             */
+            const bool gzip;
+            /*!
+             * \brief maxSegment The segment size, 0 for no limit
+             */
+            const qint64 maxSegment;
+            /*!
+             * \brief file The current segment
+             */
+            QFile * file;
+            /*!
+             * \brief segment The number of the current segment
+             */
+            int segment;
+            /*!
+             * \brief segmentBytes The bytes recorded in the current segment
+             */
+            qint64 segmentBytes;
+            /*!
+             * \brief atLineStart @c true if the last byte recorded ended a line
+             */
+            bool atLineStart;
+            /*!
+             * \brief buffer Recording not yet written
+             */
+            QByteArray buffer;
+            /*!
+             * \brief stream The compressor for the current segment
+             */
+            z_stream stream;
+            /*!
+             * \brief openSegment Open the next segment
+             *
+             * \return @c false if the file couldn't be opened
+             *
+             * @since test-cascades 1.1.5
+             */
+            bool openSegment(void);
+            /*!
+             * \brief closeSegment Flush and close the current segment
+             *
+             * @since test-cascades 1.1.5
+             */
+            void closeSegment(void);
+            /*!
+             * \brief writeBuffer Write the buffer to the segment
+             *
+             * \param mode The zlib flush mode when compressing
+             *
+             * @since test-cascades 1.1.5
+             */
+            void writeBuffer(const int mode);
+    };
+}  // namespace cli
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
+
+#endif  // RECORDER_H_
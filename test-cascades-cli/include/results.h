@@ -0,0 +1,354 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#ifndef RESULTS_H_
+#define RESULTS_H_
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QList>
+#include <QMap>
+#include <QString>
+
+#include "include/histogram.h"
+
+class QIODevice;
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+namespace cli
+{
+    /*!
+     * \brief The ResultsWriter class streams the results of a script
+     * run to the XML results file and, once the run finishes, writes
+     * the same results as a JUnit test suite.
+     *
+     * Output is buffered and only written out in large blocks. Every
+     * command is a single @c command element with the time it was
+     * sent and answered, how long it took and how many retries it
+     * needed. Each request/reply pair is also added to a latency
+     * histogram for its command verb and the percentiles are written
+     * at the end of the results.
+     *
+     * Several commands can wait for replies at once; replies are taken
+     * to be for the oldest command still waiting. A command whose attempt
+     * failed waits behind the others until it is sent again.
+
+     * Commands the target plays itself are recorded once the target
+     * reports them, with the times it measured.
+     *
+     * @since test-cascades 1.1.5
+     */
+    class ResultsWriter
+    {
+        public:
+            /*!
+             * \brief ResultsWriter Create a new writer and write the
+             * XML header
+             *
+             * \param output The open results file
+             * \param junitFile The file to write the JUnit results to,
+             * empty for none
+             * \param suiteName The name of the JUnit suite (the script)
+             *
+             * @since test-cascades 1.1.5
+             */
+            ResultsWriter(QIODevice * const output,
+                          const QString& junitFile,
+                          const QString& suiteName);
+            /*!
+             * \brief ~ResultsWriter Destructor, flushes the buffer
+             *
+             * @since test-cascades 1.1.5
+             */
+            virtual ~ResultsWriter();
+            /*!
+             * \brief welcome Record the welcome from the target
+             *
+             * \param message The welcome message
+             *
+             * @since test-cascades 1.1.5
+             */
+            void welcome(const QString& message);
+            /*!
+             * \brief commandSent Record that a command was sent
+             *
+             * \param command The command
+             *
+             * @since test-cascades 1.1.5
+             */
+            void commandSent(const QString& command);
+            /*!
+             * \brief attemptFailed Record a failed reply that will be
+             * retried, the command moves behind the others waiting
+             *
+             * \param reply The reply
+             *
+             * @since test-cascades 1.1.5
+             */
+            void attemptFailed(const QString& reply);
+            /*!
+             * \brief retrySent Record that the oldest waiting command was
+             * sent again
+             *
+             * \param count The retry number
+             *
+             * @since test-cascades 1.1.5
+             */
+            void retrySent(const uint count);
+            /*!
+             * \brief commandReplied Record the final reply to the command
+             *
+             * \param reply The reply
+             * \param passed @c true if the reply was OK
+             * \param acceptedFailure @c true if a failure was accepted
+             *
+             * @since test-cascades 1.1.5
+             */
+            void commandReplied(const QString& reply,
+                                const bool passed,
+                                const bool acceptedFailure);
+            /*!
+             * \brief remoteAttempt Record a failed attempt of a command
+             * the target played itself (see the @c run command)
+             *
+             * \param command The command
+             * \param attemptUs The time of the attempt on the target
+             * \param reply The reply
+             *
+             * @since test-cascades 1.1.5
+             */
+            void remoteAttempt(const QString& command,
+                               const qint64 attemptUs,
+                               const QString& reply);
+            /*!
+             * \brief remoteReplied Record the final reply to a command
+             * the target played itself, using the times measured on the target
+             *
+             * \param command The command
+             * \param attemptUs The time of the last attempt
+             * \param durationUs The time from the first attempt to the reply
+             * \param reply The reply
+             * \param passed @c true if the reply was OK
+             * \param acceptedFailure @c true if a failure was accepted
+             *
+             * @since test-cascades 1.1.5
+             */
+            void remoteReplied(const QString& command,
+                               const qint64 attemptUs,
+                               const qint64 durationUs,
+                               const QString& reply,
+                               const bool passed,
+                               const bool acceptedFailure);
+            /*!
+             * \brief commandTerminated Record that the target went away
+             * before replying to the commands waiting
+             *
+             * @since test-cascades 1.1.5
+             */
+            void commandTerminated(void);
+            /*!
+             * \brief finish Close the results, flush them and write the
+             * JUnit results
+             *
+             * \param commandsLeft The number of commands never sent
+             *
+             * @since test-cascades 1.1.5
+             */
+            void finish(const int commandsLeft);
+            /*!
+             * \brief escape Escape a string for an XML attribute
+             *
+             * \param value The string to escape
+             *
+             * \return The escaped string
+             *
+             * @since test-cascades 1.1.5
+             */
+            static QString escape(const QString& value);
+            /*!
+             * \brief latencies The request/reply latencies so far
+             *
+             * \return The latency histograms keyed by command verb
+             *
+             * @since test-cascades 1.1.5
+             */
+            const QMap<QString, LatencyHistogram>& latencies() const
+            {
+                return this->verbLatencies;
+            }
+            /*!
+             * \brief latencyXml Format latency histograms as XML elements
+             *
+             * \param latencies The histograms keyed by command verb
+             *
+             * \return One @c latency element per verb
+             *
+             * @since test-cascades 1.1.5
+             */
+            static QByteArray latencyXml(const QMap<QString, LatencyHistogram>& latencies);
+        protected:
+        private:
+            /*!
+             * \brief FLUSH_SIZE Write the buffer out once it's this big
+             */
+            static const int FLUSH_SIZE;
+            /*!
+             * \brief output The results file
+             */
+            QIODevice * const output;
+            /*!
+             * \brief junitFile The JUnit results file
+             */
+            const QString junitFile;
+            /*!
+             * \brief suiteName The JUnit suite name
+             */
+            const QString suiteName;
+            /*!
+             * \brief buffer Results not yet written
+             */
+            QByteArray buffer;
+            /*!
+             * \brief junitCases The JUnit test cases so far
+             */
+            QByteArray junitCases;
+            /*!
+             * \brief clock Time since the run started
+             */
+            QElapsedTimer clock;
+            /*!
+             * \brief startedMs When the run started (ms since the epoch)
+             */
+            const qint64 startedMs;
+            /*!
+             * \brief tests The number of commands with a result
+             */
+            int tests;
+            /*!
+             * \brief failures The number of failed commands
+             */
+            int failures;
+            /*!
+             * \brief finished @c true once finish was called
+             */
+            bool finished;
+            /*!
+             * \brief The PendingCommand struct is a command waiting for
+             * a reply
+             */
+            struct PendingCommand
+            {
+                /*!
+                 * \brief command The command
+                 */
+                QString command;
+                /*!
+                 * \brief sentNs When the command was first sent (ns since start)
+                 */
+                qint64 sentNs;
+                /*!
+                 * \brief retries The number of retries of the command
+                 */
+                uint retries;
+                /*!
+                 * \brief attemptNs When the command was last (re)sent
+                 */
+                qint64 attemptNs;
+                /*!
+                 * \brief children The child elements of the command
+                 */
+                QByteArray children;
+            };
+            /*!
+             * \brief pending The commands waiting for replies, oldest first
+             */
+            QList<PendingCommand> pending;
+            /*!
+             * \brief verbLatencies The latency histograms keyed by verb
+             */
+            QMap<QString, LatencyHistogram> verbLatencies;
+            /*!
+             * \brief recordLatency Add the latency of the oldest command's
+             * attempt to the histogram for its verb
+             *
+             * @since test-cascades 1.1.5
+             */
+            void recordLatency(void);
+            /*!
+             * \brief remoteCommand Get the command played on the target,
+             * starting it if it's the first we've heard of it, and add
+             * the attempt's time to the histogram for its verb
+             *
+             * \param command The command
+             * \param attemptUs The time of the attempt
+             *
+             * \return The command
+             *
+             * @since test-cascades 1.1.5
+             */
+            PendingCommand& remoteCommand(const QString& command, const qint64 attemptUs);
+            /*!
+             * \brief closeReplied Write out the oldest waiting command
+             * with its final reply
+             *
+             * \param reply The reply
+             * \param passed @c true if the reply was OK
+             * \param acceptedFailure @c true if a failure was accepted
+             *
+             * @since test-cascades 1.1.5
+             */
+            void closeReplied(const QString& reply,
+                              const bool passed,
+                              const bool acceptedFailure);
+            /*!
+             * \brief nowMs The wall clock time
+             *
+             * \return ms since the epoch
+             *
+             * @since test-cascades 1.1.5
+             */
+            qint64 nowMs(void) const;
+            /*!
+             * \brief closeCommand Write out the oldest waiting command
+             *
+             * \param result The closing child element
+             * \param passed @c true if the command passed
+             * \param message The failure message for JUnit
+             *
+             * @since test-cascades 1.1.5
+             */
+            void closeCommand(const QByteArray& result,
+                              const bool passed,
+                              const QString& message);
+            /*!
+             * \brief append Add to the buffer, writing it out when full
+             *
+             * \param data The data to add
+             *
+             * @since test-cascades 1.1.5
+             */
+            void append(const QByteArray& data);
+            /*!
+             * \brief flush Write the buffer to the results file
+             *
+             * @since test-cascades 1.1.5
+             */
+            void flush(void);
+            /*!
+             * \brief writeJUnit Write the JUnit results file
+             *
+             * @since test-cascades 1.1.5
+             */
+            void writeJUnit(void);
+    };
+}  // namespace cli
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
+
+#endif  // RESULTS_H_
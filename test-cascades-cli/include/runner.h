@@ -0,0 +1,450 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#ifndef RUNNER_H_
+#define RUNNER_H_
+
+#include <QObject>
+#include <QDir>
+#include <QHash>
+#include <QList>
+#include <QQueue>
+#include <QStringList>
+#include <QElapsedTimer>
+#include <QMap>
+
+#include "include/histogram.h"
+
+class QFile;
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+namespace cli
+{
+    class HarnessCli;
+    class ScriptCompiler;
+    class ResultsWriter;
+    class RecordWriter;
+
+    /*!
+     * \brief The Device struct is a target the CLI can drive
+     *
+     * @since test-cascades 1.1.5
+     */
+    struct Device
+    {
+        /*!
+         * \brief host The address of the target
+         */
+        QString host;
+        /*!
+         * \brief port The port of the harness on @c host
+         */
+        quint16 port;
+    };
+
+    /*!
+     * \brief The HarnessRunner class runs scripts against one or more
+     * targets at the same time. Every target runs the scripts in order
+     * over its own connection, the results of each run go to their own
+     * XML file and, when asked for, an aggregated summary is written
+     * once every target has finished.
+     *
+     * In sharded mode each script runs once on whichever target gets to
+     * it first. Scripts are handed out longest first using their
+     * previous durations, idle targets steal from the busiest queue and
+     * a target that can't be reached is dropped from the pool with its
+     * scripts given to the others.
+     *
+     * @since test-cascades 1.1.5
+     */
+    class HarnessRunner : public QObject
+    {
+        Q_OBJECT
+        public:
+            /*!
+             * \brief HarnessRunner Create a new runner
+             *
+             * \param devices The targets to run the scripts on
+             * \param scripts The scripts to run on every target
+             * \param isRecord @c true to record into the (only) script
+             * \param summaryFile Where to write the summary, empty for none
+             * \param parent The parent object
+             *
+             * @since test-cascades 1.1.5
+             */
+            HarnessRunner(const QList<Device>& devices,
+                          const QStringList& scripts,
+                          const bool isRecord,
+                          const QString& summaryFile,
+                          QObject * parent = 0);
+            /*!
+             * \brief ~HarnessRunner Destructor
+             *
+             * @since test-cascades 1.1.5
+             */
+            virtual ~HarnessRunner();
+            /*!
+             * \brief parseDevices Parse a device list. @c list is either
+             * a file with one host:port per line (# starts a comment) or
+             * a comma separated list of host:port.
+             *
+             * \param list The device list or file name
+             * \param devices The list to append the devices to
+             *
+             * \return @c false if an entry couldn't be parsed
+             *
+             * @since test-cascades 1.1.5
+             */
+            static bool parseDevices(const QString& list,
+                                     QList<Device> * const devices);
+            /*!
+             * \brief resultsFileName Get the name of the results file for
+             * a script. The target is only part of the name when several
+             * targets are in use.
+             *
+             * \param script The script file
+             * \param device The target
+             * \param multiDevice @c true if several targets are in use
+             *
+             * \return The name of the XML results file
+             *
+             * @since test-cascades 1.1.5
+             */
+            static QString resultsFileName(const QString& script,
+                                           const Device& device,
+                                           const bool multiDevice);
+            /*!
+             * \brief setSharded Run each script once across the pool of
+             * targets rather than on every target
+             *
+             * \param scriptDir The directory the scripts are in
+             * \param durationsFile The file holding the previous duration
+             * of each script, one '<durationMs> <script>' per line with
+             * the script's path relative to @c scriptDir. It's updated
+             * with the measured durations once the runs finish. Empty for
+             * none.
+             *
+             * @since test-cascades 1.1.5
+             */
+            void setSharded(const QString& scriptDir, const QString& durationsFile);
+            /*!
+             * \brief setReuseConnections Play every script for a target over
+             * one connection, resetting the application between scripts,
+             * rather than connecting for each script
+             *
+             * \param reuse @c true to keep the connections
+             *
+             * @since test-cascades 1.1.5
+             */
+            void setReuseConnections(const bool reuse);
+            /*!
+             * \brief setOnDevice Upload each script to the target and have
+             * it play the script rather than sending it a command at a time
+             *
+             * \param onDevice @c true to play the scripts on the targets
+             *
+             * @since test-cascades 1.1.5
+             */
+            void setOnDevice(const bool onDevice);
+            /*!
+             * \brief setRecordOptions Set how recordings are written
+             *
+             * \param compress @c true to gzip the recordings
+             * \param segmentSize Split recordings into files of this
+             * many bytes (before compression), 0 for no limit
+             *
+             * @since test-cascades 1.1.5
+             */
+            void setRecordOptions(const bool compress, const qint64 segmentSize);
+        public slots:
+            /*!
+             * \brief start Start the first script on every target
+             *
+             * @since test-cascades 1.1.5
+             */
+            void start(void);
+        protected:
+        private:
+            /*!
+             * \brief The Run struct is a single script run on a target
+             */
+            struct Run
+            {
+                /*!
+                 * \brief device The index of the target
+                 */
+                int device;
+                /*!
+                 * \brief script The script file name
+                 */
+                QString script;
+                /*!
+                 * \brief results The results file name
+                 */
+                QString results;
+                /*!
+                 * \brief exitCode The result of the run
+                 */
+                int exitCode;
+                /*!
+                 * \brief durationMs How long the run took
+                 */
+                qint64 durationMs;
+                /*!
+                 * \brief requeued The target failed its health check and
+                 * the script was given to another target
+                 */
+                bool requeued;
+                /*!
+                 * \brief timer Started when the run starts
+                 */
+                QElapsedTimer timer;
+                /*!
+                 * \brief recorder The writer for the script being recorded
+                 */
+                RecordWriter * recorder;
+                /*!
+                 * \brief outputFile The open results file
+                 */
+                QFile * outputFile;
+                /*!
+                 * \brief writer Writes the results to @c outputFile
+                 */
+                ResultsWriter * writer;
+            };
+            /*!
+             * \brief devices The targets
+             */
+            const QList<Device> devices;
+            /*!
+             * \brief scripts The scripts to run
+             */
+            const QStringList scripts;
+            /*!
+             * \brief recordMode @c true if recording
+             */
+            const bool recordMode;
+            /*!
+             * \brief summaryFile The summary file name, empty for none
+             */
+            const QString summaryFile;
+            /*!
+             * \brief compiler Compiles (and caches) the scripts
+             */
+            ScriptCompiler * const compiler;
+            /*!
+             * \brief sharded @c true if each script runs once across the pool
+             */
+            bool sharded;
+            /*!
+             * \brief reuse @c true to keep the connections between scripts
+             */
+            bool reuse;
+            /*!
+             * \brief onDevice @c true to play the scripts on the targets
+             */
+            bool onDevice;
+            /*!
+             * \brief compressRecordings @c true to gzip recordings
+             */
+            bool compressRecordings;
+            /*!
+             * \brief recordSegmentSize The recording segment size, 0 for no limit
+             */
+            qint64 recordSegmentSize;
+            /*!
+             * \brief shardDir The directory of the sharded scripts
+             */
+            QDir shardDir;
+            /*!
+             * \brief durationsFile The file of previous durations
+             */
+            QString durationsFile;
+            /*!
+             * \brief durations The expected duration of each script
+             * keyed by its path relative to @c shardDir
+             */
+            QHash<QString, qint64> durations;
+            /*!
+             * \brief healthy @c false for targets dropped from the pool
+             */
+            QList<bool> healthy;
+            /*!
+             * \brief queues The scripts still to run, per target. When
+             * sharded they're kept longest first.
+             */
+            QList<QQueue<QString> > queues;
+            /*!
+             * \brief runs Every run, in the order they started
+             */
+            QList<Run> runs;
+            /*!
+             * \brief active The run index of each running CLI
+             */
+            QHash<HarnessCli*, int> active;
+            /*!
+             * \brief idle The open connection of each target between
+             * scripts, when reusing connections
+             */
+            QHash<int, HarnessCli*> idle;
+            /*!
+             * \brief clock Time since the runner started
+             */
+            QElapsedTimer clock;
+            /*!
+             * \brief latencies The request/reply latencies of every
+             * finished run keyed by command verb
+             */
+            QMap<QString, LatencyHistogram> latencies;
+            /*!
+             * \brief startNextRun Start the next queued script on a target
+             *
+             * \param device The index of the target
+             *
+             * \return @c false if the target has nothing left to run
+             *
+             * @since test-cascades 1.1.5
+             */
+            bool startNextRun(const int device);
+            /*!
+             * \brief expectedDuration Get the expected duration of a
+             * script. Scripts without history are assumed to be as long as
+             * the longest known script so they start early.
+             *
+             * \param script The script
+             *
+             * \return The expected duration in ms
+             *
+             * @since test-cascades 1.1.5
+             */
+            qint64 expectedDuration(const QString& script) const;
+            /*!
+             * \brief durationKey Get the key of a script's duration, so
+             * scripts with the same name in different directories don't
+             * share one
+             *
+             * \param script The script
+             *
+             * \return The script's path relative to the script directory
+             *
+             * @since test-cascades 1.1.5
+             */
+            QString durationKey(const QString& script) const;
+            /*!
+             * \brief queuedLoad Get the expected time to run the scripts
+             * queued for a target
+             *
+             * \param device The index of the target
+             *
+             * \return The expected duration in ms
+             *
+             * @since test-cascades 1.1.5
+             */
+            qint64 queuedLoad(const int device) const;
+            /*!
+             * \brief enqueueSharded Queue a script on the least loaded
+             * healthy target, keeping its queue longest first
+             *
+             * \param script The script to queue
+             *
+             * \return @c false if there's no healthy target left
+             *
+             * @since test-cascades 1.1.5
+             */
+            bool enqueueSharded(const QString& script);
+            /*!
+             * \brief steal Move the shortest script from the busiest
+             * target's queue to an idle target
+             *
+             * \param device The index of the idle target
+             *
+             * \return @c false if there's nothing left to steal
+             *
+             * @since test-cascades 1.1.5
+             */
+            bool steal(const int device);
+            /*!
+             * \brief removeDevice Drop a target from the pool and hand its
+             * queued scripts to the others
+             *
+             * \param device The index of the target
+             *
+             * @since test-cascades 1.1.5
+             */
+            void removeDevice(const int device);
+            /*!
+             * \brief isBusy Is a target running a script
+             *
+             * \param device The index of the target
+             *
+             * \return @c true if a script is running on the target
+             *
+             * @since test-cascades 1.1.5
+             */
+            bool isBusy(const int device) const;
+            /*!
+             * \brief writeDurations Write the measured durations back to
+             * the durations file
+             *
+             * @since test-cascades 1.1.5
+             */
+            void writeDurations(void);
+            /*!
+             * \brief openFiles Open the results file, or the file to
+             * record to, for a run
+             *
+             * \param run The run to open the files for
+             *
+             * \return @c false if the files couldn't be opened
+             *
+             * @since test-cascades 1.1.5
+             */
+            bool openFiles(Run * const run);
+            /*!
+             * \brief closeFiles Close and free the files of a run
+             *
+             * \param run The run to close the files for
+             *
+             * @since test-cascades 1.1.5
+             */
+            void closeFiles(Run * const run);
+            /*!
+             * \brief finishIfIdle Write the summary and exit once nothing is running
+             *
+             * @since test-cascades 1.1.5
+             */
+            void finishIfIdle(void);
+            /*!
+             * \brief printLatencies Print the latency percentiles of
+             * every command verb
+             *
+             * @since test-cascades 1.1.5
+             */
+            void printLatencies(void);
+            /*!
+             * \brief writeSummary Write the aggregated summary file
+             *
+             * @since test-cascades 1.1.5
+             */
+            void writeSummary(void);
+        private slots:
+            /*!
+             * \brief cliFinished A script run has finished
+             *
+             * \param exitCode The result of the run
+             *
+             * @since test-cascades 1.1.5
+             */
+            void cliFinished(int exitCode);
+    };
+}  // namespace cli
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
+
+#endif  // RUNNER_H_
@@ -0,0 +1,358 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#ifndef SCRIPT_H_
+#define SCRIPT_H_
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+namespace cli
+{
+    /*!
+     * \brief The ScriptInstruction struct is a single compiled line of
+     * a script
+     *
+     * @since test-cascades 1.1.5
+     */
+    struct ScriptInstruction
+    {
+        /*!
+         * The kinds of instruction
+         */
+        typedef enum type
+        {
+            /*!
+             * A command to send to the target
+             */
+            COMMAND,
+            /*!
+             * A # comment
+             */
+            COMMENT,
+            /*!
+             * An empty line
+             */
+            BLANK,
+            /*!
+             * A cli-setting line
+             */
+            SETTING,
+            /*!
+             * A call line, only seen before the includes are resolved
+             */
+            CALL,
+            /*!
+             * The start of a called file
+             */
+            ENTER_FILE,
+            /*!
+             * The end of a called file
+             */
+            LEAVE_FILE
+        } type_t;
+
+        /*!
+         * The cli-setting values
+         */
+        typedef enum setting
+        {
+            /*!
+             * retry: retry failed commands
+             */
+            SETTING_RETRY,
+            /*!
+             * retry-interval: ms between retries
+             */
+            SETTING_RETRY_INTERVAL,
+            /*!
+             * retry-max-intervals: number of retries
+             */
+            SETTING_RETRY_MAX_INTERVALS,
+            /*!
+             * failure-ok: accept failures
+             */
+            SETTING_FAILURE_OK,
+            /*!
+             * window: independent commands in flight at once
+             */
+            SETTING_WINDOW
+        } setting_t;
+
+        /*!
+         * \brief type The kind of instruction
+         */
+        type_t type;
+        /*!
+         * \brief text The command, setting or comment (trimmed) or the
+         * file name for CALL, ENTER_FILE and LEAVE_FILE. For LEAVE_FILE
+         * it's the file that reading returns to.
+         */
+        QString text;
+        /*!
+         * \brief setting The setting changed by a SETTING instruction
+         */
+        setting_t setting;
+        /*!
+         * \brief value The new value for a SETTING instruction
+         */
+        int value;
+        /*!
+         * \brief reset @c true if a SETTING goes back to its default
+         */
+        bool reset;
+        /*!
+         * \brief line The line number in the source file
+         */
+        int line;
+        /*!
+         * \brief independent @c true if the COMMAND only checks the
+         * target (i.e. @c test) so it can overlap its neighbours
+         */
+        bool independent;
+    };
+
+    /*!
+     * \brief The ScriptSettings struct holds the cli-setting values in
+     * effect while a script plays
+     *
+     * @since test-cascades 1.1.5
+     */
+    struct ScriptSettings
+    {
+        /*!
+         * \brief ScriptSettings Create the default settings
+         *
+         * @since test-cascades 1.1.5
+         */
+        ScriptSettings();
+        /*!
+         * \brief apply Apply a SETTING instruction
+         *
+         * \param instruction The instruction
+         *
+         * @since test-cascades 1.1.5
+         */
+        void apply(const ScriptInstruction& instruction);
+        /*!
+         * \brief retry Retry failed commands
+         */
+        bool retry;
+        /*!
+         * \brief retryInterval The time between retries in ms
+         */
+        int retryInterval;
+        /*!
+         * \brief retryMaxIntervals The maximum number of retries
+         */
+        uint retryMaxIntervals;
+        /*!
+         * \brief failureOk Carry on after a failure
+         */
+        bool failureOk;
+        /*!
+         * \brief window The number of independent commands that
+         * can be waiting for a reply at once
+         */
+        int window;
+    };
+
+    /*!
+     * \brief The Script class is a compiled script with every call
+     * resolved into a single list of instructions
+     *
+     * @since test-cascades 1.1.5
+     */
+    class Script
+    {
+        public:
+            /*!
+             * \brief Script Create an empty script
+             *
+             * \param fileName The root file of the script
+             *
+             * @since test-cascades 1.1.5
+             */
+            explicit Script(const QString& fileName);
+            /*!
+             * \brief fileName The root file of the script
+             *
+             * \return The file name
+             *
+             * @since test-cascades 1.1.5
+             */
+            const QString& fileName() const
+            {
+                return this->name;
+            }
+            /*!
+             * \brief instructions The compiled instructions
+             *
+             * \return The instructions in the order they play
+             *
+             * @since test-cascades 1.1.5
+             */
+            const QList<ScriptInstruction>& instructions() const
+            {
+                return this->list;
+            }
+            /*!
+             * \brief commandsFrom Count the commands from an instruction
+             * to the end of the script
+             *
+             * \param index The first instruction to count from
+             *
+             * \return The number of commands
+             *
+             * @since test-cascades 1.1.5
+             */
+            int commandsFrom(const int index) const;
+        protected:
+        private:
+            friend class ScriptCompiler;
+            /*!
+             * \brief name The root file of the script
+             */
+            const QString name;
+            /*!
+             * \brief list The compiled instructions
+             */
+            QList<ScriptInstruction> list;
+    };
+
+    /*!
+     * \brief The ScriptCompiler class compiles script files into
+     * instruction lists before anything is sent to a target.
+     *
+     * Every file is read once and parsed once per content hash, so
+     * a file called from many scripts (or run on many targets) only
+     * costs the first time. Settings and commands are validated and
+     * calls are checked for recursion, so a broken script fails before
+     * a connection is made.
+     *
+     * @since test-cascades 1.1.5
+     */
+    class ScriptCompiler
+    {
+        public:
+            /*!
+             * \brief ScriptCompiler Create a compiler
+             *
+             * \param maxCallDepth The deepest nesting of calls allowed
+             *
+             * @since test-cascades 1.1.5
+             */
+            explicit ScriptCompiler(const int maxCallDepth = 100);
+            /*!
+             * \brief ~ScriptCompiler Destructor, frees the compiled scripts
+             *
+             * @since test-cascades 1.1.5
+             */
+            virtual ~ScriptCompiler();
+            /*!
+             * \brief compile Compile a script. The script is owned by the
+             * compiler and compiling the same file again returns it.
+             *
+             * \param fileName The script file
+             * \param error Set to the reason when compilation fails
+             *
+             * \return The compiled script or @c NULL on error
+             *
+             * @since test-cascades 1.1.5
+             */
+            const Script * compile(const QString& fileName, QString * const error);
+        protected:
+        private:
+            /*!
+             * \brief maxDepth The deepest nesting of calls allowed
+             */
+            const int maxDepth;
+            /*!
+             * \brief fileHashes The content hash of each file read, keyed
+             * by canonical path
+             */
+            QHash<QString, QByteArray> fileHashes;
+            /*!
+             * \brief parsedFiles The parsed (unresolved) instructions keyed
+             * by content hash
+             */
+            QHash<QByteArray, QList<ScriptInstruction> > parsedFiles;
+            /*!
+             * \brief scripts The compiled scripts keyed by canonical path
+             */
+            QHash<QString, Script*> scripts;
+            /*!
+             * \brief load Read and parse a file, using the caches
+             *
+             * \param path The canonical path of the file
+             * \param error Set to the reason on failure
+             *
+             * \return The parsed instructions or @c NULL on error
+             *
+             * @since test-cascades 1.1.5
+             */
+            const QList<ScriptInstruction> * load(const QString& path,
+                                                  QString * const error);
+            /*!
+             * \brief parse Parse the content of a single file
+             *
+             * \param content The file content
+             * \param path The file, for error messages
+             * \param instructions The list to fill in
+             * \param error Set to the reason on failure
+             *
+             * \return @c false if a line isn't valid
+             *
+             * @since test-cascades 1.1.5
+             */
+            static bool parse(const QByteArray& content,
+                              const QString& path,
+                              QList<ScriptInstruction> * const instructions,
+                              QString * const error);
+            /*!
+             * \brief parseSetting Parse a cli-setting line
+             *
+             * \param line The trimmed line
+             * \param instruction The instruction to fill in
+             *
+             * \return An error message or an empty string
+             *
+             * @since test-cascades 1.1.5
+             */
+            static QString parseSetting(const QString& line,
+                                        ScriptInstruction * const instruction);
+            /*!
+             * \brief flatten Append a file's instructions with every
+             * call replaced by the called file
+             *
+             * \param path The canonical path of the file
+             * \param rootDir The directory of the root script
+             * \param stack The files being flattened, to catch recursion
+             * \param out The list to append to
+             * \param error Set to the reason on failure
+             *
+             * \return @c false on error
+             *
+             * @since test-cascades 1.1.5
+             */
+            bool flatten(const QString& path,
+                         const QString& rootDir,
+                         QStringList * const stack,
+                         QList<ScriptInstruction> * const out,
+                         QString * const error);
+    };
+}  // namespace cli
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
+
+#endif  // SCRIPT_H_
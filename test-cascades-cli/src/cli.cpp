@@ -2,16 +2,16 @@
  * Copyright 2013 Truphone
  */
 #include "include/cli.h"
+#include "include/script.h"
+#include "include/results.h"
+#include "include/recorder.h"
 #include <QCoreApplication>
 #if defined(QT_DEBUG)
 #include <QDebug>
 #endif
 #include <string>
-#include <QFileInfo>
-#include <QDir>
 #include <QTimer>
 #include <QSemaphore>
-#include <QStack>
 #include <QTcpSocket>
 
 namespace truphone
@@ -22,6 +22,16 @@ namespace cascades
 {
 namespace cli
 {
+    /*!
+     * \brief UPLOAD_NAME The name scripts are uploaded to the target as
+     */
+    static const char * const UPLOAD_NAME = "cli";
+    /*!
+     * \brief MAX_UPLOAD_LINE The harness reads at most this many bytes
+     * of a line
+     */
+    static const int MAX_UPLOAD_LINE = 1024;
+
     /*!
      * \brief The HarnessCliPrviate class is used to store the internal
      * and private data for the CLI
@@ -33,13 +43,15 @@ namespace cli
          * \brief HarnessCliPrviate Create the internal data
          *
          * \param isRecord Is record mode on
-         * \param inFile The input file
-         * \param outFile The output file
+         * \param recordWriter The writer for the recording
+         * \param compiledScript The script to play
+         * \param resultsWriter The results writer
          * \param parent The parent object
          */
         HarnessCliPrviate(bool isRecord,
-                          QFile * const inFile,
-                          QFile * const outFile,
+                          RecordWriter * const recordWriter,
+                          const Script * const compiledScript,
+                          ResultsWriter * const resultsWriter,
                           QObject * const parent);
 
         /*!
@@ -50,39 +62,6 @@ namespace cli
          * \brief EVENT_NAMES The string names of all the events
          */
         static const char * EVENT_NAMES[];
-        /*!
-         * \brief SETTING_RETRY The name of the retry settings value
-         */
-        static const QString SETTING_RETRY;
-        /*!
-         * \brief SETTING_RETRY_DEFAULT Default setting for retries
-         */
-        static const QVariant SETTING_RETRY_DEFAULT;
-        /*!
-         * \brief SETTING_RETRY_INTERVAL Name of the retry internval setting
-         */
-        static const QString SETTING_RETRY_INTERVAL;
-        /*!
-         * \brief SETTING_RETRY_INTERVAL_DEFAULT Default value for interval
-         */
-        static const QVariant SETTING_RETRY_INTERVAL_DEFAULT;
-        /*!
-         * \brief SETTING_RETRY_MAX_TIME Name of the max retry time
-         */
-        static const QString SETTING_RETRY_MAX_INTERVALS;
-        /*!
-         * \brief SETTING_RETRY_MAX_TIME_DEFAULT Default max retry time
-         */
-        static const QVariant SETTING_RETRY_MAX_INTERVALS_DEFAULT;
-        /*!
-         * \brief SETTINGS_FAILURE_OK Should we accept failures for these tests
-         */
-        static const QString SETTING_FAILURE_OK;
-        /*!
-         * \brief SETTINGS_FAILURE_OK_DEFAULT The default value for failures being accepted
-         */
-        static const QVariant SETTING_FAILURE_OK_DEFAULT;
-
         /*!
          * The states the CLI can be in
          */
@@ -94,7 +73,8 @@ namespace cli
              */
             WAITING_FOR_SERVER,
             /*!
-             * Waiting for a replay to a playback command
+             * Waiting for the replies to the playback commands
+             * in flight
              */
             WAITING_FOR_REPLY,
             /*!
@@ -105,6 +85,22 @@ namespace cli
              * Waiting for an incoming recording command
              */
             WAITING_FOR_RECORDED_COMMAND,
+            /*!
+             * Waiting for the reply to reset before the next script
+             */
+            WAITING_FOR_RESET,
+            /*!
+             * Connected and waiting for the next script
+             */
+            IDLE,
+            /*!
+             * Waiting for the replies to the uploaded script lines
+             */
+            WAITING_FOR_UPLOAD,
+            /*!
+             * Waiting for the results of the script played on the target
+             */
+            WAITING_FOR_RUN,
             /*!
              * The disconnected state
              */
@@ -206,32 +202,58 @@ namespace cli
          */
         QTcpSocket * const stream;
         /*!
-         * \brief input_file Input data
+         * \brief recorder The writer for the recording
          */
-        QFile * const rootFile;
+        RecordWriter * const recorder;
         /*!
-         * \brief output_file Output data
+         * \brief results The results of the script
          */
-        QFile * const outputFile;
-
+        ResultsWriter * results;
         /*!
-         * \brief currentFile The current file we're reading from
+         * \brief script The compiled script being played
          */
-        QFile * currentFile;
-
+        const Script * script;
         /*!
-         * \brief inputFiles Stack of input files
+         * \brief nextInstruction The next instruction of @c script to play
          */
-        QStack<QFile*> * const inputFiles;
-
+        int nextInstruction;
         /*!
          * \brief settings Settings for configuring the CLI.
          */
-        QMap<QString, QVariant> * const settings;
+        ScriptSettings settings;
         /*!
-         * \brief lastCommandWritten A copy of the last command written out
+         * \brief The OutstandingCommand struct is a command sent to
+         * the target that hasn't had its final reply
          */
-        QString lastCommandWritten;
+        struct OutstandingCommand
+        {
+            /*!
+             * \brief text The command
+             */
+            QString text;
+            /*!
+             * \brief settings The settings when the command was sent
+             */
+            ScriptSettings settings;
+            /*!
+             * \brief independent @c true if sent ahead in the window
+             */
+            bool independent;
+            /*!
+             * \brief retries The number of retries sent
+             */
+            uint retries;
+            /*!
+             * \brief failed @c true if waiting to be retried
+             */
+            bool failed;
+        };
+        /*!
+         * \brief outstanding The commands in flight, oldest first,
+         * followed by the failed commands waiting to be retried. The
+         * target replies in order so a reply is for the first command.
+         */
+        QList<OutstandingCommand> outstanding;
         /*!
          * \brief retryTimer Timer for retries
          */
@@ -241,27 +263,43 @@ namespace cli
          */
         QTimer * const connectionTimer;
         /*!
-         * \brief retryCount The current number of retries
+         * \brief flushTimer Periodically flushes the recording
          */
-        uint retryCount;
+        QTimer * const flushTimer;
         /*!
          * \brief qOut The output stream for messages
          */
         QTextStream qOut;
-
         /*!
-         * \brief readNextLine Read the next line from the file.
-         * If there's no file, try the file stack
-         *
-         * \param callLevel The current recursive call level
-         * \param maxCallLevel The maximum recursive call level
-         *
-         * \return The number of bytes read
-         *
-         * @since test-cascades 1.0.7
+         * \brief label Prefix for the console output, empty unless
+         * several targets share the console
          */
-        QString readNextLine(const int callLevel = 0,
-                             const int maxCallLevel = 100);
+        QString label;
+        /*!
+         * \brief welcomed @c true once the target's welcome was received
+         */
+        bool welcomed;
+        /*!
+         * \brief keepAlive @c true to keep the connection between scripts
+         */
+        bool keepAlive;
+        /*!
+         * \brief onDevice @c true to upload the script and play it on the target
+         */
+        bool onDevice;
+        /*!
+         * \brief uploaded The instruction index of each uploaded line
+         */
+        QList<int> uploaded;
+        /*!
+         * \brief uploadReplies The replies to the upload still to come
+         */
+        int uploadReplies;
+        /*!
+         * \brief echoed The instructions shown on the console so far
+         * while the target plays the script
+         */
+        int echoed;
 
         /*!
          * \brief startRecording Send the recording command to the server
@@ -276,12 +314,74 @@ namespace cli
          */
         void waitForCommandToRecord();
         /*!
-         * \brief transmitNextCommand Reads the next command from the disk
-         * and transmits it
+         * \brief startScript Start playing the script, either here or
+         * by uploading it to the target
+         *
+         * @since test-cascades 1.1.5
+         */
+        void startScript();
+        /*!
+         * \brief uploadScript Send the script's commands and settings
+         * to the target
+         *
+         * @since test-cascades 1.1.5
+         */
+        void uploadScript();
+        /*!
+         * \brief runUploadedScript Ask the target to play the uploaded script
+         *
+         * @since test-cascades 1.1.5
+         */
+        void runUploadedScript();
+        /*!
+         * \brief runLineReceived Handle a line from the target while
+         * it plays the script
+         *
+         * \param line The trimmed line
+         *
+         * @since test-cascades 1.1.5
+         */
+        void runLineReceived(const QString& line);
+        /*!
+         * \brief echoUpTo Show the instructions up to and including
+         * @c index on the console, as they would be if played here
+         *
+         * \param index The instruction index
+         *
+         * @since test-cascades 1.1.5
+         */
+        void echoUpTo(const int index);
+        /*!
+         * \brief transmitNextCommand Plays the script up to the next
+         * command and transmits it. Independent commands keep being
+         * sent until the window is full. Once the commands in flight
+         * have replied any failed commands are retried instead.
          *
          * @since test-cascades 1.0.0
          */
         void transmitNextCommand();
+        /*!
+         * \brief retryFailedCommand Send the first failed command again
+         *
+         * @since test-cascades 1.1.5
+         */
+        void retryFailedCommand();
+        /*!
+         * \brief commandsInFlight Count the commands waiting for a reply
+         *
+         * \return The number of commands sent and not failed
+         *
+         * @since test-cascades 1.1.5
+         */
+        int commandsInFlight() const;
+        /*!
+         * \brief commandReplied Handle the reply to the oldest command
+         *
+         * \param reply The trimmed reply
+         *
+         * @since test-cascades 1.1.5
+         */
+        void commandReplied(const QString& reply);
         /*!
          * \brief unexpectedTransition Record an unexpected state machine transition
          *
@@ -296,6 +396,15 @@ namespace cli
          * @since test-cascades 1.0.0
          */
         void shutdown(const int exitCode = 0);
+        /*!
+         * \brief finishScript Finish the script, keeping the connection
+         * open for the next one if asked to and nothing is in flight
+         *
+         * \param exitCode @c EXIT_SUCCESS if the script passed
+         *
+         * @since test-cascades 1.1.5
+         */
+        void finishScript(const int exitCode);
         /*!
          * \brief postEventToStateMachine Post an event to the
          * classes state machine
@@ -305,25 +414,6 @@ namespace cli
          * @since test-cascades 1.0.0
          */
         void postEventToStateMachine(const event_t event);
-        /*!
-         * \brief processSetting Process a setting string from the script
-         *
-         * \param setting The setting string to process.
-         *
-         * @since test-cascades 1.0.9
-         */
-        void processSetting(const QString& setting);
-        /*!
-         * \brief getSetting Get a setting
-         *
-         * \param key The setting to lookup
-         * \param defaultValue The value to use if the setting value isn't known
-         *
-         * \return The value for the specified setting or the default value
-         *
-         * @since test-cascades 1.0.9
-         */
-        QVariant getSetting(const QString& key, const QVariant defaultValue);
         /*!
          * \brief disconnected Slot for disconnection
          *
@@ -345,21 +435,16 @@ namespace cli
         void retryTimeoutExpired(void);
     };
 
-    const QString HarnessCliPrviate::SETTING_RETRY("retry");
-    const QVariant HarnessCliPrviate::SETTING_RETRY_DEFAULT(0);
-    const QString HarnessCliPrviate::SETTING_RETRY_INTERVAL("retry-interval");
-    const QVariant HarnessCliPrviate::SETTING_RETRY_INTERVAL_DEFAULT(1000);
-    const QString HarnessCliPrviate::SETTING_RETRY_MAX_INTERVALS("retry-max-intervals");
-    const QVariant HarnessCliPrviate::SETTING_RETRY_MAX_INTERVALS_DEFAULT(30);
-    const QString HarnessCliPrviate::SETTING_FAILURE_OK("failure-ok");
-    const QVariant HarnessCliPrviate::SETTING_FAILURE_OK_DEFAULT(false);
-
     const char * HarnessCliPrviate::STATE_NAMES[] =
     {
         "Waiting for Server",
         "Waiting for Reply",
         "Waiting for Recording to start",
         "Waiting for a Recorded Command",
+        "Waiting for Reset",
+        "Idle",
+        "Waiting for Upload",
+        "Waiting for Run",
         "Disconnected"
     };
 
@@ -375,34 +460,52 @@ namespace cli
 
     HarnessCliPrviate::HarnessCliPrviate(
             bool isRecord,
-            QFile * const inFile,
-            QFile * const outFile,
+            RecordWriter * const recordWriter,
+            const Script * const compiledScript,
+            ResultsWriter * const resultsWriter,
             QObject * const parent)
         : QObject(parent),
           stateMachine(WAITING_FOR_SERVER),
           recordingMode(isRecord),
           stream(new QTcpSocket(this)),
-          rootFile(inFile),
-          outputFile(outFile),
-          currentFile(rootFile),
-          inputFiles(new QStack<QFile*>()),
-          settings(new QMap<QString, QVariant>()),
+          recorder(recordWriter),
+          results(resultsWriter),
+          script(compiledScript),
+          nextInstruction(0),
           retryTimer(new QTimer(this)),
           connectionTimer(new QTimer(this)),
-          retryCount(0),
-          qOut(stdout)
+          flushTimer(new QTimer(this)),
+          qOut(stdout),
+          welcomed(false),
+          keepAlive(false),
+          onDevice(false),
+          uploadReplies(0),
+          echoed(0)
+    {
+    }
+
+    HarnessCli::HarnessCli(QString host,
+                           quint16 port,
+                           const Script * const script,
+                           ResultsWriter * const results,
+                           QObject * parent)
+        : QObject(parent),
+          pData(new HarnessCliPrviate(false, NULL, script, results, this))
     {
-        inputFiles->push_back(rootFile);
+        this->initialise(host, port);
     }
 
     HarnessCli::HarnessCli(QString host,
                            quint16 port,
-                           bool isRecord,
-                           QFile * const inFile,
-                           QFile * const outFile,
+                           RecordWriter * const recorder,
                            QObject * parent)
         : QObject(parent),
-          pData(new HarnessCliPrviate(isRecord, inFile, outFile, this))
+          pData(new HarnessCliPrviate(true, recorder, NULL, NULL, this))
+    {
+        this->initialise(host, port);
+    }
+
+    void HarnessCli::initialise(const QString& host, const quint16 port)
     {
         bool failed = (this->pData->stream == NULL);
 
@@ -423,6 +526,11 @@ namespace cli
                     this,
                     SLOT(dataReady()));
 
+        failed |= not connect(
+                    this->pData->stream,
+                    SIGNAL(error(QAbstractSocket::SocketError)),
+                    SLOT(socketError(QAbstractSocket::SocketError)));
+
         failed |= not connect(
                     this->pData->connectionTimer,
                     SIGNAL(timeout()),
@@ -432,18 +540,23 @@ namespace cli
                     pData->retryTimer,
                     SIGNAL(timeout()),
                     SLOT(retryTimeoutExpired()));
+
+        failed |= not connect(
+                    this->pData->flushTimer,
+                    SIGNAL(timeout()),
+                    SLOT(flushRecording()));
         if (not failed)
         {
+            if (this->pData->recordingMode)
+            {
+                // rather than writing every recorded line straight away
+                this->pData->flushTimer->setInterval(1000);
+                this->pData->flushTimer->start();
+            }
             this->pData->connectionTimer->setInterval(30 * 1000);
             this->pData->connectionTimer->setSingleShot(true);
             this->pData->connectionTimer->start();
             this->pData->stream->connectToHost(host, port);
-            if (not this->pData->recordingMode)
-            {
-                this->pData->outputFile->write(
-                            "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\r\n");
-                this->pData->outputFile->write("<results>\r\n");
-            }
         }
         else
         {
@@ -460,43 +573,6 @@ namespace cli
                 this->pData->stream->close();
             }
         }
-        if (this->pData->inputFiles)
-        {
-            delete this->pData->inputFiles;
-        }
-        if (this->pData->settings)
-        {
-            delete this->pData->settings;
-        }
-    }
-
-    QString HarnessCliPrviate::readNextLine(const int callLevel,
-                                            const int maxCallLevel)
-    {
-        QString line;
-        if (callLevel < maxCallLevel)
-        {
-            line = QString(this->currentFile->readLine(1024));
-            if (line.isNull() || line.isEmpty())
-            {
-                if (not this->inputFiles->isEmpty())
-                {
-                    QFile * const oldFile = this->inputFiles->pop();
-                    Q_UNUSED(oldFile);
-                    if (not this->inputFiles->isEmpty())
-                    {
-                        currentFile = this->inputFiles->back();
-                        qOut << "IO Now reading from: " << currentFile->fileName() << "\r\n";
-                        line = readNextLine(callLevel + 1, maxCallLevel);
-                    }
-                }
-            }
-        }
-        else
-        {
-            line = QString();
-        }
-        return line;
     }
 
     void HarnessCliPrviate::postEventToStateMachine(const event_t event)
@@ -522,7 +598,7 @@ namespace cli
                 }
                 else
                 {
-                    this->transmitNextCommand();
+                    this->startScript();
                 }
                 break;
             case ERROR:
@@ -544,13 +620,50 @@ namespace cli
                 this->transmitNextCommand();
                 break;
             case NO_MORE_COMMANDS_TO_PLAY:
-                this->shutdown(EXIT_SUCCESS);
+                this->finishScript(EXIT_SUCCESS);
                 break;
             case ERROR:
+                this->finishScript(EXIT_FAILURE);
+                break;
+            case DISCONNECT:
+                this->results->commandTerminated();
+                this->shutdown(EXIT_FAILURE);
+                break;
+            default:
+                this->unexpectedTransition(event);
+                break;
+            }
+            break;
+
+        case WAITING_FOR_RESET:
+            switch (event)
+            {
+            case RECEIVED_COMMAND_REPLY:
+                this->startScript();
+                break;
+            case ERROR:
+                this->shutdown(EXIT_FAILURE);
+                break;
+            case DISCONNECT:
+                this->shutdown(EXIT_FAILURE);
+                break;
+            default:
+                this->unexpectedTransition(event);
+                break;
+            }
+            break;
+
+        case WAITING_FOR_UPLOAD:
+            switch (event)
+            {
+            case RECEIVED_COMMAND_REPLY:
+                this->runUploadedScript();
+                break;
+            case ERROR:
+                // later upload replies would be taken for the next script's
                 this->shutdown(EXIT_FAILURE);
                 break;
             case DISCONNECT:
-                this->outputFile->write("\t\t<fail terminated=\"true\"/>\r\n");
                 this->shutdown(EXIT_FAILURE);
                 break;
             default:
@@ -559,6 +672,38 @@ namespace cli
             }
             break;
 
+        case WAITING_FOR_RUN:
+            switch (event)
+            {
+            case NO_MORE_COMMANDS_TO_PLAY:
+                this->finishScript(EXIT_SUCCESS);
+                break;
+            case ERROR:
+                this->finishScript(EXIT_FAILURE);
+                break;
+            case DISCONNECT:
+                this->results->commandTerminated();
+                this->shutdown(EXIT_FAILURE);
+                break;
+            default:
+                this->unexpectedTransition(event);
+                break;
+            }
+            break;
+
+        case IDLE:
+            switch (event)
+            {
+            case DISCONNECT:
+                // nothing is playing so there's no one to tell
+                this->stateMachine.setState(DISCONNECTED);
+                break;
+            default:
+                this->unexpectedTransition(event);
+                break;
+            }
+            break;
+
         case WAITING_FOR_RECORDING_START:
             switch (event)
             {
@@ -600,7 +745,7 @@ namespace cli
 
     void HarnessCliPrviate::unexpectedTransition(const event_t event)
     {
-        qOut << "Unexpected state transition, State: "  \
+        qOut << this->label << "Unexpected state transition, State: "  \
              << STATE_NAMES[this->stateMachine.state()] \
              << ", event " \
              << EVENT_NAMES[event]
@@ -610,23 +755,23 @@ namespace cli
 
     void HarnessCliPrviate::shutdown(const int exitCode)
     {
+        if (this->stateMachine.state() == DISCONNECTED)
+        {
+            return;
+        }
         this->stateMachine.setState(DISCONNECTED);
-        if (this->rootFile)
+        this->connectionTimer->stop();
+        this->retryTimer->stop();
+        this->flushTimer->stop();
+        if (this->recordingMode)
         {
-            if (not this->recordingMode)
-            {
-                const qint64 bytesAvailable = this->rootFile->bytesAvailable();
-                if (bytesAvailable > 0)
-                {
-                    this->outputFile->write("\t<command>\r\n");
-                    this->outputFile->write("\t\t<request terminated=\"true\"/>\r\n");
-                    this->outputFile->write("\t\t<fail terminated=\"true\" bytesLeftInFile=\"");
-                    this->outputFile->write(QString::number(bytesAvailable).toUtf8().constData());
-                    this->outputFile->write("\"/>\r\n");
-                    this->outputFile->write("\t</command>\r\n");
-                }
-                this->outputFile->write("</results>\r\n");
-            }
+            this->recorder->flush();
+            qOut.flush();
+        }
+        if (not this->recordingMode and this->results)
+        {
+            this->results->finish(this->script->commandsFrom(this->nextInstruction));
+            this->results = NULL;
         }
         if (this->stream)
         {
@@ -635,7 +780,33 @@ namespace cli
                 this->stream->close();
             }
         }
-        QCoreApplication::exit(exitCode);
+        HarnessCli * const cli = qobject_cast<HarnessCli*>(this->parent());
+        if (cli)
+        {
+            emit cli->finished(exitCode);
+        }
+    }
+
+    void HarnessCliPrviate::finishScript(const int exitCode)
+    {
+        if (not this->keepAlive
+                or not this->outstanding.isEmpty()
+                or this->stream->state() not_eq QAbstractSocket::ConnectedState)
+        {
+            // late replies would be taken for the next script's
+            this->shutdown(exitCode);
+            return;
+        }
+        this->retryTimer->stop();
+        this->results->finish(this->script->commandsFrom(this->nextInstruction));
+        this->results = NULL;
+        this->script = NULL;
+        this->stateMachine.setState(IDLE);
+        HarnessCli * const cli = qobject_cast<HarnessCli*>(this->parent());
+        if (cli)
+        {
+            emit cli->finished(exitCode);
+        }
     }
 
     void HarnessCliPrviate::startRecording()
@@ -649,83 +820,298 @@ namespace cli
         this->stateMachine.setState(WAITING_FOR_RECORDED_COMMAND);
     }
 
-    void HarnessCliPrviate::transmitNextCommand()
+    void HarnessCliPrviate::startScript()
     {
-        this->stateMachine.setState(WAITING_FOR_REPLY);
+        if (this->onDevice)
+        {
+            this->uploadScript();
+        }
+        else
+        {
+            this->transmitNextCommand();
+        }
+    }
+
+    void HarnessCliPrviate::uploadScript()
+    {
+        this->stateMachine.setState(WAITING_FOR_UPLOAD);
+        this->uploaded.clear();
+        this->echoed = 0;
+
+        // calls were resolved by the compiler so one script is enough
+        QByteArray upload = QByteArray("run clear ") + UPLOAD_NAME + "\r\n";
+        const QList<ScriptInstruction>& instructions = this->script->instructions();
+        for (int i = 0 ; i < instructions.size() ; i++)
+        {
+            const ScriptInstruction& instruction = instructions.at(i);
+            if (instruction.type not_eq ScriptInstruction::COMMAND
+                    and instruction.type not_eq ScriptInstruction::SETTING)
+            {
+                continue;
+            }
+            const QByteArray line = QByteArray("run add ") + UPLOAD_NAME + " "
+                    + instruction.text.toUtf8() + "\r\n";
+            if (line.size() > MAX_UPLOAD_LINE)
+            {
+                qOut << this->label << "'" << instruction.text
+                     << "' is too long to upload\n";
+                qOut.flush();
+                this->postEventToStateMachine(ERROR);
+                return;
+            }
+            upload += line;
+            this->uploaded.append(i);
+        }
+        this->uploadReplies = this->uploaded.size() + 1;
+        this->stream->write(upload);
+        qOut << this->label << "<< run add " << UPLOAD_NAME << " ("
+             << this->uploaded.size() << " lines)\n";
+        qOut.flush();
+    }
+
+    void HarnessCliPrviate::runUploadedScript()
+    {
+        this->stateMachine.setState(WAITING_FOR_RUN);
+        this->stream->write(QByteArray("run ") + UPLOAD_NAME + "\r\n");
+        qOut << this->label << "<< run " << UPLOAD_NAME << "\n";
+        qOut.flush();
+    }
+
+    void HarnessCliPrviate::echoUpTo(const int index)
+    {
+        const QList<ScriptInstruction>& instructions = this->script->instructions();
+        while (this->echoed < instructions.size() and this->echoed <= index)
+        {
+            const ScriptInstruction& instruction = instructions.at(this->echoed);
+            switch (instruction.type)
+            {
+            case ScriptInstruction::COMMENT:
+                qOut << this->label << "CC " << instruction.text << "\n";
+                break;
+            case ScriptInstruction::BLANK:
+                qOut << "\n";
+                break;
+            case ScriptInstruction::ENTER_FILE:
+            case ScriptInstruction::LEAVE_FILE:
+                qOut << this->label << "IO Now reading from: " << instruction.text << "\r\n";
+                break;
+            case ScriptInstruction::COMMAND:
+                qOut << this->label << "<< " << instruction.text << "\n";
+                break;
+            default:
+                break;
+            }
+            this->echoed++;
+        }
+    }
 
-        if (this->retryCount)
+    void HarnessCliPrviate::runLineReceived(const QString& line)
+    {
+        const QList<ScriptInstruction>& instructions = this->script->instructions();
+        if (line.startsWith("RUN "))
         {
-            this->stream->write(this->lastCommandWritten.toUtf8());
-            this->outputFile->write("\t<retry count=\"");
-            this->outputFile->write(QString::number(this->retryCount).toUtf8().constData());
-            this->outputFile->write("\" command=\"");
-            qOut << "RT " << this->lastCommandWritten << "\n";
+            const QString id = line.section(' ', 1, 1);
+            const QString kind = line.section(' ', 2, 2);
+            bool ok = false;
+            const int uploadedLine = id.section(':', 1).toInt(&ok);
+            if (id.section(':', 0, 0) not_eq UPLOAD_NAME
+                    or not ok
+                    or uploadedLine < 1
+                    or uploadedLine > this->uploaded.size())
+            {
+                // i.e. from a script the target called on its own
+                return;
+            }
+            const int index = this->uploaded.at(uploadedLine - 1);
+            const QString& command = instructions.at(index).text;
+            this->echoUpTo(index);
+            if (kind == "RETRY")
+            {
+                // RUN <id> RETRY <retry> <attemptUs> <reply>
+                const QString reply = line.section(' ', 5);
+                qOut << this->label << ">> " << reply << "\n";
+                qOut << this->label << "RT " << command << "\n";
+                this->results->remoteAttempt(command,
+                                             line.section(' ', 4, 4).toLongLong(),
+                                             reply);
+            }
+            else if (kind == "DONE")
+            {
+                // RUN <id> DONE <retries> <attemptUs> <durationUs> <verdict> <reply>
+                const QString verdict = line.section(' ', 6, 6);
+                const QString reply = line.section(' ', 7);
+                qOut << this->label << ">> " << reply << "\n";
+                this->results->remoteReplied(command,
+                                             line.section(' ', 4, 4).toLongLong(),
+                                             line.section(' ', 5, 5).toLongLong(),
+                                             reply,
+                                             verdict == "pass",
+                                             verdict == "accepted");
+                this->nextInstruction = index + 1;
+            }
             qOut.flush();
-            this->outputFile->write(this->lastCommandWritten.toUtf8());
-            this->outputFile->write("\"/>\r\n");
+        }
+        else if (line.startsWith("OK"))
+        {
+            this->echoUpTo(instructions.size());
+            qOut.flush();
+            this->nextInstruction = instructions.size();
+            this->postEventToStateMachine(NO_MORE_COMMANDS_TO_PLAY);
         }
         else
         {
-            bool waitingForReply = false;
-            QString nextLine = this->readNextLine();
-            while (not nextLine.isNull() && not nextLine.isEmpty())
+            qOut << this->label << ">> " << line << "\n";
+            qOut.flush();
+            this->postEventToStateMachine(ERROR);
+        }
+    }
+
+    int HarnessCliPrviate::commandsInFlight() const
+    {
+        int inFlight = 0;
+        foreach (const OutstandingCommand& command, this->outstanding)
+        {
+            if (not command.failed)
             {
-                if (nextLine.startsWith('#'))
-                {
-                    qOut << "CC " << nextLine.trimmed() << "\n";
-                    qOut.flush();
-                }
-                else if (nextLine.startsWith("call "))
-                {
-                    QString filename = nextLine.mid(5).trimmed();
-                    QFile * const newFile = new QFile(filename, this);
-                    if (not newFile->open(QIODevice::ReadOnly))
-                    {
-                        const QFileInfo info(*this->rootFile);
-                        newFile->setFileName(
-                                    info.path() +
-                                    QDir::separator() +
-                                    newFile->fileName());
-                        if (not newFile->open(QIODevice::ReadOnly))
-                        {
-                            this->postEventToStateMachine(NO_MORE_COMMANDS_TO_PLAY);
-                        }
-                    }
-                    this->inputFiles->push_back(newFile);
-                    this->currentFile = newFile;
-                    qOut << "IO Now reading from: " << this->currentFile->fileName() << "\r\n";
-                }
-                else if (nextLine.startsWith("cli-setting "))
-                {
-                    processSetting(nextLine);
-                }
-                else if (nextLine.trimmed().isEmpty())
-                {
-                    qOut << "\n";
-                    qOut.flush();
-                }
-                else
+                inFlight++;
+            }
+        }
+        return inFlight;
+    }
+
+    void HarnessCliPrviate::transmitNextCommand()
+    {
+        this->stateMachine.setState(WAITING_FOR_REPLY);
+
+        const int inFlight = this->commandsInFlight();
+        if (inFlight < this->outstanding.size())
+        {
+            // drain the window before retrying what failed
+            if (inFlight == 0 and not this->retryTimer->isActive())
+            {
+                this->retryTimer->setInterval(
+                            this->outstanding.first().settings.retryInterval);
+                this->retryTimer->setSingleShot(true);
+                this->retryTimer->start();
+            }
+            return;
+        }
+
+        const QList<ScriptInstruction>& instructions = this->script->instructions();
+        while (this->nextInstruction < instructions.size())
+        {
+            const ScriptInstruction& instruction = instructions.at(this->nextInstruction);
+            if (instruction.type == ScriptInstruction::COMMAND
+                    and not this->outstanding.isEmpty())
+            {
+                // only independent commands share the window, with
+                // each other
+                const bool sendAhead = instruction.independent
+                        and this->settings.window > 1
+                        and this->outstanding.last().independent
+                        and this->outstanding.size() < this->settings.window;
+                if (not sendAhead)
                 {
-                    this->lastCommandWritten = nextLine;
-                    this->stream->write(nextLine.toUtf8());
-                    this->outputFile->write("\t<command request sent=\"");
-                    qOut << "<< " << nextLine.trimmed() << "\n";
-                    qOut.flush();
-                    this->outputFile->write(nextLine.trimmed().toUtf8());
-                    this->outputFile->write("\"/>\r\n");
-                    waitingForReply = true;
-                    break;
+                    return;
                 }
-                if (not waitingForReply)
+            }
+            this->nextInstruction++;
+            switch (instruction.type)
+            {
+            case ScriptInstruction::COMMENT:
+                qOut << this->label << "CC " << instruction.text << "\n";
+                qOut.flush();
+                break;
+            case ScriptInstruction::BLANK:
+                qOut << "\n";
+                qOut.flush();
+                break;
+            case ScriptInstruction::SETTING:
+                this->settings.apply(instruction);
+                break;
+            case ScriptInstruction::ENTER_FILE:
+            case ScriptInstruction::LEAVE_FILE:
+                qOut << this->label << "IO Now reading from: " << instruction.text << "\r\n";
+                break;
+            case ScriptInstruction::COMMAND:
+            {
+                OutstandingCommand command;
+                command.text = instruction.text;
+                command.settings = this->settings;
+                command.independent = instruction.independent and this->settings.window > 1;
+                command.retries = 0;
+                command.failed = false;
+                this->outstanding.append(command);
+                this->stream->write((instruction.text + "\r\n").toUtf8());
+                this->results->commandSent(instruction.text);
+                qOut << this->label << "<< " << instruction.text << "\n";
+                qOut.flush();
+                if (not command.independent)
                 {
-                    nextLine = this->readNextLine();
+                    return;
                 }
+                break;
+            }
+            case ScriptInstruction::CALL:
+                // resolved by the compiler
+                break;
             }
-            if (not waitingForReply)
+        }
+        if (this->outstanding.isEmpty())
+        {
+            this->postEventToStateMachine(NO_MORE_COMMANDS_TO_PLAY);
+        }
+    }
+
+    void HarnessCliPrviate::retryFailedCommand()
+    {
+        if (this->outstanding.isEmpty() or not this->outstanding.first().failed)
+        {
+            return;
+        }
+        OutstandingCommand& command = this->outstanding.first();
+        command.failed = false;
+        this->stream->write((command.text + "\r\n").toUtf8());
+        this->results->retrySent(command.retries);
+        qOut << this->label << "RT " << command.text << "\n";
+        qOut.flush();
+    }
+
+    void HarnessCliPrviate::commandReplied(const QString& reply)
+    {
+        if (this->outstanding.isEmpty() or this->outstanding.first().failed)
+        {
+            qOut << this->label << "Unexpected reply, no command is waiting for one\n";
+            qOut.flush();
+            return;
+        }
+
+        OutstandingCommand command = this->outstanding.takeFirst();
+        if (reply.startsWith("OK"))
+        {
+            // thats fine
+            this->results->commandReplied(reply, true, false);
+        }
+        else if (command.settings.retry
+                 and command.retries < command.settings.retryMaxIntervals)
+        {
+            // retried once the commands in flight have replied
+            this->results->attemptFailed(reply);
+            command.retries++;
+            command.failed = true;
+            this->outstanding.append(command);
+        }
+        else
+        {
+            const bool acceptFailure = command.settings.failureOk;
+            this->results->commandReplied(reply, false, acceptFailure);
+            if (not acceptFailure)
             {
-                this->postEventToStateMachine(NO_MORE_COMMANDS_TO_PLAY);
+                this->postEventToStateMachine(ERROR);
+                return;
             }
         }
+        this->postEventToStateMachine(RECEIVED_COMMAND_REPLY);
     }
 
     void HarnessCli::disconnected(void)
@@ -743,45 +1129,87 @@ namespace cli
         this->postEventToStateMachine(HarnessCliPrviate::DISCONNECT);
     }
 
-    void HarnessCliPrviate::processSetting(const QString& setting)
+    void HarnessCli::flushRecording(void)
     {
-        const QStringList tokens(setting.trimmed().split(" "));
-        if (tokens.size() == 3
-                and tokens.at(0) == "cli-setting")
-        {
-#if defined(QT_DEBUG)
-            qDebug() << "# CLI Setting set: " << tokens.at(1) << "=" << tokens.at(2);
-#endif  // QT_DEBUG
-            this->settings->insert(tokens.at(1), tokens.at(2));
-        }
-        else if (tokens.size() == 2 and tokens.at(0) == "cli-setting")
+        this->pData->recorder->flush();
+        this->pData->qOut.flush();
+    }
+
+    void HarnessCli::retryTimeoutExpired(void)
+    {
+        this->pData->retryTimeoutExpired();
+    }
+
+    void HarnessCli::connectionTimeout(void)
+    {
+        this->pData->qOut << this->pData->label
+                          << "Failed to connect to the host\n";
+        this->pData->qOut.flush();
+        this->pData->postEventToStateMachine(HarnessCliPrviate::ERROR);
+        this->pData->stream->abort();
+    }
+
+    void HarnessCli::socketError(QAbstractSocket::SocketError error)
+    {
+        Q_UNUSED(error);
+        // errors after the welcome are reported via the disconnection
+        if (this->pData->stateMachine.state() == HarnessCliPrviate::WAITING_FOR_SERVER)
         {
-#if defined(QT_DEBUG)
-            qDebug() << "# CLI Setting delete: " << tokens.at(1) << "=" << tokens.at(2);
-#endif  // QT_DEBUG
-            this->settings->remove(tokens.at(1));
+            this->pData->connectionTimer->stop();
+            this->pData->qOut << this->pData->label
+                              << "Failed to connect to the host: "
+                              << this->pData->stream->errorString() << "\n";
+            this->pData->qOut.flush();
+            this->pData->postEventToStateMachine(HarnessCliPrviate::ERROR);
         }
     }
 
-    QVariant HarnessCliPrviate::getSetting(const QString& key,
-                                    const QVariant defaultValue)
+    bool HarnessCli::receivedWelcome() const
     {
-        return this->settings->value(key, defaultValue);
+        return this->pData->welcomed;
     }
 
-    void HarnessCli::retryTimeoutExpired(void)
+    void HarnessCli::setKeepAlive(const bool keepAlive)
     {
-        this->pData->retryTimeoutExpired();
+        this->pData->keepAlive = keepAlive;
     }
 
-    void HarnessCli::connectionTimeout(void)
+    void HarnessCli::setOnDevice(const bool onDevice)
+    {
+        this->pData->onDevice = onDevice;
+    }
+
+    bool HarnessCli::isIdle() const
     {
-        qFatal("Failed to connect to the host");
+        return this->pData->stateMachine.state() == HarnessCliPrviate::IDLE;
+    }
+
+    void HarnessCli::play(const Script * const script, ResultsWriter * const results)
+    {
+        if (not this->isIdle())
+        {
+            qWarning("Can't play a script until the last one has finished");
+            return;
+        }
+        this->pData->script = script;
+        this->pData->results = results;
+        this->pData->nextInstruction = 0;
+        this->pData->settings = ScriptSettings();
+        this->pData->stateMachine.setState(HarnessCliPrviate::WAITING_FOR_RESET);
+        // restore the application before the script starts
+        this->pData->stream->write("reset\r\n");
+        this->pData->qOut << this->pData->label << "<< reset\n";
+        this->pData->qOut.flush();
+    }
+
+    void HarnessCli::setLabel(const QString& label)
+    {
+        this->pData->label = label.isEmpty() ? QString() : "[" + label + "] ";
     }
 
     void HarnessCliPrviate::retryTimeoutExpired(void)
     {
-        this->transmitNextCommand();
+        this->retryFailedCommand();
     }
 
     void HarnessCli::dataReady(void)
@@ -793,7 +1221,10 @@ namespace cli
     {
         if (this->stream)
         {
-            while (this->stream->bytesAvailable())
+            // replies are handled a whole line at a time, a line split over
+            // tcp segments waits for the rest; recordings are passed on as-is
+            while (this->recordingMode ? this->stream->bytesAvailable() > 0
+                                       : this->stream->canReadLine())
             {
                 QString data = this->stream->readLine(1024);
                 // don't strip the new lines from a recording buffer
@@ -804,16 +1235,38 @@ namespace cli
                 {
                     data = data.trimmed();
                 }
-                qOut << ">> " <<  data << "\n";
-                qOut.flush();
+                // the target playing the script is shown as if played here
+                const bool onDeviceReply =
+                        this->stateMachine.state() == WAITING_FOR_UPLOAD
+                        or this->stateMachine.state() == WAITING_FOR_RUN;
+                if (not onDeviceReply)
+                {
+                    qOut << this->label << ">> " <<  data << "\n";
+                }
+                if (not this->recordingMode)
+                {
+                    qOut.flush();
+                }
+                // i.e. streamed samples and traces, they're never replies
+                // whatever state we're in
+                if (not this->recordingMode
+                        and this->stateMachine.state() not_eq WAITING_FOR_SERVER
+                        and data.startsWith('#'))
+                {
+                    if (onDeviceReply)
+                    {
+                        qOut << this->label << ">> " <<  data << "\n";
+                        qOut.flush();
+                    }
+                    continue;
+                }
                 switch (this->stateMachine.state())
                 {
                 case WAITING_FOR_SERVER:
+                    this->welcomed = true;
                     if (not this->recordingMode)
                     {
-                        this->outputFile->write("\t<welcome message=\"");
-                        this->outputFile->write(data.toUtf8());
-                        this->outputFile->write("\"/>\r\n");
+                        this->results->welcome(data);
                     }
                     this->postEventToStateMachine(RECEIVED_INITIAL_MESSAGE);
                     break;
@@ -822,69 +1275,45 @@ namespace cli
                     this->postEventToStateMachine(RECEIVED_COMMAND_REPLY);
                     break;
 
-                case WAITING_FOR_REPLY:
-                {
-                    const bool ok = data.startsWith("OK");
-                    bool confirmedFailed = true;
-                    if (ok)
+                case WAITING_FOR_RESET:
+                    if (data.startsWith("OK"))
                     {
-                        // thats fine
-                        this->outputFile->write("\t<pass recv=\"");
-                        this->outputFile->write(data.toUtf8());
-                        this->outputFile->write("\"/>\r\n");
+                        this->postEventToStateMachine(RECEIVED_COMMAND_REPLY);
                     }
                     else
                     {
-                        if (this->getSetting(SETTING_RETRY,
-                                             SETTING_RETRY_DEFAULT).toInt()
-                                and
-                                this->retryCount < this->getSetting(
-                                        SETTING_RETRY_MAX_INTERVALS,
-                                        SETTING_RETRY_MAX_INTERVALS_DEFAULT).toUInt())
-                        {
-                            this->retryTimer->setInterval(
-                                        this->getSetting(
-                                            SETTING_RETRY_INTERVAL,
-                                            SETTING_RETRY_INTERVAL_DEFAULT).toInt());
-                            this->retryTimer->setSingleShot(true);
-                            this->retryTimer->start();
-                            this->retryCount++;
-                            confirmedFailed = false;
-                        }
-                        if (confirmedFailed)
-                        {
-                            this->outputFile->write("\t<fail recv=\"");
-                            this->outputFile->write(data.toUtf8());
-                            this->outputFile->write("\"/>\r\n");
-                        }
+                        qOut << this->label << "The target couldn't be reset\n";
+                        qOut.flush();
+                        this->postEventToStateMachine(ERROR);
                     }
+                    break;
 
-                    if (ok or confirmedFailed)
+                case WAITING_FOR_REPLY:
+                    this->commandReplied(data);
+                    break;
+                case WAITING_FOR_UPLOAD:
+                    if (data.startsWith("OK"))
                     {
-                        this->retryCount = 0;
-                        const bool acceptFailure = getSetting(
-                                    SETTING_FAILURE_OK,
-                                    SETTING_FAILURE_OK_DEFAULT).toBool();
-                        if (ok or acceptFailure)
+                        this->uploadReplies--;
+                        if (this->uploadReplies == 0)
                         {
-                            if (not recordingMode and acceptFailure)
-                            {
-                                this->outputFile->write("<warning reason=\"accepted-failure\"/>"\
-                                                        "\r\n");
-                            }
-
                             this->postEventToStateMachine(RECEIVED_COMMAND_REPLY);
                         }
-                        else
-                        {
-                            this->postEventToStateMachine(ERROR);
-                        }
+                    }
+                    else
+                    {
+                        qOut << this->label << ">> " << data << "\n";
+                        qOut << this->label << "The script couldn't be uploaded\n";
+                        qOut.flush();
+                        this->postEventToStateMachine(ERROR);
                     }
                     break;
-                }
+                case WAITING_FOR_RUN:
+                    this->runLineReceived(data);
+                    break;
                 case WAITING_FOR_RECORDED_COMMAND:
-                    this->currentFile->write(data.toUtf8());
-                    this->currentFile->flush();
+                    // written out by the flush timer
+                    this->recorder->write(data.toUtf8());
 
                     this->postEventToStateMachine(RECEIVED_RECORD_COMMAND);
                     break;
@@ -0,0 +1,99 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#include "include/histogram.h"
+
+#include <QtGlobal>
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+namespace cli
+{
+    LatencyHistogram::LatencyHistogram()
+        : total(0),
+          maximum(0)
+    {
+    }
+
+    int LatencyHistogram::bucketFor(const quint64 value)
+    {
+        if (value < 2 * SUB_BUCKETS)
+        {
+            return static_cast<int>(value);
+        }
+        int msb = 0;
+        for (quint64 v = value ; v > 1 ; v >>= 1)
+        {
+            msb++;
+        }
+        // shift the value so it lands in [SUB_BUCKETS, 2 * SUB_BUCKETS)
+        const int shift = msb - 5;
+        const int sub = static_cast<int>(value >> shift) - SUB_BUCKETS;
+        return 2 * SUB_BUCKETS + (shift - 1) * SUB_BUCKETS + sub;
+    }
+
+    quint64 LatencyHistogram::highestValueIn(const int bucket)
+    {
+        if (bucket < 2 * SUB_BUCKETS)
+        {
+            return bucket;
+        }
+        const int shift = (bucket - 2 * SUB_BUCKETS) / SUB_BUCKETS + 1;
+        const quint64 sub = (bucket - 2 * SUB_BUCKETS) % SUB_BUCKETS + SUB_BUCKETS;
+        return ((sub + 1) << shift) - 1;
+    }
+
+    void LatencyHistogram::record(const qint64 us)
+    {
+        const quint64 value = us > 0 ? us : 0;
+        const int bucket = bucketFor(value);
+        if (bucket >= this->buckets.size())
+        {
+            this->buckets.resize(bucket + 1);
+        }
+        this->buckets[bucket]++;
+        this->total++;
+        this->maximum = qMax(this->maximum, static_cast<qint64>(value));
+    }
+
+    void LatencyHistogram::merge(const LatencyHistogram& other)
+    {
+        if (other.buckets.size() > this->buckets.size())
+        {
+            this->buckets.resize(other.buckets.size());
+        }
+        for (int i = 0 ; i < other.buckets.size() ; i++)
+        {
+            this->buckets[i] += other.buckets.at(i);
+        }
+        this->total += other.total;
+        this->maximum = qMax(this->maximum, other.maximum);
+    }
+
+    qint64 LatencyHistogram::percentile(const double percent) const
+    {
+        if (this->total == 0)
+        {
+            return 0;
+        }
+        quint64 wanted = static_cast<quint64>(this->total * percent / 100.0 + 0.5);
+        wanted = qBound(static_cast<quint64>(1), wanted, this->total);
+        quint64 seen = 0;
+        for (int i = 0 ; i < this->buckets.size() ; i++)
+        {
+            seen += this->buckets.at(i);
+            if (seen >= wanted)
+            {
+                return qMin(static_cast<qint64>(highestValueIn(i)), this->maximum);
+            }
+        }
+        return this->maximum;
+    }
+}  // namespace cli
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
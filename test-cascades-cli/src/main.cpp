@@ -2,100 +2,194 @@
  * Copyright 2013 Truphone
  */
 #include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QStringList>
+#include <QTimer>
 #include "include/cli.h"
+#include "include/runner.h"
+
+using truphone::test::cascades::cli::Device;
+using truphone::test::cascades::cli::HarnessRunner;
 
 int main(int argc, char *argv[])
 {
     bool isRecord = false;
+    QList<Device> devices;
+    QStringList scripts;
+    QString summaryFile;
+    QString durationsFile;
+    QString shardDir;
+    // the example scripts are .txt files
+    QString shardPattern = "*.txt";
+    bool sharded = false;
+    bool reuse = false;
+    bool onDevice = false;
+    bool compressRecording = false;
+    qint64 recordSegmentSize = 0;
 
     QCoreApplication a(argc, argv);
+    QStringList args = a.arguments();
+    args.removeFirst();
 
-    if (argc < 4)
-    {
-        qWarning("test-cascades-cli <host> <port> <test-file> --record");
-        qWarning("----------------------------------------------------");
-        qWarning("test-cascades-cli is the command line interface to the target");
-        qWarning("You need to specify the host & port to connect to and a test file");
-        qWarning("Optionally you can append '--record' in which case the script will");
-        qWarning("be over-written with the events that occur & are transmitted from");
-        qWarning("the application.");
-        return -1;
-    }
-
-    if (argc >= 5)
+    if (not args.isEmpty() and args.first().startsWith("--"))
     {
-        isRecord = (strncmp("--record", argv[4], 8) == 0);
-    }
-
-    QFile testFile(argv[3], &a);
-    QFile outputFile(QString(argv[3]) + ".xml", &a);
-    QFile * pOutputFile = NULL;
-    if (not isRecord)
-    {
-        if (not testFile.exists())
+        while (not args.isEmpty() and args.first().startsWith("--"))
         {
-            qFatal("Test file doesn't exist");
-            return -2;
+            const QString option = args.takeFirst();
+            if (option == "--reuse")
+            {
+                reuse = true;
+                continue;
+            }
+            if (option == "--on-device")
+            {
+                onDevice = true;
+                continue;
+            }
+            if (args.isEmpty())
+            {
+                qWarning("%s needs a value", qPrintable(option));
+                return -1;
+            }
+            const QString value = args.takeFirst();
+            if (option == "--devices")
+            {
+                if (not HarnessRunner::parseDevices(value, &devices))
+                {
+                    return -8;
+                }
+            }
+            else if (option == "--summary")
+            {
+                summaryFile = value;
+            }
+            else if (option == "--shard")
+            {
+                if (not QDir(value).exists())
+                {
+                    qWarning("Script directory %s doesn't exist", qPrintable(value));
+                    return -2;
+                }
+                shardDir = value;
+                sharded = true;
+            }
+            else if (option == "--pattern")
+            {
+                shardPattern = value;
+            }
+            else if (option == "--durations")
+            {
+                durationsFile = value;
+            }
+            else
+            {
+                qWarning("Unknown option %s", qPrintable(option));
+                return -1;
+            }
         }
-
-        testFile.open(QIODevice::ReadOnly);
-        if (not testFile.isOpen())
+        if (sharded)
         {
-            qFatal("Test file can't be opened");
-            return -3;
+            // the durations file may match the pattern and be in the directory
+            const QString durationsPath = QFileInfo(durationsFile).absoluteFilePath();
+            foreach (const QFileInfo& info,
+                     QDir(shardDir).entryInfoList(QStringList(shardPattern),
+                                                  QDir::Files bitor QDir::Readable,
+                                                  QDir::Name))
+            {
+                if (durationsFile.isEmpty() or info.absoluteFilePath() not_eq durationsPath)
+                {
+                    scripts.append(info.filePath());
+                }
+            }
         }
-        if (not testFile.isReadable())
+        scripts.append(args);
+        if ((devices.size() > 1 or scripts.size() > 1) and summaryFile.isEmpty())
         {
-            qFatal("Test file isn't readable");
-            return -4;
-        }
-
-        pOutputFile = &outputFile;
-        if (outputFile.exists())
-        {
-            outputFile.remove();
-        }
-        outputFile.open(QIODevice::WriteOnly bitor QIODevice::Text);
-        if (not outputFile.isOpen())
-        {
-            qFatal("Failed to open the output file");
-            return -5;
-        }
-
-        if (not outputFile.isWritable())
-        {
-            qFatal("Output file isn't writable");
-            return -6;
+            summaryFile = "summary.xml";
         }
     }
-    else
+    else if (args.size() >= 3)
     {
-        if (testFile.exists())
+        Device device;
+        device.host = args.at(0);
+        device.port = args.at(1).toUShort();
+        devices.append(device);
+        scripts.append(args.at(2));
+        if (args.size() >= 4)
         {
-            qWarning("Test file already exists and will be over-written");
+            isRecord = args.at(3).startsWith("--record");
+            onDevice = (args.at(3) == "--on-device");
         }
-
-        testFile.open(QIODevice::WriteOnly bitor QIODevice::Text);
-        if (not testFile.isOpen())
+        for (int i = 4 ; isRecord and i < args.size() ; i++)
         {
-            qFatal("Failed to open the script file for recording");
-            return -7;
+            if (args.at(i) == "--gzip")
+            {
+                compressRecording = true;
+            }
+            else if (args.at(i) == "--segment" and i + 1 < args.size())
+            {
+                bool ok = false;
+                recordSegmentSize = args.at(++i).toLongLong(&ok) * 1024 * 1024;
+                if (not ok or recordSegmentSize <= 0)
+                {
+                    qWarning("--segment needs a size in MB");
+                    return -1;
+                }
+            }
+            else
+            {
+                qWarning("Unknown record option %s", qPrintable(args.at(i)));
+                return -1;
+            }
         }
+    }
 
-        if (not testFile.isWritable())
-        {
-            qFatal("Recording script file isn't writable");
-            return -6;
-        }
+    if (devices.isEmpty() or scripts.isEmpty())
+    {
+        qWarning("test-cascades-cli <host> <port> <test-file> --record [--gzip] [--segment <MB>]");
+        qWarning("test-cascades-cli --devices <host:port,...|file> [--summary <file>]");
+        qWarning("                  <test-file> [<test-file>...]");
+        qWarning("test-cascades-cli --devices <host:port,...|file> --shard <script-dir>");
+        qWarning("                  [--pattern <glob>] [--durations <file>] [--summary <file>]");
+        qWarning("add --reuse to play all the scripts for a device over one connection");
+        qWarning("add --on-device (also after <test-file>) to have the device play the scripts");
+        qWarning("----------------------------------------------------");
+        qWarning("test-cascades-cli is the command line interface to the target");
+        qWarning("You need to specify the host & port to connect to and a test file");
+        qWarning("Optionally you can append '--record' in which case the script will");
+        qWarning("be over-written with the events that occur & are transmitted from");
+        qWarning("the application. The recording can be gzipped and split into");
+        qWarning("<test-file>, <test-file>.2, ... of at most --segment MB each,");
+        qWarning("counted before compression.");
+        qWarning("With --devices the scripts are run on every device at the same time,");
+        qWarning("the results go to <test-file>.<host>-<port>.xml and a summary of");
+        qWarning("all the runs is written to summary.xml (or the --summary file).");
+        qWarning("With --shard every script in the directory matching --pattern");
+        qWarning("(*.txt by default, never the durations file) runs once on whichever");
+        qWarning("device is free, longest first using the durations file, which is");
+        qWarning("updated with the new durations at the end.");
+        qWarning("With --reuse each device keeps its connection between scripts and");
+        qWarning("the application is sent 'reset' before each script after the first.");
+        qWarning("With --on-device each script is uploaded and played by the device");
+        qWarning("so there's no network round trip between commands.");
+        return -1;
     }
 
-    new truphone::test::cascades::cli::HarnessCli(
-            argv[1],
-            QString(argv[2]).toUShort(),
-            isRecord,
-            &testFile,
-            pOutputFile,
-            &a);
+    HarnessRunner * const runner = new HarnessRunner(devices,
+                                                     scripts,
+                                                     isRecord,
+                                                     summaryFile,
+                                                     &a);
+    if (sharded)
+    {
+        runner->setSharded(shardDir, durationsFile);
+    }
+    runner->setReuseConnections(reuse);
+    runner->setOnDevice(onDevice);
+    runner->setRecordOptions(compressRecording, recordSegmentSize);
+    // start from the event loop so an early exit isn't lost
+    QTimer::singleShot(0, runner, SLOT(start()));
 
     return a.exec();
 }
@@ -0,0 +1,165 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#include "include/recorder.h"
+
+#include <QFile>
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+namespace cli
+{
+    const int RecordWriter::FLUSH_SIZE = 64 * 1024;
+
+    RecordWriter::RecordWriter(const QString& fileName,
+                               const bool compress,
+                               const qint64 segmentSize)
+        : baseName(fileName),
+          gzip(compress),
+          maxSegment(segmentSize),
+          file(NULL),
+          segment(0),
+          segmentBytes(0),
+          atLineStart(true)
+    {
+        this->buffer.reserve(FLUSH_SIZE);
+    }
+
+    RecordWriter::~RecordWriter()
+    {
+        this->close();
+    }
+
+    bool RecordWriter::open(void)
+    {
+        return this->openSegment();
+    }
+
+    bool RecordWriter::openSegment(void)
+    {
+        this->segment++;
+        const QString name = (this->segment == 1) ?
+                    this->baseName : this->baseName + "." + QString::number(this->segment);
+        this->file = new QFile(name);
+        if (not this->file->open(QIODevice::WriteOnly bitor QIODevice::Truncate))
+        {
+            qWarning("Failed to open the recording file %s", qPrintable(name));
+            delete this->file;
+            this->file = NULL;
+            return false;
+        }
+        if (this->gzip)
+        {
+            this->stream.zalloc = Z_NULL;
+            this->stream.zfree = Z_NULL;
+            this->stream.opaque = Z_NULL;
+            // 16 + the window bits asks for a gzip header
+            if (deflateInit2(&this->stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                             16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY) not_eq Z_OK)
+            {
+                qWarning("Failed to start compressing %s", qPrintable(name));
+                this->file->close();
+                delete this->file;
+                this->file = NULL;
+                return false;
+            }
+        }
+        this->segmentBytes = 0;
+        return true;
+    }
+
+    void RecordWriter::closeSegment(void)
+    {
+        if (not this->file)
+        {
+            return;
+        }
+        this->writeBuffer(Z_FINISH);
+        if (this->gzip)
+        {
+            deflateEnd(&this->stream);
+        }
+        this->file->close();
+        delete this->file;
+        this->file = NULL;
+    }
+
+    void RecordWriter::write(const QByteArray& data)
+    {
+        if (not this->file)
+        {
+            return;
+        }
+        if (this->maxSegment > 0
+                and this->atLineStart
+                and this->segmentBytes > 0
+                and this->segmentBytes + data.size() > this->maxSegment)
+        {
+            this->closeSegment();
+            if (not this->openSegment())
+            {
+                return;
+            }
+        }
+        this->buffer += data;
+        this->segmentBytes += data.size();
+        this->atLineStart = data.endsWith('\n');
+        if (this->buffer.size() >= FLUSH_SIZE)
+        {
+            this->writeBuffer(Z_NO_FLUSH);
+        }
+    }
+
+    void RecordWriter::flush(void)
+    {
+        if (this->file)
+        {
+            // a sync flush leaves a readable (if unfinished) gzip file
+            this->writeBuffer(Z_SYNC_FLUSH);
+            this->file->flush();
+        }
+    }
+
+    void RecordWriter::close(void)
+    {
+        this->closeSegment();
+    }
+
+    void RecordWriter::writeBuffer(const int mode)
+    {
+        if (not this->gzip)
+        {
+            if (not this->buffer.isEmpty())
+            {
+                this->file->write(this->buffer);
+                this->buffer.clear();
+            }
+            return;
+        }
+        if (this->buffer.isEmpty() and mode == Z_NO_FLUSH)
+        {
+            return;
+        }
+
+        char out[16 * 1024];
+        this->stream.next_in = reinterpret_cast<Bytef*>(this->buffer.data());
+        this->stream.avail_in = this->buffer.size();
+        int result = Z_OK;
+        do
+        {
+            this->stream.next_out = reinterpret_cast<Bytef*>(out);
+            this->stream.avail_out = sizeof(out);
+            result = deflate(&this->stream, mode);
+            this->file->write(out, sizeof(out) - this->stream.avail_out);
+        }
+        while (this->stream.avail_out == 0 and result not_eq Z_STREAM_ERROR);
+        this->buffer.clear();
+    }
+}  // namespace cli
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
@@ -0,0 +1,344 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#include "include/results.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QIODevice>
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+namespace cli
+{
+    const int ResultsWriter::FLUSH_SIZE = 64 * 1024;
+
+    ResultsWriter::ResultsWriter(QIODevice * const out,
+                                 const QString& junit,
+                                 const QString& suite)
+        : output(out),
+          junitFile(junit),
+          suiteName(suite),
+          startedMs(QDateTime::currentMSecsSinceEpoch()),
+          tests(0),
+          failures(0),
+          finished(false)
+    {
+        this->clock.start();
+        this->buffer.reserve(FLUSH_SIZE);
+        this->append("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\r\n");
+        this->append("<results started=\""
+                     + QByteArray::number(this->startedMs) + "\">\r\n");
+    }
+
+    ResultsWriter::~ResultsWriter()
+    {
+        this->flush();
+    }
+
+    QString ResultsWriter::escape(const QString& value)
+    {
+        QString escaped;
+        escaped.reserve(value.size() + 16);
+        for (int i = 0 ; i < value.size() ; i++)
+        {
+            const QChar c = value.at(i);
+            switch (c.unicode())
+            {
+            case '&':
+                escaped += "&amp;";
+                break;
+            case '<':
+                escaped += "&lt;";
+                break;
+            case '>':
+                escaped += "&gt;";
+                break;
+            case '"':
+                escaped += "&quot;";
+                break;
+            case '\r':
+                escaped += "&#13;";
+                break;
+            case '\n':
+                escaped += "&#10;";
+                break;
+            case '\t':
+                escaped += "&#9;";
+                break;
+            default:
+                // other control characters aren't allowed in XML 1.0
+                if (c.unicode() >= 0x20)
+                {
+                    escaped += c;
+                }
+                break;
+            }
+        }
+        return escaped;
+    }
+
+    qint64 ResultsWriter::nowMs(void) const
+    {
+        return this->startedMs + this->clock.elapsed();
+    }
+
+    void ResultsWriter::welcome(const QString& message)
+    {
+        this->append("\t<welcome message=\"" + escape(message).toUtf8()
+                     + "\" recvMs=\"" + QByteArray::number(this->nowMs())
+                     + "\"/>\r\n");
+    }
+
+    void ResultsWriter::commandSent(const QString& sent)
+    {
+        PendingCommand pendingCommand;
+        pendingCommand.command = sent;
+        pendingCommand.sentNs = this->clock.nsecsElapsed();
+        pendingCommand.attemptNs = pendingCommand.sentNs;
+        pendingCommand.retries = 0;
+        this->pending.append(pendingCommand);
+    }
+
+    void ResultsWriter::recordLatency(void)
+    {
+        const PendingCommand& oldest = this->pending.first();
+        const qint64 us = (this->clock.nsecsElapsed() - oldest.attemptNs) / 1000;
+        const QString verb = oldest.command.section(' ', 0, 0);
+        this->verbLatencies[verb].record(us);
+    }
+
+    void ResultsWriter::attemptFailed(const QString& reply)
+    {
+        if (this->pending.isEmpty())
+        {
+            return;
+        }
+        this->recordLatency();
+        PendingCommand oldest = this->pending.takeFirst();
+        oldest.children += "\t\t<retry count=\"" + QByteArray::number(oldest.retries + 1)
+                + "\" recv=\"" + escape(reply).toUtf8()
+                + "\" recvMs=\"" + QByteArray::number(this->nowMs())
+                + "\"/>\r\n";
+        // replies to the commands already sent come first
+        this->pending.append(oldest);
+    }
+
+    void ResultsWriter::retrySent(const uint count)
+    {
+        if (this->pending.isEmpty())
+        {
+            return;
+        }
+        PendingCommand& oldest = this->pending.first();
+        oldest.retries = count;
+        oldest.attemptNs = this->clock.nsecsElapsed();
+    }
+
+    void ResultsWriter::commandReplied(const QString& reply,
+                                       const bool passed,
+                                       const bool acceptedFailure)
+    {
+        if (this->pending.isEmpty())
+        {
+            return;
+        }
+        this->recordLatency();
+        this->closeReplied(reply, passed, acceptedFailure);
+    }
+
+    void ResultsWriter::closeReplied(const QString& reply,
+                                     const bool passed,
+                                     const bool acceptedFailure)
+    {
+        QByteArray result = "\t\t<" + QByteArray(passed ? "pass" : "fail")
+                + " recv=\"" + escape(reply).toUtf8() + "\"/>\r\n";
+        if (acceptedFailure)
+        {
+            result += "\t\t<warning reason=\"accepted-failure\"/>\r\n";
+        }
+        this->closeCommand(result, passed or acceptedFailure, reply);
+    }
+
+    ResultsWriter::PendingCommand& ResultsWriter::remoteCommand(const QString& command,
+                                                                const qint64 attemptUs)
+    {
+        if (this->pending.isEmpty())
+        {
+            PendingCommand ran;
+            ran.command = command;
+            ran.sentNs = this->clock.nsecsElapsed() - attemptUs * 1000;
+            ran.attemptNs = ran.sentNs;
+            ran.retries = 0;
+            this->pending.append(ran);
+        }
+        this->verbLatencies[command.section(' ', 0, 0)].record(attemptUs);
+        return this->pending.first();
+    }
+
+    void ResultsWriter::remoteAttempt(const QString& command,
+                                      const qint64 attemptUs,
+                                      const QString& reply)
+    {
+        PendingCommand& ran = this->remoteCommand(command, attemptUs);
+        ran.retries++;
+        ran.children += "\t\t<retry count=\"" + QByteArray::number(ran.retries)
+                + "\" recv=\"" + escape(reply).toUtf8()
+                + "\" recvMs=\"" + QByteArray::number(this->nowMs())
+                + "\"/>\r\n";
+    }
+
+    void ResultsWriter::remoteReplied(const QString& command,
+                                      const qint64 attemptUs,
+                                      const qint64 durationUs,
+                                      const QString& reply,
+                                      const bool passed,
+                                      const bool acceptedFailure)
+    {
+        PendingCommand& ran = this->remoteCommand(command, attemptUs);
+        ran.sentNs = this->clock.nsecsElapsed() - durationUs * 1000;
+        this->closeReplied(reply, passed, acceptedFailure);
+    }
+
+    void ResultsWriter::commandTerminated(void)
+    {
+        while (not this->pending.isEmpty())
+        {
+            this->closeCommand("\t\t<fail terminated=\"true\"/>\r\n",
+                               false,
+                               "Terminated before the reply");
+        }
+    }
+
+    void ResultsWriter::closeCommand(const QByteArray& result,
+                                     const bool passed,
+                                     const QString& message)
+    {
+        const PendingCommand oldest = this->pending.takeFirst();
+        const qint64 durationUs = (this->clock.nsecsElapsed() - oldest.sentNs) / 1000;
+        const qint64 sentMs = this->startedMs + oldest.sentNs / 1000000;
+        const QByteArray request = escape(oldest.command).toUtf8();
+        this->append("\t<command request=\"" + request
+                     + "\" sentMs=\"" + QByteArray::number(sentMs)
+                     + "\" recvMs=\"" + QByteArray::number(this->nowMs())
+                     + "\" durationUs=\"" + QByteArray::number(durationUs)
+                     + "\" retries=\"" + QByteArray::number(oldest.retries)
+                     + "\">\r\n");
+        this->append(oldest.children);
+        this->append(result);
+        this->append("\t</command>\r\n");
+
+        this->tests++;
+        this->junitCases += "\t<testcase classname=\"" + escape(this->suiteName).toUtf8()
+                + "\" name=\"" + QByteArray::number(this->tests) + ": " + request
+                + "\" time=\"" + QByteArray::number(durationUs / 1000000.0, 'f', 6)
+                + "\"";
+        if (passed)
+        {
+            this->junitCases += "/>\r\n";
+        }
+        else
+        {
+            this->failures++;
+            this->junitCases += ">\r\n\t\t<failure message=\""
+                    + escape(message).toUtf8() + "\"/>\r\n\t</testcase>\r\n";
+        }
+    }
+
+    void ResultsWriter::finish(const int commandsLeft)
+    {
+        if (this->finished)
+        {
+            return;
+        }
+        this->finished = true;
+        this->commandTerminated();
+        if (commandsLeft > 0)
+        {
+            this->append("\t<command>\r\n");
+            this->append("\t\t<request terminated=\"true\"/>\r\n");
+            this->append("\t\t<fail terminated=\"true\" commandsLeft=\""
+                         + QByteArray::number(commandsLeft) + "\"/>\r\n");
+            this->append("\t</command>\r\n");
+            this->failures++;
+            this->tests++;
+            this->junitCases += "\t<testcase classname=\"" + escape(this->suiteName).toUtf8()
+                    + "\" name=\"" + QByteArray::number(commandsLeft)
+                    + " commands not run\" time=\"0\">\r\n\t\t<failure message=\"Terminated\"/>"
+                      "\r\n\t</testcase>\r\n";
+        }
+        this->append(latencyXml(this->verbLatencies));
+        this->append("</results>\r\n");
+        this->flush();
+        this->writeJUnit();
+    }
+
+    QByteArray ResultsWriter::latencyXml(const QMap<QString, LatencyHistogram>& latencies)
+    {
+        QByteArray xml;
+        QMap<QString, LatencyHistogram>::const_iterator it = latencies.constBegin();
+        for ( ; it not_eq latencies.constEnd() ; ++it)
+        {
+            const LatencyHistogram& histogram = it.value();
+            xml += "\t<latency verb=\"" + escape(it.key()).toUtf8()
+                    + "\" count=\"" + QByteArray::number(histogram.count())
+                    + "\" p50Us=\"" + QByteArray::number(histogram.percentile(50))
+                    + "\" p90Us=\"" + QByteArray::number(histogram.percentile(90))
+                    + "\" p99Us=\"" + QByteArray::number(histogram.percentile(99))
+                    + "\" maxUs=\"" + QByteArray::number(histogram.max())
+                    + "\"/>\r\n";
+        }
+        return xml;
+    }
+
+    void ResultsWriter::append(const QByteArray& data)
+    {
+        this->buffer += data;
+        if (this->buffer.size() >= FLUSH_SIZE)
+        {
+            this->flush();
+        }
+    }
+
+    void ResultsWriter::flush(void)
+    {
+        if (not this->buffer.isEmpty())
+        {
+            this->output->write(this->buffer);
+            this->buffer.clear();
+        }
+    }
+
+    void ResultsWriter::writeJUnit(void)
+    {
+        if (this->junitFile.isEmpty())
+        {
+            return;
+        }
+        QFile file(this->junitFile);
+        if (not file.open(QIODevice::WriteOnly bitor QIODevice::Text))
+        {
+            qWarning("Failed to open the JUnit file %s", qPrintable(this->junitFile));
+            return;
+        }
+        file.write("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\r\n");
+        file.write("<testsuite name=\"" + escape(this->suiteName).toUtf8()
+                   + "\" tests=\"" + QByteArray::number(this->tests)
+                   + "\" failures=\"" + QByteArray::number(this->failures)
+                   + "\" errors=\"0\" time=\""
+                   + QByteArray::number(this->clock.elapsed() / 1000.0, 'f', 3)
+                   + "\" timestamp=\""
+                   + QDateTime::fromMSecsSinceEpoch(this->startedMs)
+                        .toUTC().toString(Qt::ISODate).toUtf8()
+                   + "\">\r\n");
+        file.write(this->junitCases);
+        file.write("</testsuite>\r\n");
+    }
+}  // namespace cli
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
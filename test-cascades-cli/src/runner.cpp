@@ -0,0 +1,666 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#include "include/runner.h"
+#include "include/cli.h"
+#include "include/script.h"
+#include "include/results.h"
+#include "include/recorder.h"
+
+#include <QCoreApplication>
+#include <QtAlgorithms>
+#include <QFile>
+#include <QFileInfo>
+#include <QPair>
+#include <QTextStream>
+#include <cstdlib>
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+namespace cli
+{
+    HarnessRunner::HarnessRunner(const QList<Device>& targets,
+                                 const QStringList& scriptList,
+                                 const bool isRecord,
+                                 const QString& summary,
+                                 QObject * parent)
+        : QObject(parent),
+          devices(targets),
+          scripts(scriptList),
+          recordMode(isRecord),
+          summaryFile(summary),
+          compiler(new ScriptCompiler()),
+          sharded(false),
+          reuse(false),
+          onDevice(false),
+          compressRecordings(false),
+          recordSegmentSize(0)
+    {
+        for (int i = 0 ; i < this->devices.size() ; i++)
+        {
+            this->queues.append(QQueue<QString>());
+            this->healthy.append(true);
+        }
+    }
+
+    HarnessRunner::~HarnessRunner()
+    {
+        for (int i = 0 ; i < this->runs.size() ; i++)
+        {
+            this->closeFiles(&this->runs[i]);
+        }
+        delete this->compiler;
+    }
+
+    bool HarnessRunner::parseDevices(const QString& list,
+                                     QList<Device> * const devices)
+    {
+        QStringList entries;
+        QFile file(list);
+        if (file.exists() and file.open(QIODevice::ReadOnly bitor QIODevice::Text))
+        {
+            while (not file.atEnd())
+            {
+                const QString line = QString(file.readLine()).trimmed();
+                if (not line.isEmpty() and not line.startsWith('#'))
+                {
+                    entries.append(line);
+                }
+            }
+        }
+        else
+        {
+            entries = list.split(',', QString::SkipEmptyParts);
+        }
+
+        bool ok = not entries.isEmpty();
+        foreach (const QString& entry, entries)
+        {
+            const int colon = entry.lastIndexOf(':');
+            bool portOk = false;
+            Device device;
+            device.host = entry.left(colon).trimmed();
+            device.port = entry.mid(colon + 1).trimmed().toUShort(&portOk);
+            if (colon > 0 and portOk)
+            {
+                devices->append(device);
+            }
+            else
+            {
+                qWarning("Device '%s' isn't host:port", qPrintable(entry));
+                ok = false;
+            }
+        }
+        return ok;
+    }
+
+    QString HarnessRunner::resultsFileName(const QString& script,
+                                           const Device& device,
+                                           const bool multiDevice)
+    {
+        if (multiDevice)
+        {
+            return script + "." + device.host + "-"
+                    + QString::number(device.port) + ".xml";
+        }
+        return script + ".xml";
+    }
+
+    void HarnessRunner::setSharded(const QString& scriptDir, const QString& file)
+    {
+        this->sharded = true;
+        this->shardDir = QDir(scriptDir);
+        this->durationsFile = file;
+        this->durations.clear();
+
+        QFile input(file);
+        if (file.isEmpty()
+                or not input.open(QIODevice::ReadOnly bitor QIODevice::Text))
+        {
+            return;
+        }
+        while (not input.atEnd())
+        {
+            const QString line = QString::fromUtf8(input.readLine()).trimmed();
+            const int space = line.indexOf(' ');
+            bool ok = false;
+            const qint64 duration = line.left(space).toLongLong(&ok);
+            if (space > 0 and ok and not line.startsWith('#'))
+            {
+                this->durations.insert(line.mid(space + 1).trimmed(), duration);
+            }
+        }
+    }
+
+    void HarnessRunner::setReuseConnections(const bool reuseConnections)
+    {
+        this->reuse = reuseConnections;
+    }
+
+    void HarnessRunner::setOnDevice(const bool playOnDevice)
+    {
+        this->onDevice = playOnDevice;
+    }
+
+    void HarnessRunner::setRecordOptions(const bool compress, const qint64 segmentSize)
+    {
+        this->compressRecordings = compress;
+        this->recordSegmentSize = segmentSize;
+    }
+
+    void HarnessRunner::start(void)
+    {
+        this->clock.start();
+        if (not this->recordMode)
+        {
+            // a broken script fails the run before any target is touched
+            bool compiled = true;
+            foreach (const QString& script, this->scripts)
+            {
+                QString error;
+                if (not this->compiler->compile(script, &error))
+                {
+                    qWarning("%s", qPrintable(error));
+                    compiled = false;
+                }
+            }
+            if (not compiled)
+            {
+                QCoreApplication::exit(EXIT_FAILURE);
+                return;
+            }
+        }
+        if (this->sharded)
+        {
+            // longest processing time first: hand the longest scripts out
+            // first, each to the target with the least work queued
+            QList<QPair<qint64, QString> > order;
+            foreach (const QString& script, this->scripts)
+            {
+                order.append(qMakePair(this->expectedDuration(script), script));
+            }
+            qSort(order.begin(), order.end(), qGreater<QPair<qint64, QString> >());
+            for (int i = 0 ; i < order.size() ; i++)
+            {
+                this->enqueueSharded(order.at(i).second);
+            }
+        }
+        else
+        {
+            for (int i = 0 ; i < this->devices.size() ; i++)
+            {
+                foreach (const QString& script, this->scripts)
+                {
+                    this->queues[i].enqueue(script);
+                }
+            }
+        }
+        for (int i = 0 ; i < this->devices.size() ; i++)
+        {
+            this->startNextRun(i);
+        }
+        this->finishIfIdle();
+    }
+
+    qint64 HarnessRunner::expectedDuration(const QString& script) const
+    {
+        const QString name = this->durationKey(script);
+        if (this->durations.contains(name))
+        {
+            return this->durations.value(name);
+        }
+        qint64 longest = 0;
+        foreach (const qint64 duration, this->durations)
+        {
+            longest = qMax(longest, duration);
+        }
+        return longest;
+    }
+
+    QString HarnessRunner::durationKey(const QString& script) const
+    {
+        return this->shardDir.relativeFilePath(script);
+    }
+
+    qint64 HarnessRunner::queuedLoad(const int device) const
+    {
+        qint64 load = 0;
+        foreach (const QString& script, this->queues.at(device))
+        {
+            load += this->expectedDuration(script);
+        }
+        return load;
+    }
+
+    bool HarnessRunner::isBusy(const int device) const
+    {
+        foreach (const int runIndex, this->active)
+        {
+            if (this->runs.at(runIndex).device == device)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool HarnessRunner::enqueueSharded(const QString& script)
+    {
+        int target = -1;
+        qint64 targetLoad = 0;
+        for (int i = 0 ; i < this->devices.size() ; i++)
+        {
+            if (this->healthy.at(i))
+            {
+                const qint64 load = this->queuedLoad(i);
+                if (target < 0 or load < targetLoad)
+                {
+                    target = i;
+                    targetLoad = load;
+                }
+            }
+        }
+        if (target < 0)
+        {
+            return false;
+        }
+        QQueue<QString>& queue = this->queues[target];
+        const qint64 duration = this->expectedDuration(script);
+        int position = 0;
+        while (position < queue.size()
+               and this->expectedDuration(queue.at(position)) >= duration)
+        {
+            position++;
+        }
+        queue.insert(position, script);
+        return true;
+    }
+
+    bool HarnessRunner::steal(const int device)
+    {
+        int victim = -1;
+        qint64 victimLoad = 0;
+        for (int i = 0 ; i < this->devices.size() ; i++)
+        {
+            if (i not_eq device and not this->queues.at(i).isEmpty())
+            {
+                const qint64 load = this->queuedLoad(i);
+                if (victim < 0 or load > victimLoad)
+                {
+                    victim = i;
+                    victimLoad = load;
+                }
+            }
+        }
+        if (victim < 0)
+        {
+            return false;
+        }
+        // the owner works from the head (longest), steal from the tail
+        this->queues[device].enqueue(this->queues[victim].takeLast());
+        return true;
+    }
+
+    void HarnessRunner::removeDevice(const int device)
+    {
+        const Device& target = this->devices.at(device);
+        qWarning("%s:%d failed its health check and was removed from the pool",
+                 qPrintable(target.host), target.port);
+        this->healthy[device] = false;
+        QQueue<QString> orphans = this->queues.at(device);
+        this->queues[device].clear();
+        foreach (const QString& script, orphans)
+        {
+            if (not this->enqueueSharded(script))
+            {
+                // nothing left to run it on
+                Run run;
+                run.device = device;
+                run.script = script;
+                run.results = QString();
+                run.exitCode = EXIT_FAILURE;
+                run.durationMs = 0;
+                run.requeued = false;
+                run.recorder = NULL;
+                run.outputFile = NULL;
+                run.writer = NULL;
+                this->runs.append(run);
+            }
+        }
+        for (int i = 0 ; i < this->devices.size() ; i++)
+        {
+            if (this->healthy.at(i) and not this->isBusy(i))
+            {
+                this->startNextRun(i);
+            }
+        }
+    }
+
+    bool HarnessRunner::startNextRun(const int device)
+    {
+        if (not this->healthy.at(device))
+        {
+            return false;
+        }
+        QQueue<QString>& queue = this->queues[device];
+        while (not queue.isEmpty() or (this->sharded and this->steal(device)))
+        {
+            Run run;
+            run.device = device;
+            run.script = queue.dequeue();
+            run.results = resultsFileName(run.script,
+                                          this->devices.at(device),
+                                          this->devices.size() > 1
+                                            and not this->sharded);
+            run.exitCode = EXIT_FAILURE;
+            run.durationMs = 0;
+            run.requeued = false;
+            run.recorder = NULL;
+            run.outputFile = NULL;
+            run.writer = NULL;
+            run.timer.start();
+
+            if (not this->openFiles(&run))
+            {
+                this->closeFiles(&run);
+                this->runs.append(run);
+                continue;
+            }
+
+            const Device& target = this->devices.at(device);
+            HarnessCli * cli = this->idle.take(device);
+            if (cli and cli->isIdle())
+            {
+                QString error;
+                cli->play(this->compiler->compile(run.script, &error), run.writer);
+            }
+            else
+            {
+                if (cli)
+                {
+                    // the target went away between scripts
+                    cli->deleteLater();
+                }
+                if (this->recordMode)
+                {
+                    cli = new HarnessCli(target.host, target.port, run.recorder, this);
+                }
+                else
+                {
+                    QString error;
+                    cli = new HarnessCli(target.host,
+                                         target.port,
+                                         this->compiler->compile(run.script, &error),
+                                         run.writer,
+                                         this);
+                    cli->setKeepAlive(this->reuse);
+                    cli->setOnDevice(this->onDevice);
+                }
+                if (this->devices.size() > 1)
+                {
+                    cli->setLabel(target.host + ":" + QString::number(target.port));
+                }
+                connect(cli, SIGNAL(finished(int)), SLOT(cliFinished(int)));
+            }
+            this->active.insert(cli, this->runs.size());
+            this->runs.append(run);
+            return true;
+        }
+        return false;
+    }
+
+    bool HarnessRunner::openFiles(Run * const run)
+    {
+        if (this->recordMode)
+        {
+            if (QFile::exists(run->script))
+            {
+                qWarning("Test file already exists and will be over-written");
+            }
+            run->recorder = new RecordWriter(run->script,
+                                             this->compressRecordings,
+                                             this->recordSegmentSize);
+            if (not run->recorder->open())
+            {
+                qWarning("Failed to open the script file %s for recording",
+                         qPrintable(run->script));
+                return false;
+            }
+            return true;
+        }
+
+        run->outputFile = new QFile(run->results, this);
+        if (run->outputFile->exists())
+        {
+            run->outputFile->remove();
+        }
+        if (not run->outputFile->open(QIODevice::WriteOnly bitor QIODevice::Text)
+                or not run->outputFile->isWritable())
+        {
+            qWarning("Failed to open the output file %s", qPrintable(run->results));
+            return false;
+        }
+        QString suite = QFileInfo(run->script).fileName();
+        if (this->devices.size() > 1 and not this->sharded)
+        {
+            const Device& device = this->devices.at(run->device);
+            suite += " on " + device.host + ":" + QString::number(device.port);
+        }
+        QString junit = run->results;
+        junit.chop(4);
+        run->writer = new ResultsWriter(run->outputFile, junit + ".junit.xml", suite);
+        return true;
+    }
+
+    void HarnessRunner::closeFiles(Run * const run)
+    {
+        if (run->recorder)
+        {
+            delete run->recorder;
+            run->recorder = NULL;
+        }
+        if (run->writer)
+        {
+            delete run->writer;
+            run->writer = NULL;
+        }
+        if (run->outputFile)
+        {
+            run->outputFile->close();
+            run->outputFile->deleteLater();
+            run->outputFile = NULL;
+        }
+    }
+
+    void HarnessRunner::cliFinished(int exitCode)
+    {
+        HarnessCli * const cli = qobject_cast<HarnessCli*>(this->sender());
+        if (not cli or not this->active.contains(cli))
+        {
+            return;
+        }
+        Run& run = this->runs[this->active.take(cli)];
+        run.exitCode = exitCode;
+        run.durationMs = run.timer.elapsed();
+        const int device = run.device;
+        if (cli->isIdle())
+        {
+            // still connected, the next script for the target can use it
+            this->idle.insert(device, cli);
+        }
+        else
+        {
+            // we're inside the CLI's signal so it can't be deleted yet
+            cli->deleteLater();
+        }
+        if (run.writer)
+        {
+            QMap<QString, LatencyHistogram>::const_iterator it =
+                    run.writer->latencies().constBegin();
+            for ( ; it not_eq run.writer->latencies().constEnd() ; ++it)
+            {
+                this->latencies[it.key()].merge(it.value());
+            }
+        }
+        this->closeFiles(&run);
+
+        if (this->sharded and not cli->receivedWelcome())
+        {
+            // the script goes back with the rest of the target's queue
+            run.requeued = true;
+            this->queues[device].prepend(run.script);
+            this->removeDevice(device);
+        }
+        else
+        {
+            this->startNextRun(device);
+        }
+        this->finishIfIdle();
+    }
+
+    void HarnessRunner::finishIfIdle(void)
+    {
+        if (not this->active.isEmpty())
+        {
+            return;
+        }
+        foreach (HarnessCli * const cli, this->idle)
+        {
+            cli->deleteLater();
+        }
+        this->idle.clear();
+        this->printLatencies();
+        if (not this->summaryFile.isEmpty())
+        {
+            this->writeSummary();
+        }
+        if (this->sharded and not this->durationsFile.isEmpty())
+        {
+            this->writeDurations();
+        }
+        int exitCode = EXIT_SUCCESS;
+        foreach (const Run& run, this->runs)
+        {
+            if (run.exitCode not_eq EXIT_SUCCESS and not run.requeued)
+            {
+                exitCode = EXIT_FAILURE;
+            }
+        }
+        QCoreApplication::exit(exitCode);
+    }
+
+    void HarnessRunner::writeSummary(void)
+    {
+        QFile file(this->summaryFile);
+        if (not file.open(QIODevice::WriteOnly bitor QIODevice::Text))
+        {
+            qWarning("Failed to open the summary file %s",
+                     qPrintable(this->summaryFile));
+            return;
+        }
+
+        int passed = 0;
+        int failed = 0;
+        foreach (const Run& run, this->runs)
+        {
+            if (run.requeued)
+            {
+                continue;
+            }
+            if (run.exitCode == EXIT_SUCCESS)
+            {
+                passed++;
+            }
+            else
+            {
+                failed++;
+            }
+        }
+
+        QTextStream out(&file);
+        out.setCodec("UTF-8");
+        out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\r\n";
+        out << "<summary devices=\"" << this->devices.size()
+            << "\" runs=\"" << (passed + failed)
+            << "\" passed=\"" << passed
+            << "\" failed=\"" << failed
+            << "\" durationMs=\"" << this->clock.elapsed()
+            << "\">\r\n";
+        foreach (const Run& run, this->runs)
+        {
+            const Device& device = this->devices.at(run.device);
+            const char * const result = run.requeued ?
+                        "requeued" : run.exitCode == EXIT_SUCCESS ? "pass" : "fail";
+            out << "\t<run device=\"" << ResultsWriter::escape(device.host) << ":" << device.port
+                << "\" script=\"" << ResultsWriter::escape(run.script)
+                << "\" results=\"" << ResultsWriter::escape(run.results)
+                << "\" result=\"" << result
+                << "\" durationMs=\"" << run.durationMs
+                << "\"/>\r\n";
+        }
+        out << ResultsWriter::latencyXml(this->latencies);
+        out << "</summary>\r\n";
+    }
+
+    void HarnessRunner::printLatencies(void)
+    {
+        if (this->latencies.isEmpty())
+        {
+            return;
+        }
+        QTextStream qOut(stdout);
+        qOut.setRealNumberNotation(QTextStream::FixedNotation);
+        qOut.setRealNumberPrecision(3);
+        qOut << "\n";
+        qOut << qSetFieldWidth(20) << left << "verb"
+             << qSetFieldWidth(10) << right << "count"
+             << "p50 ms" << "p90 ms" << "p99 ms" << "max ms"
+             << qSetFieldWidth(0) << "\n";
+        QMap<QString, LatencyHistogram>::const_iterator it = this->latencies.constBegin();
+        for ( ; it not_eq this->latencies.constEnd() ; ++it)
+        {
+            const LatencyHistogram& histogram = it.value();
+            qOut << qSetFieldWidth(20) << left << it.key()
+                 << qSetFieldWidth(10) << right << histogram.count()
+                 << histogram.percentile(50) / 1000.0
+                 << histogram.percentile(90) / 1000.0
+                 << histogram.percentile(99) / 1000.0
+                 << histogram.max() / 1000.0
+                 << qSetFieldWidth(0) << "\n";
+        }
+        qOut.flush();
+    }
+
+    void HarnessRunner::writeDurations(void)
+    {
+        foreach (const Run& run, this->runs)
+        {
+            if (not run.requeued and run.durationMs > 0)
+            {
+                this->durations.insert(this->durationKey(run.script), run.durationMs);
+            }
+        }
+
+        QFile file(this->durationsFile);
+        if (not file.open(QIODevice::WriteOnly bitor QIODevice::Text))
+        {
+            qWarning("Failed to open the durations file %s",
+                     qPrintable(this->durationsFile));
+            return;
+        }
+        QTextStream out(&file);
+        out.setCodec("UTF-8");
+        QHash<QString, qint64>::const_iterator it = this->durations.constBegin();
+        for ( ; it not_eq this->durations.constEnd() ; ++it)
+        {
+            out << it.value() << " " << it.key() << "\n";
+        }
+    }
+}  // namespace cli
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
@@ -0,0 +1,350 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#include "include/script.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+namespace cli
+{
+    /*!
+     * \brief MAX_COMMAND_LENGTH The harness reads at most this many bytes
+     * of a command, including the line ending
+     */
+    static const int MAX_COMMAND_LENGTH = 1024;
+
+    ScriptSettings::ScriptSettings()
+        : retry(false),
+          retryInterval(1000),
+          retryMaxIntervals(30),
+          failureOk(false),
+          window(1)
+    {
+    }
+
+    void ScriptSettings::apply(const ScriptInstruction& instruction)
+    {
+        const ScriptSettings defaults;
+        switch (instruction.setting)
+        {
+        case ScriptInstruction::SETTING_RETRY:
+            this->retry = instruction.reset ? defaults.retry : instruction.value;
+            break;
+        case ScriptInstruction::SETTING_RETRY_INTERVAL:
+            this->retryInterval = instruction.reset ?
+                        defaults.retryInterval : instruction.value;
+            break;
+        case ScriptInstruction::SETTING_RETRY_MAX_INTERVALS:
+            this->retryMaxIntervals = instruction.reset ?
+                        defaults.retryMaxIntervals : instruction.value;
+            break;
+        case ScriptInstruction::SETTING_FAILURE_OK:
+            this->failureOk = instruction.reset ? defaults.failureOk : instruction.value;
+            break;
+        case ScriptInstruction::SETTING_WINDOW:
+            this->window = instruction.reset ? defaults.window : instruction.value;
+            break;
+        }
+    }
+
+    Script::Script(const QString& fileName)
+        : name(fileName)
+    {
+    }
+
+    int Script::commandsFrom(const int index) const
+    {
+        int commands = 0;
+        for (int i = index ; i < this->list.size() ; i++)
+        {
+            if (this->list.at(i).type == ScriptInstruction::COMMAND)
+            {
+                commands++;
+            }
+        }
+        return commands;
+    }
+
+    ScriptCompiler::ScriptCompiler(const int maxCallDepth)
+        : maxDepth(maxCallDepth)
+    {
+    }
+
+    ScriptCompiler::~ScriptCompiler()
+    {
+        qDeleteAll(this->scripts);
+    }
+
+    const Script * ScriptCompiler::compile(const QString& fileName, QString * const error)
+    {
+        const QFileInfo info(fileName);
+        if (not info.exists())
+        {
+            *error = fileName + ": doesn't exist";
+            return NULL;
+        }
+        const QString path = info.canonicalFilePath();
+        Script * script = this->scripts.value(path, NULL);
+        if (not script)
+        {
+            QList<ScriptInstruction> instructions;
+            QStringList stack;
+            if (not this->flatten(path, info.path(), &stack, &instructions, error))
+            {
+                return NULL;
+            }
+            script = new Script(fileName);
+            script->list = instructions;
+            this->scripts.insert(path, script);
+        }
+        return script;
+    }
+
+    const QList<ScriptInstruction> * ScriptCompiler::load(const QString& path,
+                                                          QString * const error)
+    {
+        if (not this->fileHashes.contains(path))
+        {
+            QFile file(path);
+            if (not file.open(QIODevice::ReadOnly))
+            {
+                *error = path + ": can't be opened";
+                return NULL;
+            }
+            const QByteArray content = file.readAll();
+            const QByteArray hash = QCryptographicHash::hash(content,
+                                                             QCryptographicHash::Sha1);
+            if (not this->parsedFiles.contains(hash))
+            {
+                QList<ScriptInstruction> instructions;
+                if (not parse(content, path, &instructions, error))
+                {
+                    return NULL;
+                }
+                this->parsedFiles.insert(hash, instructions);
+            }
+            this->fileHashes.insert(path, hash);
+        }
+        return &this->parsedFiles[this->fileHashes.value(path)];
+    }
+
+    bool ScriptCompiler::parse(const QByteArray& content,
+                               const QString& path,
+                               QList<ScriptInstruction> * const instructions,
+                               QString * const error)
+    {
+        const QList<QByteArray> lines = content.split('\n');
+        // a trailing new line doesn't start another line
+        const int lineCount = content.endsWith('\n') ? lines.size() - 1 : lines.size();
+        for (int i = 0 ; i < lineCount ; i++)
+        {
+            const QByteArray& raw = lines.at(i);
+            const QString line = QString::fromUtf8(raw).trimmed();
+            ScriptInstruction instruction;
+            instruction.line = i + 1;
+            instruction.setting = ScriptInstruction::SETTING_RETRY;
+            instruction.value = 0;
+            instruction.reset = false;
+            instruction.independent = false;
+            QString problem;
+
+            if (line.isEmpty())
+            {
+                instruction.type = ScriptInstruction::BLANK;
+            }
+            else if (line.startsWith('#'))
+            {
+                instruction.type = ScriptInstruction::COMMENT;
+                instruction.text = line;
+            }
+            else if (line == "call" or line.startsWith("call "))
+            {
+                instruction.type = ScriptInstruction::CALL;
+                instruction.text = line.mid(5).trimmed();
+                if (instruction.text.isEmpty())
+                {
+                    problem = "call needs a file name";
+                }
+            }
+            else if (line == "cli-setting" or line.startsWith("cli-setting "))
+            {
+                instruction.type = ScriptInstruction::SETTING;
+                instruction.text = line;
+                problem = parseSetting(line, &instruction);
+            }
+            else
+            {
+                instruction.type = ScriptInstruction::COMMAND;
+                instruction.text = line;
+                // assertions don't change the target so can be sent ahead
+                instruction.independent = (line.section(' ', 0, 0) == "test");
+                const QChar first = line.at(0);
+                if (not first.isLetter())
+                {
+                    problem = "'" + line + "' doesn't start with a command name";
+                }
+                else if (line.toUtf8().size() + 2 > MAX_COMMAND_LENGTH)
+                {
+                    problem = "command is longer than "
+                            + QString::number(MAX_COMMAND_LENGTH - 2) + " bytes";
+                }
+            }
+
+            if (not problem.isEmpty())
+            {
+                *error = path + ":" + QString::number(instruction.line) + ": " + problem;
+                return false;
+            }
+            instructions->append(instruction);
+        }
+        return true;
+    }
+
+    QString ScriptCompiler::parseSetting(const QString& line,
+                                         ScriptInstruction * const instruction)
+    {
+        const QStringList tokens = line.split(' ', QString::SkipEmptyParts);
+        if (tokens.size() < 2 or tokens.size() > 3)
+        {
+            return "cli-setting needs a name and an optional value";
+        }
+
+        const QString& name = tokens.at(1);
+        bool isBool = false;
+        if (name == "retry")
+        {
+            instruction->setting = ScriptInstruction::SETTING_RETRY;
+            isBool = true;
+        }
+        else if (name == "retry-interval")
+        {
+            instruction->setting = ScriptInstruction::SETTING_RETRY_INTERVAL;
+        }
+        else if (name == "retry-max-intervals")
+        {
+            instruction->setting = ScriptInstruction::SETTING_RETRY_MAX_INTERVALS;
+        }
+        else if (name == "failure-ok")
+        {
+            instruction->setting = ScriptInstruction::SETTING_FAILURE_OK;
+            isBool = true;
+        }
+        else if (name == "window")
+        {
+            instruction->setting = ScriptInstruction::SETTING_WINDOW;
+        }
+        else
+        {
+            return "unknown cli-setting '" + name + "'";
+        }
+
+        if (tokens.size() == 2)
+        {
+            instruction->reset = true;
+            return QString();
+        }
+
+        const QString& value = tokens.at(2);
+        bool ok = false;
+        if (isBool and (value == "true" or value == "false"))
+        {
+            instruction->value = (value == "true");
+            ok = true;
+        }
+        else
+        {
+            instruction->value = value.toInt(&ok);
+            ok = ok and instruction->value >= 0;
+            if (instruction->setting == ScriptInstruction::SETTING_WINDOW)
+            {
+                ok = ok and instruction->value >= 1;
+            }
+            if (isBool)
+            {
+                instruction->value = (instruction->value not_eq 0);
+            }
+        }
+        if (not ok)
+        {
+            return "'" + value + "' isn't a valid value for " + name;
+        }
+        return QString();
+    }
+
+    bool ScriptCompiler::flatten(const QString& path,
+                                 const QString& rootDir,
+                                 QStringList * const stack,
+                                 QList<ScriptInstruction> * const out,
+                                 QString * const error)
+    {
+        if (stack->size() >= this->maxDepth)
+        {
+            *error = path + ": calls are nested more than "
+                    + QString::number(this->maxDepth) + " deep";
+            return false;
+        }
+        if (stack->contains(path))
+        {
+            *error = path + ": calls itself via " + stack->join(" -> ");
+            return false;
+        }
+        const QList<ScriptInstruction> * const loaded = this->load(path, error);
+        if (not loaded)
+        {
+            return false;
+        }
+        // take a (shared) copy as the nested calls add to the cache
+        const QList<ScriptInstruction> instructions = *loaded;
+
+        stack->append(path);
+        foreach (const ScriptInstruction& instruction, instructions)
+        {
+            if (instruction.type not_eq ScriptInstruction::CALL)
+            {
+                out->append(instruction);
+                continue;
+            }
+
+            // called files are relative to the working directory or,
+            // failing that, to the root script
+            QFileInfo called(instruction.text);
+            if (not called.exists())
+            {
+                called = QFileInfo(rootDir + QDir::separator() + instruction.text);
+            }
+            if (not called.exists())
+            {
+                *error = path + ":" + QString::number(instruction.line)
+                        + ": can't find '" + instruction.text + "'";
+                return false;
+            }
+
+            ScriptInstruction enter = instruction;
+            enter.type = ScriptInstruction::ENTER_FILE;
+            enter.text = called.filePath();
+            out->append(enter);
+            if (not this->flatten(called.canonicalFilePath(), rootDir, stack, out, error))
+            {
+                return false;
+            }
+            ScriptInstruction leave = instruction;
+            leave.type = ScriptInstruction::LEAVE_FILE;
+            leave.text = path;
+            out->append(leave);
+        }
+        stack->removeLast();
+        return true;
+    }
+}  // namespace cli
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
@@ -19,9 +19,22 @@ INCLUDEPATH += include \
 
 TEMPLATE = app
 
+# zlib for compressed recordings
+LIBS += -lz
+
 
 SOURCES += src/main.cpp \
-    src/cli.cpp
+    src/cli.cpp \
+    src/runner.cpp \
+    src/script.cpp \
+    src/results.cpp \
+    src/histogram.cpp \
+    src/recorder.cpp
 
 HEADERS += \
-    include/cli.h
+    include/cli.h \
+    include/runner.h \
+    include/script.h \
+    include/results.h \
+    include/histogram.h \
+    include/recorder.h
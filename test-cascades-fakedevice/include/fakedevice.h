@@ -0,0 +1,314 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#ifndef FAKEDEVICE_H_
+#define FAKEDEVICE_H_
+
+#include <QObject>
+#include <QHash>
+#include <QQueue>
+#include <QStringList>
+#include <QElapsedTimer>
+
+class QFile;
+class QTcpServer;
+class QTcpSocket;
+class QTimer;
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+namespace fakedevice
+{
+    /*!
+     * \brief The CommandProfile struct describes how the fake device
+     * replies to a single command verb.
+     *
+     * @since test-cascades 1.1.5
+     */
+    struct CommandProfile
+    {
+        /*!
+         * \brief latencyMs The time to wait before replying
+         */
+        int latencyMs;
+        /*!
+         * \brief jitterMs Random extra time (0..jitterMs) added to the latency
+         */
+        int jitterMs;
+        /*!
+         * \brief errorPercent The chance (0-100) that the reply is an error
+         */
+        int errorPercent;
+    };
+
+    /*!
+     * \brief The FakeDevice class is a TCP server that speaks the
+     * harness line protocol without a BlackBerry device or simulator.
+     *
+     * It sends the @c OK banner on connect, replies to every command
+     * after a configurable latency (optionally with injected errors)
+     * and can replay a recorded script as a @c record stream.
+     *
+     * @since test-cascades 1.1.5
+     */
+    class FakeDevice : public QObject
+    {
+        Q_OBJECT
+        public:
+            /*!
+             * \brief FakeDevice Create a new fake device
+             *
+             * \param profiles The reply profiles keyed by command verb. The
+             * verb @c * is used for commands without a profile of their own.
+             * \param recording The lines streamed back to @c record clients
+             * \param recordSpeed Speed-up applied to the @c sleep lines in
+             * @c recording (2.0 replays twice as fast)
+             * \param parent The parent object
+             *
+             * @since test-cascades 1.1.5
+             */
+            FakeDevice(const QHash<QString, CommandProfile>& profiles,
+                       const QStringList& recording,
+                       const double recordSpeed,
+                       QObject * parent = 0);
+            /*!
+             * \brief ~FakeDevice Destructor
+             *
+             * @since test-cascades 1.1.5
+             */
+            virtual ~FakeDevice();
+            /*!
+             * \brief listen Start listening for clients
+             *
+             * \param port The TCP port to listen on
+             *
+             * \return @c true if the server is listening
+             *
+             * @since test-cascades 1.1.5
+             */
+            bool listen(const quint16 port);
+            /*!
+             * \brief profileFor Get the reply profile for a command verb
+             *
+             * \param verb The command verb
+             *
+             * \return The profile for @c verb or the default profile
+             *
+             * @since test-cascades 1.1.5
+             */
+            CommandProfile profileFor(const QString& verb) const;
+            /*!
+             * \brief recording The lines to stream to recording clients
+             *
+             * \return The recorded script
+             *
+             * @since test-cascades 1.1.5
+             */
+            const QStringList& recording() const
+            {
+                return this->recordedLines;
+            }
+            /*!
+             * \brief recordSpeed The speed-up for recorded sleeps
+             *
+             * \return The speed-up factor
+             *
+             * @since test-cascades 1.1.5
+             */
+            double recordSpeed() const
+            {
+                return this->recordSpeedFactor;
+            }
+            /*!
+             * \brief loadProfiles Parse a profile file. Each line is
+             * <verb> <latencyMs> [<errorPercent>] [<jitterMs>] and lines
+             * starting with # are ignored.
+             *
+             * \param file An open, readable file
+             * \param profiles The profile table to fill in
+             *
+             * \return @c false if a line couldn't be parsed
+             *
+             * @since test-cascades 1.1.5
+             */
+            static bool loadProfiles(QFile * const file,
+                                     QHash<QString, CommandProfile> * const profiles);
+        protected:
+        private:
+            /*!
+             * \brief server The listening socket
+             */
+            QTcpServer * const server;
+            /*!
+             * \brief profiles Reply profiles keyed by verb
+             */
+            const QHash<QString, CommandProfile> profiles;
+            /*!
+             * \brief recordedLines The lines streamed in record mode
+             */
+            const QStringList recordedLines;
+            /*!
+             * \brief recordSpeedFactor Speed-up for recorded sleeps
+             */
+            const double recordSpeedFactor;
+            /*!
+             * \brief clientCount The number of clients accepted so far
+             */
+            int clientCount;
+        private slots:
+            /*!
+             * \brief acceptConnection Accept a new client
+             *
+             * @since test-cascades 1.1.5
+             */
+            void acceptConnection(void);
+    };
+
+    /*!
+     * \brief The FakeDeviceClient class handles a single client
+     * connection to the fake device. Replies are kept in order, like
+     * the real harness, even when verbs have different latencies.
+     *
+     * @since test-cascades 1.1.5
+     */
+    class FakeDeviceClient : public QObject
+    {
+        Q_OBJECT
+        public:
+            /*!
+             * \brief FakeDeviceClient Create a new client handler
+             *
+             * \param socket The client socket
+             * \param device The device that accepted the client
+             * \param id The client number, used for logging
+             * \param parent The parent object
+             *
+             * @since test-cascades 1.1.5
+             */
+            FakeDeviceClient(QTcpSocket * const socket,
+                             const FakeDevice * const device,
+                             const int id,
+                             QObject * parent = 0);
+            /*!
+             * \brief ~FakeDeviceClient Destructor
+             *
+             * @since test-cascades 1.1.5
+             */
+            virtual ~FakeDeviceClient();
+        protected:
+        private:
+            /*!
+             * \brief The PendingReply struct is a reply waiting for its
+             * latency to expire
+             */
+            struct PendingReply
+            {
+                /*!
+                 * \brief dueMs When to send the reply (ms since connect)
+                 */
+                qint64 dueMs;
+                /*!
+                 * \brief data The reply line
+                 */
+                QByteArray data;
+                /*!
+                 * \brief closeAfter Close the connection once sent
+                 */
+                bool closeAfter;
+                /*!
+                 * \brief startRecording Start the record stream once sent
+                 */
+                bool startRecording;
+            };
+            /*!
+             * \brief socket The client socket
+             */
+            QTcpSocket * const socket;
+            /*!
+             * \brief device The device that owns the client
+             */
+            const FakeDevice * const device;
+            /*!
+             * \brief id The client number
+             */
+            const int id;
+            /*!
+             * \brief clock Time since the client connected
+             */
+            QElapsedTimer clock;
+            /*!
+             * \brief replies Replies waiting to be sent, in order
+             */
+            QQueue<PendingReply> replies;
+            /*!
+             * \brief replyTimer Fires when the head of @c replies is due
+             */
+            QTimer * const replyTimer;
+            /*!
+             * \brief recordTimer Drives the record stream
+             */
+            QTimer * const recordTimer;
+            /*!
+             * \brief recordIndex The next line of the recording to send
+             */
+            int recordIndex;
+            /*!
+             * \brief commandCount The number of commands received
+             */
+            quint64 commandCount;
+            /*!
+             * \brief errorCount The number of injected errors
+             */
+            quint64 errorCount;
+            /*!
+             * \brief queueReply Queue a reply to a command
+             *
+             * \param verb The verb of the command
+             * \param arguments The arguments of the command
+             *
+             * @since test-cascades 1.1.5
+             */
+            void queueReply(const QString& verb, const QStringList& arguments);
+            /*!
+             * \brief scheduleReplies Restart the reply timer for the head
+             * of the queue
+             *
+             * @since test-cascades 1.1.5
+             */
+            void scheduleReplies(void);
+        private slots:
+            /*!
+             * \brief dataReady Read commands from the client
+             *
+             * @since test-cascades 1.1.5
+             */
+            void dataReady(void);
+            /*!
+             * \brief sendDueReplies Send all replies whose latency has expired
+             *
+             * @since test-cascades 1.1.5
+             */
+            void sendDueReplies(void);
+            /*!
+             * \brief streamRecording Send recorded lines up to the next sleep
+             *
+             * @since test-cascades 1.1.5
+             */
+            void streamRecording(void);
+            /*!
+             * \brief disconnected Print the client statistics and clean up
+             *
+             * @since test-cascades 1.1.5
+             */
+            void disconnected(void);
+    };
+}  // namespace fakedevice
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
+
+#endif  // FAKEDEVICE_H_
@@ -0,0 +1,288 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#include "include/fakedevice.h"
+
+#include <QFile>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTextStream>
+#include <QTimer>
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+namespace fakedevice
+{
+    FakeDevice::FakeDevice(const QHash<QString, CommandProfile>& replyProfiles,
+                           const QStringList& recording,
+                           const double speed,
+                           QObject * parent)
+        : QObject(parent),
+          server(new QTcpServer(this)),
+          profiles(replyProfiles),
+          recordedLines(recording),
+          recordSpeedFactor(speed > 0.0 ? speed : 1.0),
+          clientCount(0)
+    {
+        connect(this->server,
+                SIGNAL(newConnection()),
+                SLOT(acceptConnection()));
+    }
+
+    FakeDevice::~FakeDevice()
+    {
+        this->server->close();
+    }
+
+    bool FakeDevice::listen(const quint16 port)
+    {
+        return this->server->listen(QHostAddress::Any, port);
+    }
+
+    CommandProfile FakeDevice::profileFor(const QString& verb) const
+    {
+        CommandProfile none = { 0, 0, 0 };
+        return this->profiles.value(verb, this->profiles.value("*", none));
+    }
+
+    bool FakeDevice::loadProfiles(QFile * const file,
+                                  QHash<QString, CommandProfile> * const profiles)
+    {
+        bool ok = true;
+        int lineNumber = 0;
+        while (not file->atEnd())
+        {
+            const QString line = QString(file->readLine()).trimmed();
+            lineNumber++;
+            if (line.isEmpty() or line.startsWith('#'))
+            {
+                continue;
+            }
+            const QStringList tokens = line.split(' ', QString::SkipEmptyParts);
+            CommandProfile profile = { 0, 0, 0 };
+            bool latencyOk = tokens.size() >= 2;
+            if (latencyOk)
+            {
+                profile.latencyMs = tokens.at(1).toInt(&latencyOk);
+            }
+            bool errorOk = true;
+            if (tokens.size() >= 3)
+            {
+                profile.errorPercent = tokens.at(2).toInt(&errorOk);
+            }
+            bool jitterOk = true;
+            if (tokens.size() >= 4)
+            {
+                profile.jitterMs = tokens.at(3).toInt(&jitterOk);
+            }
+            if (latencyOk and errorOk and jitterOk and tokens.size() <= 4)
+            {
+                profiles->insert(tokens.first(), profile);
+            }
+            else
+            {
+                qWarning("Profile line %d isn't <verb> <latencyMs> [<errorPercent>] [<jitterMs>]",
+                         lineNumber);
+                ok = false;
+            }
+        }
+        return ok;
+    }
+
+    void FakeDevice::acceptConnection(void)
+    {
+        while (this->server->hasPendingConnections())
+        {
+            QTcpSocket * const socket = this->server->nextPendingConnection();
+            if (socket)
+            {
+                new FakeDeviceClient(socket, this, this->clientCount++, this);
+            }
+        }
+    }
+
+    FakeDeviceClient::FakeDeviceClient(QTcpSocket * const clientSocket,
+                                       const FakeDevice * const owner,
+                                       const int clientId,
+                                       QObject * parent)
+        : QObject(parent),
+          socket(clientSocket),
+          device(owner),
+          id(clientId),
+          replyTimer(new QTimer(this)),
+          recordTimer(new QTimer(this)),
+          recordIndex(-1),
+          commandCount(0),
+          errorCount(0)
+    {
+        this->clock.start();
+        this->socket->setParent(this);
+        this->replyTimer->setSingleShot(true);
+        this->recordTimer->setSingleShot(true);
+        connect(this->socket, SIGNAL(readyRead()), SLOT(dataReady()));
+        connect(this->socket, SIGNAL(disconnected()), SLOT(disconnected()));
+        connect(this->replyTimer, SIGNAL(timeout()), SLOT(sendDueReplies()));
+        connect(this->recordTimer, SIGNAL(timeout()), SLOT(streamRecording()));
+        // not translated; protocol
+        this->socket->write("OK\r\n");
+        this->socket->flush();
+    }
+
+    FakeDeviceClient::~FakeDeviceClient()
+    {
+    }
+
+    void FakeDeviceClient::dataReady(void)
+    {
+        while (this->socket->canReadLine())
+        {
+            const QString line = QString::fromUtf8(this->socket->readLine(1024)).trimmed();
+            if (line.isEmpty() or line.startsWith('#'))
+            {
+                continue;
+            }
+            QStringList arguments = line.split(' ', QString::SkipEmptyParts);
+            const QString verb = arguments.takeFirst();
+            this->commandCount++;
+            queueReply(verb, arguments);
+        }
+        scheduleReplies();
+    }
+
+    void FakeDeviceClient::queueReply(const QString& verb, const QStringList& arguments)
+    {
+        const CommandProfile profile = this->device->profileFor(verb);
+        qint64 delay = profile.latencyMs;
+        if (profile.jitterMs > 0)
+        {
+            delay += qrand() % (profile.jitterMs + 1);
+        }
+
+        PendingReply reply;
+        reply.closeAfter = false;
+        reply.startRecording = false;
+        reply.data = "OK\r\n";
+
+        if (verb == "sleep" and not arguments.isEmpty())
+        {
+            delay += arguments.first().toInt();
+        }
+        else if (verb == "record")
+        {
+            if (arguments.isEmpty())
+            {
+                reply.startRecording = true;
+            }
+            else
+            {
+                this->recordTimer->stop();
+                this->recordIndex = -1;
+            }
+        }
+        else if (verb == "exit")
+        {
+            reply.closeAfter = true;
+        }
+
+        if (profile.errorPercent > 0 and (qrand() % 100) < profile.errorPercent)
+        {
+            reply.data = "ERROR: Injected failure for " + verb.toUtf8() + "\r\n";
+            reply.startRecording = false;
+            reply.closeAfter = false;
+            this->errorCount++;
+        }
+
+        // replies leave in the order the commands arrived, just like
+        // the harness, so a slow verb holds back everything behind it
+        const qint64 now = this->clock.elapsed();
+        reply.dueMs = now + delay;
+        if (not this->replies.isEmpty() and this->replies.last().dueMs > reply.dueMs)
+        {
+            reply.dueMs = this->replies.last().dueMs;
+        }
+        this->replies.enqueue(reply);
+    }
+
+    void FakeDeviceClient::scheduleReplies(void)
+    {
+        if (not this->replies.isEmpty())
+        {
+            const qint64 wait = this->replies.head().dueMs - this->clock.elapsed();
+            this->replyTimer->start(wait > 0 ? static_cast<int>(wait) : 0);
+        }
+    }
+
+    void FakeDeviceClient::sendDueReplies(void)
+    {
+        const qint64 now = this->clock.elapsed();
+        bool wrote = false;
+        while (not this->replies.isEmpty() and this->replies.head().dueMs <= now)
+        {
+            const PendingReply reply = this->replies.dequeue();
+            this->socket->write(reply.data);
+            wrote = true;
+            if (reply.closeAfter)
+            {
+                this->socket->flush();
+                this->socket->disconnectFromHost();
+                this->replies.clear();
+                return;
+            }
+            if (reply.startRecording)
+            {
+                this->recordIndex = 0;
+                this->recordTimer->start(0);
+            }
+        }
+        if (wrote)
+        {
+            this->socket->flush();
+        }
+        scheduleReplies();
+    }
+
+    void FakeDeviceClient::streamRecording(void)
+    {
+        const QStringList& recording = this->device->recording();
+        while (this->recordIndex >= 0 and this->recordIndex < recording.size())
+        {
+            const QString line = recording.at(this->recordIndex++);
+            this->socket->write(line.toUtf8() + "\r\n");
+            // the recorder writes the sleep before the event it
+            // precedes, so honour it before sending the next line
+            if (line.startsWith("sleep "))
+            {
+                const int ms = line.mid(6).trimmed().toInt();
+                this->recordTimer->start(static_cast<int>(ms / this->device->recordSpeed()));
+                break;
+            }
+        }
+        this->socket->flush();
+    }
+
+    void FakeDeviceClient::disconnected(void)
+    {
+        const qint64 elapsed = this->clock.elapsed();
+        QTextStream qOut(stdout);
+        qOut << "client " << this->id << ": "
+             << this->commandCount << " commands, "
+             << this->errorCount << " injected errors in "
+             << elapsed << "ms";
+        if (elapsed > 0)
+        {
+            qOut << " (" << (this->commandCount * 1000.0 / elapsed) << " commands/s)";
+        }
+        qOut << "\n";
+        qOut.flush();
+        this->replyTimer->stop();
+        this->recordTimer->stop();
+        this->deleteLater();
+    }
+}  // namespace fakedevice
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
@@ -0,0 +1,110 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#include <QCoreApplication>
+#include <QFile>
+#include <QStringList>
+
+#include "include/fakedevice.h"
+
+using truphone::test::cascades::fakedevice::CommandProfile;
+using truphone::test::cascades::fakedevice::FakeDevice;
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QStringList args = a.arguments();
+    args.removeFirst();
+
+    if (args.isEmpty())
+    {
+        qWarning("test-cascades-fakedevice <port> [--profile <file>] [--record <file>]");
+        qWarning("                         [--record-speed <factor>] [--seed <n>]");
+        qWarning("----------------------------------------------------");
+        qWarning("test-cascades-fakedevice speaks the harness line protocol so the CLI and");
+        qWarning("the Java library can be run and benchmarked without a device.");
+        qWarning("The profile file has one '<verb> <latencyMs> [<errorPercent>] [<jitterMs>]'");
+        qWarning("per line; the verb '*' applies to every verb without its own line.");
+        qWarning("The record file is a recorded script that is streamed back to clients");
+        qWarning("that send 'record', honouring its sleep lines.");
+        return -1;
+    }
+
+    bool portOk = false;
+    const quint16 port = args.takeFirst().toUShort(&portOk);
+    if (not portOk)
+    {
+        qWarning("The port must be a number");
+        return -2;
+    }
+
+    QHash<QString, CommandProfile> profiles;
+    QStringList recording;
+    double recordSpeed = 1.0;
+    uint seed = 1;
+
+    while (not args.isEmpty())
+    {
+        const QString option = args.takeFirst();
+        if (args.isEmpty())
+        {
+            qWarning("%s needs a value", qPrintable(option));
+            return -3;
+        }
+        const QString value = args.takeFirst();
+        if (option == "--profile")
+        {
+            QFile profileFile(value);
+            if (not profileFile.open(QIODevice::ReadOnly bitor QIODevice::Text))
+            {
+                qWarning("Profile file can't be opened");
+                return -4;
+            }
+            if (not FakeDevice::loadProfiles(&profileFile, &profiles))
+            {
+                return -5;
+            }
+        }
+        else if (option == "--record")
+        {
+            QFile recordFile(value);
+            if (not recordFile.open(QIODevice::ReadOnly bitor QIODevice::Text))
+            {
+                qWarning("Record file can't be opened");
+                return -6;
+            }
+            while (not recordFile.atEnd())
+            {
+                const QString line = QString::fromUtf8(recordFile.readLine()).trimmed();
+                if (not line.isEmpty())
+                {
+                    recording.append(line);
+                }
+            }
+        }
+        else if (option == "--record-speed")
+        {
+            recordSpeed = value.toDouble();
+        }
+        else if (option == "--seed")
+        {
+            seed = value.toUInt();
+        }
+        else
+        {
+            qWarning("Unknown option %s", qPrintable(option));
+            return -3;
+        }
+    }
+
+    qsrand(seed);
+
+    FakeDevice device(profiles, recording, recordSpeed, &a);
+    if (not device.listen(port))
+    {
+        qWarning("Failed to listen on port %d", port);
+        return -7;
+    }
+
+    return a.exec();
+}
@@ -0,0 +1,27 @@
+#-------------------------------------------------
+#
+# Fake device for running the CLI/Java library
+# without a BlackBerry device or simulator
+#
+#-------------------------------------------------
+
+QT       += core
+
+QT       -= gui
+
+QT       += network
+
+TARGET = test-cascades-fakedevice
+CONFIG   += console
+CONFIG   -= app_bundle
+
+INCLUDEPATH += include
+
+TEMPLATE = app
+
+
+SOURCES += src/main.cpp \
+    src/fakedevice.cpp
+
+HEADERS += \
+    include/fakedevice.h
@@ -84,22 +84,27 @@ namespace cascades
         /*!
          * \brief findAction Find an action for a given name
          *
-         * \param obj Object to search. The object will be checked and so will its children
-         * \param name The name of the action to find
-         * \param call_depth The current level of call depth
-         * \param max_call_depth The maximum level of call depth
-         * \return Return an @c AbstractActionItem or @c NULL if
-         * the action can't be found or the recursive call depth
-         * exceeds the maximum call depth
+         * \param root The object the action should be under
+         * \param name The object name or title of the action to find
+         * \return Return an @c AbstractActionItem with that object name
+         * under @c root, or anywhere, or with that title under @c root,
+         * or @c NULL if the action can't be found
          *
          * @since test-cascades 1.0.0
          */
         static bb::cascades::AbstractActionItem * findAction(
-                const QObject * const obj,
-                const QString& name,
-                const size_t call_depth = 0,
-                // we don't want search depth > 10 objects
-                const size_t max_call_depth = 10);
+                const QObject * const root,
+                const QString& name);
+        /*!
+         * \brief isUnder Check if an object is under another
+         *
+         * \param object The object
+         * \param root The object it may be under
+         * \return @c true if @c root is the object or one of its parents
+         *
+         * @since test-cascades 1.1.5
+         */
+        static bool isUnder(const QObject * object, const QObject * const root);
         /*!
          * \brief findCurrentPage Search (from @c pane) to find the current Page being
          * displayed
@@ -0,0 +1,92 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#ifndef AUTORESPONDCOMMAND_H_
+#define AUTORESPONDCOMMAND_H_
+
+#include <QObject>
+
+#include "Command.h"
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    /*!
+     * \brief The AutoRespondCommand class adds rules that answer system
+     * dialogs and dismiss toasts as soon as they're shown, rather than the
+     * test polling for them.
+     *
+     * @since test-cascades 1.1.5
+     */
+    class AutoRespondCommand : public Command
+    {
+    Q_OBJECT
+    public:
+        /*!
+         * \brief getCmd Return the name of this command
+         *
+         * \return Command name
+         *
+         * @since test-cascades 1.1.5
+         */
+        static QString getCmd()
+        {
+            return CMD_NAME;
+        }
+        /*!
+         * \brief create Create a new instance of this Command
+         *
+         * \param s The TCP socket associated with the client
+         * \param parent The parent object
+         * \return Returns a new instance of the Command
+         *
+         * @since test-cascades 1.1.5
+         */
+        static Command* create(class Connection * const s,
+                               QObject * parent = 0)
+        {
+            return new AutoRespondCommand(s, parent);
+        }
+        /*!
+         * \brief AutoRespondCommand Constructor
+         *
+         * \param socket The TCP socket associated with the client
+         * \param parent The parent object
+         *
+         * @since test-cascades 1.1.5
+         */
+        AutoRespondCommand(class Connection * const socket,
+                           QObject* parent = 0);
+        /*!
+         * \brief ~AutoRespondCommand Destructor
+         *
+         * @since test-cascades 1.1.5
+         */
+        ~AutoRespondCommand();
+        /*
+         * See super
+         */
+        bool executeCommand(QStringList * const arguments);
+        /*
+         * See super
+         */
+        void showHelp(void);
+    protected:
+    private:
+        /*!
+         * \brief CMD_NAME The name of this command
+         */
+        static const QString CMD_NAME;
+        /*!
+         * \brief client The TCP socket associated with the client
+         */
+        class Connection * const client;
+    };
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
+
+#endif  // AUTORESPONDCOMMAND_H_
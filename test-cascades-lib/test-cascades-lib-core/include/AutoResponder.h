@@ -0,0 +1,207 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#ifndef AUTORESPONDER_H_
+#define AUTORESPONDER_H_
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QSet>
+#include <QString>
+#include <QTimer>
+
+#include <bb/system/SystemUiResult>
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    /*!
+     * \brief The AutoResponder class answers system dialogs and dismisses
+     * toasts that match a rule as soon as they're showing, so a test
+     * doesn't have to poll for them.
+     *
+     * The dialogs, prompts and toasts come from the object registry as
+     * they're created. They're checked whenever an event reaches one of
+     * them and every @c CHECK_MS, without walking the object tree. A
+     * dialog or toast is answered once each time it's shown.
+     *
+     * @since test-cascades 1.1.5
+     */
+    class AutoResponder : public QObject
+    {
+        Q_OBJECT
+        public:
+            /*!
+             * \brief instance Get the responder
+             *
+             * \return The single instance
+             *
+             * @since test-cascades 1.1.5
+             */
+            static AutoResponder * instance();
+            /*!
+             * \brief exists Check if the responder has been started,
+             * without starting it
+             *
+             * \return @c true if @c instance has been called
+             *
+             * @since test-cascades 1.1.5
+             */
+            static bool exists(void)
+            {
+                return AutoResponder::singleton not_eq NULL;
+            }
+            /*!
+             * \brief ~AutoResponder Destructor
+             *
+             * @since test-cascades 1.1.5
+             */
+            virtual ~AutoResponder();
+            /*!
+             * \brief addDialogRule Answer a dialog or prompt
+             *
+             * \param name The dialog's object name, @c * for any
+             * \param result The button to finish it with
+             *
+             * @since test-cascades 1.1.5
+             */
+            void addDialogRule(const QString& name,
+                               const bb::system::SystemUiResult::Type result);
+            /*!
+             * \brief addToastRule Dismiss a toast
+             *
+             * \param text Text in the toast's body, @c * for any
+             *
+             * @since test-cascades 1.1.5
+             */
+            void addToastRule(const QString& text);
+            /*!
+             * \brief clear Remove the rules and stop watching
+             *
+             * @since test-cascades 1.1.5
+             */
+            void clear(void);
+            /*!
+             * \brief summary The rules and how often each has fired
+             *
+             * \return The rules as @c kind:match=action(fired)
+             *
+             * @since test-cascades 1.1.5
+             */
+            QString summary(void) const;
+            /*
+             * See super
+             */
+            bool eventFilter(QObject * const receiver, QEvent * const event);
+        protected:
+        private:
+            /*!
+             * \brief The Rule struct is a rule and its count
+             */
+            struct Rule
+            {
+                /*!
+                 * \brief toast @c true for a toast rule
+                 */
+                bool toast;
+                /*!
+                 * \brief match The dialog name or toast text
+                 */
+                QString match;
+                /*!
+                 * \brief result The button for a dialog rule
+                 */
+                bb::system::SystemUiResult::Type result;
+                /*!
+                 * \brief fired The number of times it has answered
+                 */
+                int fired;
+            };
+            /*!
+             * \brief AutoResponder Create the responder
+             */
+            AutoResponder();
+            /*!
+             * \brief start Start watching for new objects
+             *
+             * @since test-cascades 1.1.5
+             */
+            void start(void);
+            /*!
+             * \brief watch Watch an object if it's a dialog, prompt or toast
+             *
+             * \param object The object
+             *
+             * @since test-cascades 1.1.5
+             */
+            void watch(QObject * const object);
+            /*!
+             * \brief respond Answer an object if a rule matches
+             *
+             * \param object The dialog, prompt or toast
+             *
+             * \return @c true if it was answered
+             *
+             * @since test-cascades 1.1.5
+             */
+            bool respond(QObject * const object);
+            /*!
+             * \brief queueCheck Check at the end of this event loop pass
+             *
+             * @since test-cascades 1.1.5
+             */
+            void queueCheck(void);
+            /*!
+             * \brief singleton The single instance
+             */
+            static AutoResponder * singleton;
+            /*!
+             * \brief CHECK_MS The longest between checks of the watched objects
+             */
+            static const int CHECK_MS;
+            /*!
+             * \brief rules The rules, in the order they were added
+             */
+            QList<Rule> rules;
+            /*!
+             * \brief watched The dialogs, prompts and toasts
+             */
+            QHash<QObject*, QPointer<QObject> > watched;
+            /*!
+             * \brief answered The watched objects answered while showing
+             */
+            QSet<QObject*> answered;
+            /*!
+             * \brief checkQueued @c true if a check is queued
+             */
+            bool checkQueued;
+            /*!
+             * \brief checkTimer Checks the watched objects
+             */
+            QTimer checkTimer;
+        private slots:
+            /*!
+             * \brief check Check the watched objects
+             *
+             * @since test-cascades 1.1.5
+             */
+            void check(void);
+            /*!
+             * \brief objectRegistered Slot for a new object in the registry
+             *
+             * \param object The object
+             *
+             * @since test-cascades 1.1.5
+             */
+            void objectRegistered(QObject * object);
+    };
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
+
+#endif  // AUTORESPONDER_H_
@@ -5,6 +5,7 @@
 #define CONNECTION_H_
 
 #include <QObject>
+#include <QList>
 #include <QTcpSocket>
 #include <bb/cascades/Application>
 
@@ -19,12 +20,47 @@ namespace cascades
      * to the server and listens for requests from the client, looks up the
      * command and executes it.
      *
+     * What's written is queued and handed to the socket as it drains.
+     * Replies are always sent but streamed data (i.e. a recording) is
+     * limited: once the queue is over the limit the overflow policy
+     * decides what happens to it.
+     *
      * @since test-cascades 1.0.0
      */
     class Connection : public QObject
     {
         Q_OBJECT
         public:
+            /*!
+             * \brief The OverflowPolicy enum is what happens to streamed
+             * data when the queue is over its limit
+             *
+             * @since test-cascades 1.1.5
+             */
+            enum OverflowPolicy
+            {
+                /*!
+                 * \brief BLOCK Wait for the client to read, then drop the
+                 * oldest. The wait stalls the UI thread, so the waits of
+                 * one event loop pass add up to a second at most
+                 */
+                BLOCK,
+                /*!
+                 * \brief COALESCE Replace queued data of the same kind with
+                 * the newest where that data is replaceable (i.e. samples,
+                 * not a recording's events), then drop the oldest
+                 */
+                COALESCE,
+                /*!
+                 * \brief DROP_OLDEST Drop the oldest streamed data, leaving
+                 * a @c "# GAP <n>" line where it was
+                 */
+                DROP_OLDEST,
+                /*!
+                 * \brief DISCONNECT Close the connection
+                 */
+                DISCONNECT
+            };
             /*!
              * \brief Connection Create a new connection
              *
@@ -41,7 +77,7 @@ namespace cascades
              *
              * @since test-cascades 1.0.0
              */
-            ~Connection();
+            virtual ~Connection();
             /*!
              * \brief close Closes the connection
              *
@@ -62,7 +98,17 @@ namespace cascades
              *
              * @since test-cascades 1.1.0
              */
-            qint64 write(const QString& data);
+            virtual qint64 write(const QString& data);
+            /*!
+             * \brief write Write data that's already encoded, i.e. the
+             * same buffer written to several connections
+             *
+             * \param data The UTF-8 data you wish to send
+             * \return The amount of data sent in bytes
+             *
+             * @since test-cascades 1.1.5
+             */
+            virtual qint64 write(const QByteArray& data);
             /*!
              * \brief flush Flush the socket
              *
@@ -70,7 +116,65 @@ namespace cascades
              *
              * @since test-cascades 1.0.1
              */
-            bool flush(void);
+            virtual bool flush(void);
+            /*!
+             * \brief stream Write data that may be dropped or coalesced
+             * if the client isn't keeping up
+             *
+             * \param data The UTF-8 data, a whole line
+             * \param kind The kind of data
+             * \param replaceable @c true if the newest data of this kind
+             * replaces the rest, so it may be coalesced
+             *
+             * @since test-cascades 1.1.5
+             */
+            void stream(const QByteArray& data,
+                        const QByteArray& kind,
+                        const bool replaceable = false);
+            /*!
+             * \brief setOverflow Set the queue limit and policy
+             *
+             * \param policy What to do when the limit is reached
+             * \param limitBytes The limit
+             *
+             * @since test-cascades 1.1.5
+             */
+            void setOverflow(const OverflowPolicy policy, const qint64 limitBytes)
+            {
+                this->overflowPolicy = policy;
+                this->queueLimit = limitBytes;
+            }
+            /*!
+             * \brief policy The overflow policy
+             *
+             * @since test-cascades 1.1.5
+             */
+            OverflowPolicy policy(void) const
+            {
+                return this->overflowPolicy;
+            }
+            /*!
+             * \brief queueStats The queue's metrics
+             *
+             * \return The metrics as @c name=value pairs
+             *
+             * @since test-cascades 1.1.5
+             */
+            QString queueStats(void) const;
+            /*!
+             * \brief setWholeLines Only pass on complete lines. Commands
+             * that arrive split over several TCP segments are then not
+             * processed in pieces. Telnet clients send characters as
+             * they're typed so need this off.
+             *
+             * \param wholeLines @c true to wait for the end of a line
+             *
+             * @since test-cascades 1.1.5
+             */
+            void setWholeLines(const bool wholeLines)
+            {
+                this->wholeLines = wholeLines;
+            }
 
         signals:
             /*!
@@ -83,11 +187,120 @@ namespace cascades
              */
             void packetReceived(Connection* connection, const QString& packet);
         protected:
+            /*!
+             * \brief Connection Create a connection without a socket, used
+             * by connections that capture what commands write
+             *
+             * \param parent The parent object
+             *
+             * @since test-cascades 1.1.5
+             */
+            explicit Connection(QObject* parent);
         private:
+            /*!
+             * \brief The Outbound struct is some queued data
+             */
+            struct Outbound
+            {
+                /*!
+                 * \brief data The data, empty for a gap
+                 */
+                QByteArray data;
+                /*!
+                 * \brief kind The kind of streamed data, empty for a reply
+                 */
+                QByteArray kind;
+                /*!
+                 * \brief replaceable @c true if newer data of the kind replaces it
+                 */
+                bool replaceable;
+                /*!
+                 * \brief gap The number of lines dropped here
+                 */
+                int gap;
+            };
+            /*!
+             * \brief DEFAULT_LIMIT The default queue limit in bytes
+             */
+            static const qint64 DEFAULT_LIMIT;
+            /*!
+             * \brief SOCKET_HIGH_WATER Data is only given to the socket
+             * while it has less than this to send
+             */
+            static const qint64 SOCKET_HIGH_WATER;
+            /*!
+             * \brief BLOCK_MS The longest blocked writes wait in one event
+             * loop pass
+             */
+            static const int BLOCK_MS;
+            /*!
+             * \brief enqueue Queue data and send what the socket can take
+             *
+             * \param data The data
+             * \param kind The kind of streamed data, empty for a reply
+             * \param replaceable @c true if newer data of the kind replaces it
+             *
+             * @since test-cascades 1.1.5
+             */
+            void enqueue(const QByteArray& data,
+                         const QByteArray& kind,
+                         const bool replaceable);
+            /*!
+             * \brief dropOldest Drop the oldest streamed data, marking the gap
+             *
+             * \return @c false if there's nothing that can be dropped
+             *
+             * @since test-cascades 1.1.5
+             */
+            bool dropOldest(void);
             /*!
              * \brief socket Client socket
              */
             QTcpSocket * const socket;
+            /*!
+             * \brief wholeLines @c true to only pass on complete lines
+             */
+            bool wholeLines;
+            /*!
+             * \brief queue The data not yet given to the socket
+             */
+            QList<Outbound> queue;
+            /*!
+             * \brief queuedBytes The size of the queue
+             */
+            qint64 queuedBytes;
+            /*!
+             * \brief maxQueuedBytes The largest the queue has been
+             */
+            qint64 maxQueuedBytes;
+            /*!
+             * \brief queueLimit Streamed data over this limit overflows
+             */
+            qint64 queueLimit;
+            /*!
+             * \brief overflowPolicy What happens on overflow
+             */
+            OverflowPolicy overflowPolicy;
+            /*!
+             * \brief dropped The number of streamed lines dropped
+             */
+            quint64 dropped;
+            /*!
+             * \brief coalesced The number of streamed lines coalesced
+             */
+            quint64 coalesced;
+            /*!
+             * \brief blockedMs The time spent blocked
+             */
+            qint64 blockedMs;
+            /*!
+             * \brief passBlockedMs The time spent blocked this event loop pass
+             */
+            qint64 passBlockedMs;
+            /*!
+             * \brief passEndQueued @c true if the end of the pass is queued
+             */
+            bool passEndQueued;
         Q_SIGNALS:
             /*!
              * \brief disconnected Signal emitted when the client disconnects
@@ -110,6 +323,20 @@ namespace cascades
              * @since test-cascades 1.0.0
              */
             void processPacket(void);
+            /*!
+             * \brief sendQueued Give the socket as much of the queue as
+             * it can take, called as the socket drains
+             *
+             * @since test-cascades 1.1.5
+             */
+            void sendQueued(void);
+            /*!
+             * \brief passEnded Slot called once the event loop pass that
+             * blocked is over, allowing blocked writes to wait again
+             *
+             * @since test-cascades 1.1.5
+             */
+            void passEnded(void);
             /*!
              * \brief write Write data out on the connection
              *
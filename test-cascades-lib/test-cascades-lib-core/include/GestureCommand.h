@@ -0,0 +1,227 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#ifndef GESTURECOMMAND_H_
+#define GESTURECOMMAND_H_
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QPointF>
+#include <QStringList>
+#include <QTimer>
+
+#include <bb/cascades/TouchType>
+#include <bb/cascades/VisualNode>
+
+#include "Command.h"
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    /*!
+     * \brief The GestureCommand class plays a whole touch gesture
+     * (the @c Down, @c Move samples and @c Up) inside the harness.
+     *
+     * The samples are timed by the harness rather than sent one command
+     * at a time, so scrolling tests don't depend on the network. The
+     * position of each sample is taken from the time since the gesture
+     * started so a late timer changes when a sample is taken but not
+     * the path. The profile depends on the gesture:
+     * - @c swipe speeds up and slows down again before it's released
+     * - @c drag holds still first, then moves and stops before it's released
+     * - @c fling speeds up and is released while it's moving fastest
+     *
+     * @since test-cascades 1.1.5
+     */
+    class GestureCommand : public Command
+    {
+    Q_OBJECT
+    public:
+        /*!
+         * \brief getCmd Return the name of this command
+         *
+         * \return Command name
+         *
+         * @since test-cascades 1.1.5
+         */
+        static QString getCmd()
+        {
+            return CMD_NAME;
+        }
+        /*!
+         * \brief create Create a new instance of this Command
+         *
+         * \param s The TCP socket associated with the client
+         * \param parent The parent object
+         * \return Returns a new instance of the Command
+         *
+         * @since test-cascades 1.1.5
+         */
+        static Command* create(class Connection * const s,
+                               QObject * parent = 0)
+        {
+            return new GestureCommand(s, parent);
+        }
+        /*!
+         * \brief GestureCommand Constructor
+         *
+         * \param socket The TCP socket associated with the client
+         * \param parent The parent object
+         *
+         * @since test-cascades 1.1.5
+         */
+        GestureCommand(class Connection * const socket,
+                       QObject* parent = 0);
+        /*!
+         * \brief ~GestureCommand Destructor
+         *
+         * @since test-cascades 1.1.5
+         */
+        ~GestureCommand();
+        /*
+         * See super
+         */
+        bool executeCommand(QStringList * const arguments);
+        /*
+         * See super
+         */
+        void cleanUp(void)
+        {
+            // a gesture deletes itself when it's released
+            if (not this->playing)
+            {
+                this->deleteLater();
+            }
+        }
+        /*
+         * See super
+         */
+        void showHelp(void);
+    protected:
+    private slots:
+        /*!
+         * \brief sample Send the next sample
+         *
+         * @since test-cascades 1.1.5
+         */
+        void sample(void);
+        /*!
+         * \brief clientDisconnected Slot for the client going away
+         *
+         * @since test-cascades 1.1.5
+         */
+        void clientDisconnected(void);
+    private:
+        /*!
+         * \brief The Profile enum is how the gesture moves over time
+         */
+        enum Profile
+        {
+            /*!
+             * \brief SWIPE Ease in and out
+             */
+            SWIPE,
+            /*!
+             * \brief DRAG Hold, then ease in and out
+             */
+            DRAG,
+            /*!
+             * \brief FLING Ease in, released at full speed
+             */
+            FLING
+        };
+        /*!
+         * \brief progress How far along the path the gesture is
+         *
+         * \param elapsedMs The time since the touch went down
+         *
+         * \return 0 at the start to 1 at the end
+         *
+         * @since test-cascades 1.1.5
+         */
+        double progress(const qint64 elapsedMs) const;
+        /*!
+         * \brief send Send a touch event to the target
+         *
+         * \param type The event type
+         * \param at The position
+         *
+         * \return @c true if the target took it
+         *
+         * @since test-cascades 1.1.5
+         */
+        bool send(const bb::cascades::TouchType::Type type, const QPointF& at);
+        /*!
+         * \brief finish Stop playing and reply
+         *
+         * \param reply The reply, empty to not reply
+         *
+         * @since test-cascades 1.1.5
+         */
+        void finish(const QString& reply);
+        /*!
+         * \brief CMD_NAME The name of this command
+         */
+        static const QString CMD_NAME;
+        /*!
+         * \brief DEFAULT_HZ The samples per second if not given
+         */
+        static const int DEFAULT_HZ;
+        /*!
+         * \brief MAX_HZ The most samples per second
+         */
+        static const int MAX_HZ;
+        /*!
+         * \brief DRAG_HOLD_MS The time a drag holds still before moving
+         */
+        static const int DRAG_HOLD_MS;
+        /*!
+         * \brief client The TCP socket associated with the client
+         */
+        class Connection * const client;
+        /*!
+         * \brief playing @c true until the gesture replies
+         */
+        bool playing;
+        /*!
+         * \brief profile How the gesture moves
+         */
+        Profile profile;
+        /*!
+         * \brief target The object being touched
+         */
+        QPointer<bb::cascades::VisualNode> target;
+        /*!
+         * \brief from Where the touch goes down
+         */
+        QPointF from;
+        /*!
+         * \brief to Where the touch goes up
+         */
+        QPointF to;
+        /*!
+         * \brief durationMs The time from down to up
+         */
+        int durationMs;
+        /*!
+         * \brief moves The number of Move samples sent
+         */
+        int moves;
+        /*!
+         * \brief clock Started when the touch goes down
+         */
+        QElapsedTimer clock;
+        /*!
+         * \brief sampleTimer Takes the samples
+         */
+        QTimer sampleTimer;
+    };
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
+
+#endif  // GESTURECOMMAND_H_
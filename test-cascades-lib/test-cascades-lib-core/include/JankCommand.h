@@ -0,0 +1,105 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#ifndef JANKCOMMAND_H_
+#define JANKCOMMAND_H_
+
+#include <QObject>
+
+#include "Command.h"
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    /*!
+     * \brief The JankCommand class starts and stops the JankMonitor
+     * heartbeat and reports the UI thread stalls it has seen, so a script
+     * can check that a flow never froze the UI for longer than a limit.
+     *
+     * @since test-cascades 1.1.5
+     */
+    class JankCommand : public Command
+    {
+    Q_OBJECT
+    public:
+        /*!
+         * \brief getCmd Return the name of this command
+         *
+         * \return Command name
+         *
+         * @since test-cascades 1.1.5
+         */
+        static QString getCmd()
+        {
+            return CMD_NAME;
+        }
+        /*!
+         * \brief create Create a new instance of this Command
+         *
+         * \param s The TCP socket associated with the client
+         * \param parent The parent object
+         * \return Returns a new instance of the Command
+         *
+         * @since test-cascades 1.1.5
+         */
+        static Command* create(class Connection * const s,
+                               QObject * parent = 0)
+        {
+            return new JankCommand(s, parent);
+        }
+        /*!
+         * \brief JankCommand Constructor
+         *
+         * \param socket The TCP socket associated with the client
+         * \param parent The parent object
+         *
+         * @since test-cascades 1.1.5
+         */
+        JankCommand(class Connection * const socket,
+                    QObject* parent = 0);
+        /*!
+         * \brief ~JankCommand Destructor
+         *
+         * @since test-cascades 1.1.5
+         */
+        ~JankCommand();
+        /*
+         * See super
+         */
+        bool executeCommand(QStringList * const arguments);
+        /*
+         * See super
+         */
+        void showHelp(void);
+    protected:
+    private:
+        /*!
+         * \brief CMD_NAME The name of this command
+         */
+        static const QString CMD_NAME;
+        /*!
+         * \brief MAX_REPLY The longest reply, clients read lines
+         * of up to 1024 bytes
+         */
+        static const int MAX_REPLY;
+        /*!
+         * \brief DEFAULT_INTERVAL_MS The default heartbeat interval
+         */
+        static const int DEFAULT_INTERVAL_MS;
+        /*!
+         * \brief DEFAULT_THRESHOLD_MS The default stall threshold
+         */
+        static const int DEFAULT_THRESHOLD_MS;
+        /*!
+         * \brief client The TCP socket associated with the client
+         */
+        class Connection * const client;
+    };
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
+
+#endif  // JANKCOMMAND_H_
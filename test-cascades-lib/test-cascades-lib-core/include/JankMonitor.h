@@ -0,0 +1,222 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#ifndef JANKMONITOR_H_
+#define JANKMONITOR_H_
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QList>
+#include <QString>
+#include <QTimer>
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    /*!
+     * \brief The JankMonitor class measures how responsive the UI thread
+     * is with a heartbeat timer.
+     *
+     * Every beat measures how late it fired; being late means the event
+     * loop was busy (a stall). Stalls over the threshold are kept (the
+     * worst ones) along with the commands the harness ran during the
+     * stall, or @c app if it was the application's own work. A histogram
+     * of how late every beat was is kept too.
+     *
+     * @since test-cascades 1.1.5
+     */
+    class JankMonitor : public QObject
+    {
+        Q_OBJECT
+        public:
+            /*!
+             * \brief instance Get the monitor
+             *
+             * \return The single instance
+             *
+             * @since test-cascades 1.1.5
+             */
+            static JankMonitor * instance();
+            /*!
+             * \brief ~JankMonitor Destructor
+             *
+             * @since test-cascades 1.1.5
+             */
+            virtual ~JankMonitor();
+            /*!
+             * \brief start Clear the counters and start the heartbeat
+             *
+             * \param intervalMs The time between beats
+             * \param thresholdMs Beats this late are stalls
+             *
+             * @since test-cascades 1.1.5
+             */
+            void start(const int intervalMs, const int thresholdMs);
+            /*!
+             * \brief stop Stop the heartbeat, the counters are kept
+             *
+             * @since test-cascades 1.1.5
+             */
+            void stop(void);
+            /*!
+             * \brief isRunning Is the heartbeat running
+             *
+             * \return @c true if it is
+             *
+             * @since test-cascades 1.1.5
+             */
+            bool isRunning(void) const
+            {
+                return this->timer.isActive();
+            }
+            /*!
+             * \brief reset Clear the counters
+             *
+             * @since test-cascades 1.1.5
+             */
+            void reset(void);
+            /*!
+             * \brief worstMs The longest stall
+             *
+             * \return The time in ms or 0 if there hasn't been a stall
+             *
+             * @since test-cascades 1.1.5
+             */
+            qint64 worstMs(void) const;
+            /*!
+             * \brief maxLateMs The latest beat, whether or not it was
+             * over the threshold
+             *
+             * \return The time in ms
+             *
+             * @since test-cascades 1.1.5
+             */
+            qint64 maxLateMs(void) const
+            {
+                return this->maxLateUs / 1000;
+            }
+            /*!
+             * \brief worstCommand What ran during the longest stall
+             *
+             * \return The command verb, @c app or an empty string
+             *
+             * @since test-cascades 1.1.5
+             */
+            QString worstCommand(void) const;
+            /*!
+             * \brief summary A single line summary of the counters
+             *
+             * \param maxLength Stop adding stalls once the line is this long
+             *
+             * \return The summary, worst stalls first
+             *
+             * @since test-cascades 1.1.5
+             */
+            QString summary(const int maxLength) const;
+        protected:
+        private:
+            /*!
+             * \brief The Stall struct is one late heartbeat
+             */
+            struct Stall
+            {
+                /*!
+                 * \brief lateMs How late the beat was
+                 */
+                qint64 lateMs;
+                /*!
+                 * \brief atMs When the stall ended (ms since start)
+                 */
+                qint64 atMs;
+                /*!
+                 * \brief command The last command run during the stall
+                 */
+                QString command;
+                /*!
+                 * \brief commands The number of commands run during the stall
+                 */
+                quint64 commands;
+            };
+            /*!
+             * \brief BUCKETS The number of power of two histogram buckets
+             */
+            static const int BUCKETS = 32;
+            /*!
+             * \brief MAX_WORST The number of the worst stalls kept
+             */
+            static const int MAX_WORST;
+            /*!
+             * \brief JankMonitor Create the monitor
+             */
+            JankMonitor();
+            /*!
+             * \brief percentileUs The upper bound of the bucket holding
+             * a percentile
+             *
+             * \param percent The percentile (0-100)
+             *
+             * \return The time in microseconds
+             *
+             * @since test-cascades 1.1.5
+             */
+            qint64 percentileUs(const int percent) const;
+            /*!
+             * \brief singleton The single instance
+             */
+            static JankMonitor * singleton;
+            /*!
+             * \brief timer The heartbeat
+             */
+            QTimer timer;
+            /*!
+             * \brief sinceBeat Time since the last beat
+             */
+            QElapsedTimer sinceBeat;
+            /*!
+             * \brief uptime Time since the counters were cleared
+             */
+            QElapsedTimer uptime;
+            /*!
+             * \brief thresholdMs Beats this late are stalls
+             */
+            int thresholdMs;
+            /*!
+             * \brief beats The number of beats
+             */
+            quint64 beats;
+            /*!
+             * \brief stalls The number of stalls
+             */
+            quint64 stalls;
+            /*!
+             * \brief maxLateUs The latest beat
+             */
+            qint64 maxLateUs;
+            /*!
+             * \brief buckets The histogram of how late the beats were
+             */
+            quint64 buckets[BUCKETS];
+            /*!
+             * \brief lastCommandCount The number of commands run at the last beat
+             */
+            quint64 lastCommandCount;
+            /*!
+             * \brief worst The worst stalls, worst first
+             */
+            QList<Stall> worst;
+        private slots:
+            /*!
+             * \brief beat Slot for the heartbeat
+             *
+             * @since test-cascades 1.1.5
+             */
+            void beat(void);
+    };
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
+
+#endif  // JANKMONITOR_H_
@@ -0,0 +1,108 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#ifndef LEAKCOMMAND_H_
+#define LEAKCOMMAND_H_
+
+#include <QObject>
+
+#include "Command.h"
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    /*!
+     * \brief The LeakCommand class reports the QObjects that were created
+     * between @c leak @c begin and @c leak @c end and are still alive, by
+     * class and parent, using the LeakTracker.
+     *
+     * @since test-cascades 1.1.5
+     */
+    class LeakCommand : public Command
+    {
+    Q_OBJECT
+    public:
+        /*!
+         * \brief getCmd Return the name of this command
+         *
+         * \return Command name
+         *
+         * @since test-cascades 1.1.5
+         */
+        static QString getCmd()
+        {
+            return CMD_NAME;
+        }
+        /*!
+         * \brief create Create a new instance of this Command
+         *
+         * \param s The TCP socket associated with the client
+         * \param parent The parent object
+         * \return Returns a new instance of the Command
+         *
+         * @since test-cascades 1.1.5
+         */
+        static Command* create(class Connection * const s,
+                               QObject * parent = 0)
+        {
+            return new LeakCommand(s, parent);
+        }
+        /*!
+         * \brief LeakCommand Constructor
+         *
+         * \param socket The TCP socket associated with the client
+         * \param parent The parent object
+         *
+         * @since test-cascades 1.1.5
+         */
+        LeakCommand(class Connection * const socket,
+                    QObject* parent = 0);
+        /*!
+         * \brief ~LeakCommand Destructor
+         *
+         * @since test-cascades 1.1.5
+         */
+        ~LeakCommand();
+        /*
+         * See super
+         */
+        bool executeCommand(QStringList * const arguments);
+        /*
+         * See super
+         */
+        void showHelp(void);
+    protected:
+    private:
+        /*!
+         * \brief CMD_NAME The name of this command
+         */
+        static const QString CMD_NAME;
+        /*!
+         * \brief MAX_REPLY The longest reply, clients read lines
+         * of up to 1024 bytes
+         */
+        static const int MAX_REPLY;
+        /*!
+         * \brief client The TCP socket associated with the client
+         */
+        class Connection * const client;
+        /*!
+         * \brief survivorList The survivors, most first
+         *
+         * \param length The length of the line so far
+         *
+         * \return The survivors as @c "; class@path=count" entries
+         * that fit on the line
+         *
+         * @since test-cascades 1.1.5
+         */
+        static QString survivorList(const int length);
+    };
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
+
+#endif  // LEAKCOMMAND_H_
@@ -0,0 +1,162 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#ifndef LEAKTRACKER_H_
+#define LEAKTRACKER_H_
+
+#include <QObject>
+#include <QHash>
+#include <QPointer>
+#include <QString>
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    /*!
+     * \brief The LeakTracker class tracks the QObjects created and
+     * destroyed between two points of a test.
+     *
+     * An application wide event filter sees the @c ChildAdded event of
+     * every object created with (or given) a parent on the UI thread and
+     * watches for it to be destroyed. Objects are only half constructed
+     * when the event is sent so their class is read when the survivors are
+     * counted. Objects without a parent aren't seen.
+     *
+     * @since test-cascades 1.1.5
+     */
+    class LeakTracker : public QObject
+    {
+        Q_OBJECT
+        public:
+            /*!
+             * \brief instance Get the tracker
+             *
+             * \return The single instance
+             *
+             * @since test-cascades 1.1.5
+             */
+            static LeakTracker * instance();
+            /*!
+             * \brief ~LeakTracker Destructor
+             *
+             * @since test-cascades 1.1.5
+             */
+            virtual ~LeakTracker();
+            /*!
+             * \brief begin Forget what was tracked and start tracking
+             *
+             * @since test-cascades 1.1.5
+             */
+            void begin(void);
+            /*!
+             * \brief end Stop tracking and count the survivors
+             *
+             * Objects waiting for a deferred delete are deleted first.
+             *
+             * @since test-cascades 1.1.5
+             */
+            void end(void);
+            /*!
+             * \brief isTracking Is the tracker running
+             *
+             * \return @c true between begin and end
+             *
+             * @since test-cascades 1.1.5
+             */
+            bool isTracking(void) const
+            {
+                return this->tracking;
+            }
+            /*!
+             * \brief created The number of objects created since begin
+             *
+             * @since test-cascades 1.1.5
+             */
+            int created(void) const
+            {
+                return this->createdCount;
+            }
+            /*!
+             * \brief destroyed The number of them that were destroyed
+             *
+             * @since test-cascades 1.1.5
+             */
+            int destroyed(void) const
+            {
+                return this->destroyedCount;
+            }
+            /*!
+             * \brief survivors The objects still alive at the end
+             *
+             * \return The number of survivors for each class and
+             * parent path, as @c class@@path
+             *
+             * @since test-cascades 1.1.5
+             */
+            const QHash<QString, int>& survivors(void) const
+            {
+                return this->survivorCounts;
+            }
+            /*
+             * See super
+             */
+            bool eventFilter(QObject * const receiver, QEvent * const event);
+        protected:
+        private:
+            /*!
+             * \brief LeakTracker Create the tracker
+             */
+            LeakTracker();
+            /*!
+             * \brief isHarnessObject Check if an object belongs to the harness
+             *
+             * \param object The object
+             *
+             * \return @c true if it, or a parent, is a command or a connection
+             *
+             * @since test-cascades 1.1.5
+             */
+            bool isHarnessObject(const QObject * object) const;
+            /*!
+             * \brief singleton The single instance
+             */
+            static LeakTracker * singleton;
+            /*!
+             * \brief tracking @c true between begin and end
+             */
+            bool tracking;
+            /*!
+             * \brief createdCount The number of objects created
+             */
+            int createdCount;
+            /*!
+             * \brief destroyedCount The number of created objects destroyed
+             */
+            int destroyedCount;
+            /*!
+             * \brief live The live objects created since begin and the
+             * parent they were created with
+             */
+            QHash<QObject*, QPointer<QObject> > live;
+            /*!
+             * \brief survivorCounts The survivors by class and parent path
+             */
+            QHash<QString, int> survivorCounts;
+        private slots:
+            /*!
+             * \brief objectDestroyed Slot for a tracked object being destroyed
+             *
+             * \param object The object
+             *
+             * @since test-cascades 1.1.5
+             */
+            void objectDestroyed(QObject * object);
+    };
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
+
+#endif  // LEAKTRACKER_H_
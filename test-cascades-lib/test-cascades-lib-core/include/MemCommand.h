@@ -0,0 +1,97 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#ifndef MEMCOMMAND_H_
+#define MEMCOMMAND_H_
+
+#include <QObject>
+
+#include "Command.h"
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    /*!
+     * \brief The MemCommand class samples the memory and QObjects used
+     * by the application, now or on an interval with the MemorySampler,
+     * to find slow leaks in long running (soak) tests.
+     *
+     * @since test-cascades 1.1.5
+     */
+    class MemCommand : public Command
+    {
+    Q_OBJECT
+    public:
+        /*!
+         * \brief getCmd Return the name of this command
+         *
+         * \return Command name
+         *
+         * @since test-cascades 1.1.5
+         */
+        static QString getCmd()
+        {
+            return CMD_NAME;
+        }
+        /*!
+         * \brief create Create a new instance of this Command
+         *
+         * \param s The TCP socket associated with the client
+         * \param parent The parent object
+         * \return Returns a new instance of the Command
+         *
+         * @since test-cascades 1.1.5
+         */
+        static Command* create(class Connection * const s,
+                               QObject * parent = 0)
+        {
+            return new MemCommand(s, parent);
+        }
+        /*!
+         * \brief MemCommand Constructor
+         *
+         * \param socket The TCP socket associated with the client
+         * \param parent The parent object
+         *
+         * @since test-cascades 1.1.5
+         */
+        MemCommand(class Connection * const socket,
+                   QObject* parent = 0);
+        /*!
+         * \brief ~MemCommand Destructor
+         *
+         * @since test-cascades 1.1.5
+         */
+        ~MemCommand();
+        /*
+         * See super
+         */
+        bool executeCommand(QStringList * const arguments);
+        /*
+         * See super
+         */
+        void showHelp(void);
+    protected:
+    private:
+        /*!
+         * \brief CMD_NAME The name of this command
+         */
+        static const QString CMD_NAME;
+        /*!
+         * \brief MAX_REPLY The longest reply, clients read lines
+         * of up to 1024 bytes
+         */
+        static const int MAX_REPLY;
+        /*!
+         * \brief client The TCP socket associated with the client
+         */
+        class Connection * const client;
+    };
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
+
+#endif  // MEMCOMMAND_H_
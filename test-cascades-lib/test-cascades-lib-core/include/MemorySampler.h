@@ -0,0 +1,211 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#ifndef MEMORYSAMPLER_H_
+#define MEMORYSAMPLER_H_
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QString>
+#include <QTimer>
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    class Connection;
+
+    /*!
+     * \brief The MemorySampler class samples the memory used by the
+     * process and the number of live QObjects.
+     *
+     * Each sample has the resident and virtual size (read from
+     * /proc/self/statm, not available on every target), the heap in use
+     * (from mallinfo), the number of QObjects reachable from the
+     * application and the scene, and the number of harness commands run
+     * so far with the last one, so growth can be tied to the test step
+     * that caused it. Samples taken on a timer are kept in a ring and can
+     * be streamed to a client as they are taken.
+     *
+     * @since test-cascades 1.1.5
+     */
+    class MemorySampler : public QObject
+    {
+        Q_OBJECT
+        public:
+            /*!
+             * \brief The Sample struct is one memory sample
+             */
+            struct Sample
+            {
+                /*!
+                 * \brief atMs When it was taken (ms since the sampler started)
+                 */
+                qint64 atMs;
+                /*!
+                 * \brief rssKb The resident size or -1 if it isn't known
+                 */
+                qint64 rssKb;
+                /*!
+                 * \brief vmKb The virtual size or -1 if it isn't known
+                 */
+                qint64 vmKb;
+                /*!
+                 * \brief heapKb The heap allocated by malloc
+                 */
+                qint64 heapKb;
+                /*!
+                 * \brief objects The number of QObjects found
+                 */
+                int objects;
+                /*!
+                 * \brief commands The number of commands run so far
+                 */
+                quint64 commands;
+                /*!
+                 * \brief command The last command run
+                 */
+                QString command;
+            };
+            /*!
+             * \brief instance Get the sampler
+             *
+             * \return The single instance
+             *
+             * @since test-cascades 1.1.5
+             */
+            static MemorySampler * instance();
+            /*!
+             * \brief ~MemorySampler Destructor
+             *
+             * @since test-cascades 1.1.5
+             */
+            virtual ~MemorySampler();
+            /*!
+             * \brief sample Take a sample now, it isn't stored
+             *
+             * \return The sample
+             *
+             * @since test-cascades 1.1.5
+             */
+            Sample sample(void) const;
+            /*!
+             * \brief countObjects Count the live QObjects by class
+             *
+             * \return The number of objects of each class name
+             *
+             * @since test-cascades 1.1.5
+             */
+            static QHash<QString, int> countObjects(void);
+            /*!
+             * \brief start Start sampling
+             *
+             * \param intervalMs The time between samples
+             * \param streamTo Write each sample to this client as well, or
+             * @c NULL to only store them
+             *
+             * @since test-cascades 1.1.5
+             */
+            void start(const int intervalMs, Connection * const streamTo);
+            /*!
+             * \brief stop Stop sampling, the samples are kept
+             *
+             * @since test-cascades 1.1.5
+             */
+            void stop(void);
+            /*!
+             * \brief isRunning Is the sampler running
+             *
+             * \return @c true if it is
+             *
+             * @since test-cascades 1.1.5
+             */
+            bool isRunning(void) const
+            {
+                return this->timer.isActive();
+            }
+            /*!
+             * \brief clear Drop the stored samples
+             *
+             * @since test-cascades 1.1.5
+             */
+            void clear(void);
+            /*!
+             * \brief samples The stored samples, oldest first
+             *
+             * \return The samples
+             *
+             * @since test-cascades 1.1.5
+             */
+            const QList<Sample>& samples(void) const
+            {
+                return this->stored;
+            }
+            /*!
+             * \brief format Format a sample for a reply
+             *
+             * \param sample The sample
+             *
+             * \return The sample as @c name=value pairs
+             *
+             * @since test-cascades 1.1.5
+             */
+            static QString format(const Sample& sample);
+        protected:
+        private:
+            /*!
+             * \brief MAX_SAMPLES The number of samples kept
+             */
+            static const int MAX_SAMPLES;
+            /*!
+             * \brief MemorySampler Create the sampler
+             */
+            MemorySampler();
+            /*!
+             * \brief countObjects Count an object and its children
+             *
+             * \param object The object
+             * \param counts The counts to add to
+             *
+             * @since test-cascades 1.1.5
+             */
+            static void countObjects(const QObject * const object,
+                                     QHash<QString, int> * const counts);
+            /*!
+             * \brief singleton The single instance
+             */
+            static MemorySampler * singleton;
+            /*!
+             * \brief timer The sample timer
+             */
+            QTimer timer;
+            /*!
+             * \brief uptime Time since the sampler was created
+             */
+            QElapsedTimer uptime;
+            /*!
+             * \brief stored The ring of samples
+             */
+            QList<Sample> stored;
+            /*!
+             * \brief stream The client samples are written to
+             */
+            QPointer<Connection> stream;
+        private slots:
+            /*!
+             * \brief sampleTimeout Slot for the sample timer
+             *
+             * @since test-cascades 1.1.5
+             */
+            void sampleTimeout(void);
+    };
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
+
+#endif  // MEMORYSAMPLER_H_
@@ -0,0 +1,238 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#ifndef MONKEYCOMMAND_H_
+#define MONKEYCOMMAND_H_
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QList>
+#include <QStringList>
+#include <QTimer>
+
+#include "Command.h"
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    /*!
+     * \brief The MonkeyCommand class plays random events at the
+     * application from inside the harness.
+     *
+     * Each event picks a visible, enabled object in the scene and plays
+     * a command that suits it (click, key, toggle, dropdown, list tap or
+     * action) through the normal command implementations. The events
+     * come from a seeded generator so the same seed plays the same
+     * events against the same application. Each command can be traced to
+     * the client as a comment so the run can be replayed as a script,
+     * and the run stops if the UI thread stalls.
+     *
+     * @since test-cascades 1.1.5
+     */
+    class MonkeyCommand : public Command
+    {
+    Q_OBJECT
+    public:
+        /*!
+         * \brief getCmd Return the name of this command
+         *
+         * \return Command name
+         *
+         * @since test-cascades 1.1.5
+         */
+        static QString getCmd()
+        {
+            return CMD_NAME;
+        }
+        /*!
+         * \brief create Create a new instance of this Command
+         *
+         * \param s The TCP socket associated with the client
+         * \param parent The parent object
+         * \return Returns a new instance of the Command
+         *
+         * @since test-cascades 1.1.5
+         */
+        static Command* create(class Connection * const s,
+                               QObject * parent = 0)
+        {
+            return new MonkeyCommand(s, parent);
+        }
+        /*!
+         * \brief MonkeyCommand Constructor
+         *
+         * \param socket The TCP socket associated with the client
+         * \param parent The parent object
+         *
+         * @since test-cascades 1.1.5
+         */
+        MonkeyCommand(class Connection * const socket,
+                      QObject* parent = 0);
+        /*!
+         * \brief ~MonkeyCommand Destructor
+         *
+         * @since test-cascades 1.1.5
+         */
+        ~MonkeyCommand();
+        /*
+         * See super
+         */
+        bool executeCommand(QStringList * const arguments);
+        /*
+         * See super
+         */
+        void cleanUp(void)
+        {
+            // the monkey deletes itself when it's finished
+            if (not this->running)
+            {
+                this->deleteLater();
+            }
+        }
+        /*
+         * See super
+         */
+        void showHelp(void);
+        /*!
+         * \brief commandReplied Called with the reply to each event
+         *
+         * \param reply The reply
+         *
+         * @since test-cascades 1.1.5
+         */
+        Q_INVOKABLE void commandReplied(const QString& reply);
+    protected:
+    private slots:
+        /*!
+         * \brief tick Play the events that are due
+         *
+         * @since test-cascades 1.1.5
+         */
+        void tick(void);
+        /*!
+         * \brief clientDisconnected Slot for the client going away
+         *
+         * @since test-cascades 1.1.5
+         */
+        void clientDisconnected(void);
+    private:
+        /*!
+         * \brief random The next number from the seeded generator
+         *
+         * \param range The number of values
+         *
+         * \return 0 to @c range - 1
+         *
+         * @since test-cascades 1.1.5
+         */
+        int random(const int range);
+        /*!
+         * \brief findTargets Find the objects that events can be played at
+         *
+         * \param object The object to search from
+         * \param targets Where to add them
+         *
+         * @since test-cascades 1.1.5
+         */
+        static void findTargets(QObject * const object, QList<QObject*> * const targets);
+        /*!
+         * \brief eventFor Make up a command for a target
+         *
+         * \param target The target
+         *
+         * \return The command line, empty if nothing can be played at it
+         *
+         * @since test-cascades 1.1.5
+         */
+        QString eventFor(QObject * const target);
+        /*!
+         * \brief play Play the next event
+         *
+         * @since test-cascades 1.1.5
+         */
+        void play(void);
+        /*!
+         * \brief finish Stop playing and reply
+         *
+         * \param reply The reply, empty to not reply
+         *
+         * @since test-cascades 1.1.5
+         */
+        void finish(const QString& reply);
+        /*!
+         * \brief CMD_NAME The name of this command
+         */
+        static const QString CMD_NAME;
+        /*!
+         * \brief DEFAULT_STALL_MS The time without a tick that stops the run
+         */
+        static const int DEFAULT_STALL_MS;
+        /*!
+         * \brief MAX_RATE The most events per second
+         */
+        static const int MAX_RATE;
+        /*!
+         * \brief MAX_PER_TICK The most events played to catch up on one tick
+         */
+        static const int MAX_PER_TICK;
+        /*!
+         * \brief client The TCP socket associated with the client
+         */
+        class Connection * const client;
+        /*!
+         * \brief running @c true until the monkey replies
+         */
+        bool running;
+        /*!
+         * \brief trace @c true to send each command to the client
+         */
+        bool trace;
+        /*!
+         * \brief state The generator's state
+         */
+        quint32 state;
+        /*!
+         * \brief events The number of events to play
+         */
+        int events;
+        /*!
+         * \brief rate The events per second
+         */
+        int rate;
+        /*!
+         * \brief stallMs The time without a tick that stops the run
+         */
+        int stallMs;
+        /*!
+         * \brief played The number of events played
+         */
+        int played;
+        /*!
+         * \brief failed The number of events the command refused
+         */
+        int failed;
+        /*!
+         * \brief lastEvent The last command played
+         */
+        QString lastEvent;
+        /*!
+         * \brief clock Started when the run starts
+         */
+        QElapsedTimer clock;
+        /*!
+         * \brief sinceTick The time since the last tick
+         */
+        QElapsedTimer sinceTick;
+        /*!
+         * \brief eventTimer Plays the events
+         */
+        QTimer eventTimer;
+    };
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
+
+#endif  // MONKEYCOMMAND_H_
@@ -0,0 +1,134 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#ifndef OBJECTREGISTRY_H_
+#define OBJECTREGISTRY_H_
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QPointer>
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    /*!
+     * \brief The ObjectRegistry class keeps the live objects of the
+     * classes commands look up often (toasts, system dialogs and prompts,
+     * and action items) so they don't walk the whole object tree.
+     *
+     * The objects that exist when it starts are found with one walk and
+     * after that an application wide event filter sees the @c ChildAdded
+     * event of each new object. The objects are only half constructed then
+     * so their class, and those of the objects under them, are read at the
+     * end of the event loop pass, or by the next lookup if that comes first;
+     * QML builds a tree before parenting its root so only the root's
+     * @c ChildAdded is seen. Deleted objects drop out by themselves. Objects
+     * without a parent aren't seen, but they aren't in the object tree
+     * either so a walk wouldn't find them.
+     *
+     * @since test-cascades 1.1.5
+     */
+    class ObjectRegistry : public QObject
+    {
+        Q_OBJECT
+        public:
+            /*!
+             * \brief instance Get the registry, starting it the first time
+             *
+             * \return The single instance
+             *
+             * @since test-cascades 1.1.5
+             */
+            static ObjectRegistry * instance();
+            /*!
+             * \brief ~ObjectRegistry Destructor
+             *
+             * @since test-cascades 1.1.5
+             */
+            virtual ~ObjectRegistry();
+            /*!
+             * \brief objects The live objects of a class
+             *
+             * \param type The class, one of the registered ones
+             *
+             * \return The objects, in no particular order
+             *
+             * @since test-cascades 1.1.5
+             */
+            QList<QObject*> objects(const QMetaObject& type);
+            /*!
+             * \brief find The first live object of a class with a name
+             *
+             * \param type The class, one of the registered ones
+             * \param name The object name
+             *
+             * \return The object or @c NULL
+             *
+             * @since test-cascades 1.1.5
+             */
+            QObject * find(const QMetaObject& type, const QString& name);
+            /*
+             * See super
+             */
+            bool eventFilter(QObject * const receiver, QEvent * const event);
+        signals:
+            /*!
+             * \brief registered Emitted when a new object is registered
+             *
+             * \param object The object
+             *
+             * @since test-cascades 1.1.5
+             */
+            void registered(QObject * object);
+        protected:
+        private:
+            /*!
+             * \brief ObjectRegistry Create the registry
+             */
+            ObjectRegistry();
+            /*!
+             * \brief add Register an object if it's of a registered class
+             *
+             * \param object The object
+             *
+             * @since test-cascades 1.1.5
+             */
+            void add(QObject * const object);
+            /*!
+             * \brief singleton The single instance
+             */
+            static ObjectRegistry * singleton;
+            /*!
+             * \brief types The registered classes
+             */
+            QList<const QMetaObject*> types;
+            /*!
+             * \brief live The live objects for each class
+             */
+            QHash<const QMetaObject*, QHash<QObject*, QPointer<QObject> > > live;
+            /*!
+             * \brief added Objects added since they were last sorted
+             */
+            QList<QPointer<QObject> > added;
+            /*!
+             * \brief sortQueued @c true if sorting is queued
+             */
+            bool sortQueued;
+        private slots:
+            /*!
+             * \brief sort Register the objects added since the last sort and
+             * the objects under them
+             *
+             * @since test-cascades 1.1.5
+             */
+            void sort(void);
+    };
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
+
+#endif  // OBJECTREGISTRY_H_
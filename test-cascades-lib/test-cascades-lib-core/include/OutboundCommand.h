@@ -0,0 +1,92 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#ifndef OUTBOUNDCOMMAND_H_
+#define OUTBOUNDCOMMAND_H_
+
+#include <QObject>
+
+#include "Command.h"
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    /*!
+     * \brief The OutboundCommand class shows the connection's outbound
+     * queue (depth, drops and time blocked) and sets what happens to
+     * streamed data, i.e. recordings, when a slow client lets it fill.
+     *
+     * @since test-cascades 1.1.5
+     */
+    class OutboundCommand : public Command
+    {
+    Q_OBJECT
+    public:
+        /*!
+         * \brief getCmd Return the name of this command
+         *
+         * \return Command name
+         *
+         * @since test-cascades 1.1.5
+         */
+        static QString getCmd()
+        {
+            return CMD_NAME;
+        }
+        /*!
+         * \brief create Create a new instance of this Command
+         *
+         * \param s The TCP socket associated with the client
+         * \param parent The parent object
+         * \return Returns a new instance of the Command
+         *
+         * @since test-cascades 1.1.5
+         */
+        static Command* create(class Connection * const s,
+                               QObject * parent = 0)
+        {
+            return new OutboundCommand(s, parent);
+        }
+        /*!
+         * \brief OutboundCommand Constructor
+         *
+         * \param socket The TCP socket associated with the client
+         * \param parent The parent object
+         *
+         * @since test-cascades 1.1.5
+         */
+        OutboundCommand(class Connection * const socket,
+                        QObject* parent = 0);
+        /*!
+         * \brief ~OutboundCommand Destructor
+         *
+         * @since test-cascades 1.1.5
+         */
+        ~OutboundCommand();
+        /*
+         * See super
+         */
+        bool executeCommand(QStringList * const arguments);
+        /*
+         * See super
+         */
+        void showHelp(void);
+    protected:
+    private:
+        /*!
+         * \brief CMD_NAME The name of this command
+         */
+        static const QString CMD_NAME;
+        /*!
+         * \brief client The TCP socket associated with the client
+         */
+        class Connection * const client;
+    };
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
+
+#endif  // OUTBOUNDCOMMAND_H_
@@ -0,0 +1,210 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#ifndef PROBECOMMAND_H_
+#define PROBECOMMAND_H_
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QStringList>
+#include <QTimer>
+
+#include "Command.h"
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    /*!
+     * \brief The ProbeCommand class measures how long the application
+     * takes to respond to an action.
+     *
+     * It runs another command (i.e. a click) and times how long it is
+     * until a property of an object has (or no longer has) a value,
+     * replying with the time in microseconds. The property is checked
+     * when its notify signal fires, or on every poll if it doesn't have
+     * one or the object doesn't exist yet; once a notify signal is
+     * connected nothing polls the UI thread being measured.
+     *
+     * @since test-cascades 1.1.5
+     */
+    class ProbeCommand : public Command
+    {
+    Q_OBJECT
+    public:
+        /*!
+         * \brief getCmd Return the name of this command
+         *
+         * \return Command name
+         *
+         * @since test-cascades 1.1.5
+         */
+        static QString getCmd()
+        {
+            return CMD_NAME;
+        }
+        /*!
+         * \brief create Create a new instance of this Command
+         *
+         * \param s The TCP socket associated with the client
+         * \param parent The parent object
+         * \return Returns a new instance of the Command
+         *
+         * @since test-cascades 1.1.5
+         */
+        static Command* create(class Connection * const s,
+                               QObject * parent = 0)
+        {
+            return new ProbeCommand(s, parent);
+        }
+        /*!
+         * \brief ProbeCommand Constructor
+         *
+         * \param socket The TCP socket associated with the client
+         * \param parent The parent object
+         *
+         * @since test-cascades 1.1.5
+         */
+        ProbeCommand(class Connection * const socket,
+                     QObject* parent = 0);
+        /*!
+         * \brief ~ProbeCommand Destructor
+         *
+         * @since test-cascades 1.1.5
+         */
+        ~ProbeCommand();
+        /*
+         * See super
+         */
+        bool executeCommand(QStringList * const arguments);
+        /*
+         * See super
+         */
+        void cleanUp(void)
+        {
+            // a probe deletes itself when it replies
+            if (not this->probing)
+            {
+                this->deleteLater();
+            }
+        }
+        /*
+         * See super
+         */
+        void showHelp(void);
+        /*!
+         * \brief commandReplied Called with the reply to the action
+         *
+         * \param reply The reply
+         *
+         * @since test-cascades 1.1.5
+         */
+        Q_INVOKABLE void commandReplied(const QString& reply);
+    protected:
+    private slots:
+        /*!
+         * \brief check Check if the condition has been met
+         *
+         * @since test-cascades 1.1.5
+         */
+        void check(void);
+        /*!
+         * \brief timedOut Slot for the probe timing out
+         *
+         * @since test-cascades 1.1.5
+         */
+        void timedOut(void);
+        /*!
+         * \brief clientDisconnected Slot for the client going away
+         *
+         * @since test-cascades 1.1.5
+         */
+        void clientDisconnected(void);
+        /*!
+         * \brief objectDestroyed Slot for the object going away, polling
+         * until another is found
+         *
+         * @since test-cascades 1.1.5
+         */
+        void objectDestroyed(void);
+    private:
+        /*!
+         * \brief conditionMet Check the condition
+         *
+         * \param actual Set to the property's value if the object exists
+         *
+         * \return @c true if the object exists and the condition is met
+         *
+         * @since test-cascades 1.1.5
+         */
+        bool conditionMet(QString * const actual);
+        /*!
+         * \brief finish Stop probing and reply
+         *
+         * \param reply The reply, empty to not reply
+         *
+         * @since test-cascades 1.1.5
+         */
+        void finish(const QString& reply);
+        /*!
+         * \brief CMD_NAME The name of this command
+         */
+        static const QString CMD_NAME;
+        /*!
+         * \brief POLL_MS The time between checks without a notify signal
+         */
+        static const int POLL_MS;
+        /*!
+         * \brief client The TCP socket associated with the client
+         */
+        class Connection * const client;
+        /*!
+         * \brief probing @c true until the probe replies
+         */
+        bool probing;
+        /*!
+         * \brief objectName The object to check
+         */
+        QString objectName;
+        /*!
+         * \brief propertyName The property to check
+         */
+        QByteArray propertyName;
+        /*!
+         * \brief expected The value to compare with
+         */
+        QString expected;
+        /*!
+         * \brief equal @c true for @c ==, @c false for @c !=
+         */
+        bool equal;
+        /*!
+         * \brief object The object once it's found
+         */
+        QPointer<QObject> object;
+        /*!
+         * \brief notified @c true if the object's notify signal is connected
+         */
+        bool notified;
+        /*!
+         * \brief clock Started just before the action
+         */
+        QElapsedTimer clock;
+        /*!
+         * \brief pollTimer Checks the condition without a notify signal,
+         * only running until one is connected
+         */
+        QTimer pollTimer;
+        /*!
+         * \brief timeoutTimer Ends the probe
+         */
+        QTimer timeoutTimer;
+    };
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
+
+#endif  // PROBECOMMAND_H_
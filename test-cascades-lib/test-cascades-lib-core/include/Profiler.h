@@ -0,0 +1,176 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <QElapsedTimer>
+#include <QString>
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    /*!
+     * \brief The Profiler class keeps counters of where the harness
+     * spends its time on the UI thread.
+     *
+     * Each command is split into phases (parsing and looking up the
+     * command, finding objects, executing and writing the reply) and
+     * the time of each phase is added up per command verb along with
+     * a histogram of the whole command time. Time spent writing when
+     * no command is running (i.e. async replies) is counted against
+     * the @c async verb. Only work on the UI thread is counted.
+     *
+     * @since test-cascades 1.1.5
+     */
+    class Profiler
+    {
+        public:
+            /*!
+             * \brief The Phase enum lists the parts of a command we time
+             */
+            enum Phase
+            {
+                PARSE = 0,
+                FIND,
+                EXECUTE,
+                WRITE,
+                PHASES
+            };
+            /*!
+             * \brief commandStarted Start timing a new command
+             *
+             * @since test-cascades 1.1.5
+             */
+            static void commandStarted(void);
+            /*!
+             * \brief commandFinished Stop timing the command and add
+             * its times to the counters
+             *
+             * \param verb The command verb, if empty the times are dropped
+             *
+             * @since test-cascades 1.1.5
+             */
+            static void commandFinished(const QString& verb);
+            /*!
+             * \brief record Add time to a phase of the current command
+             *
+             * \param phase The phase
+             * \param ns The time in nanoseconds
+             *
+             * @since test-cascades 1.1.5
+             */
+            static void record(const Phase phase, const qint64 ns);
+            /*!
+             * \brief summary A single line summary of all the counters
+             *
+             * \param maxLength Stop adding verbs once the line is this long
+             *
+             * \return The summary, busiest verbs first
+             *
+             * @since test-cascades 1.1.5
+             */
+            static QString summary(const int maxLength);
+            /*!
+             * \brief detail The counters and histogram for one verb
+             *
+             * \param verb The command verb
+             *
+             * \return The detail or a null string if the verb hasn't run
+             *
+             * @since test-cascades 1.1.5
+             */
+            static QString detail(const QString& verb);
+            /*!
+             * \brief reset Clear all the counters
+             *
+             * @since test-cascades 1.1.5
+             */
+            static void reset(void);
+            /*!
+             * \brief commandCount The number of commands run
+             *
+             * \return The number of commands since the counters were reset
+             *
+             * @since test-cascades 1.1.5
+             */
+            static quint64 commandCount(void);
+            /*!
+             * \brief lastCommand The verb of the last command run
+             *
+             * \return The verb or an empty string if none has run
+             *
+             * @since test-cascades 1.1.5
+             */
+            static QString lastCommand(void);
+        protected:
+        private:
+            /*!
+             * \brief Profiler Not created, everything is static
+             */
+            Profiler();
+    };
+
+    /*!
+     * \brief The ProfilerScope class times a phase for as long as it
+     * is in scope.
+     *
+     * Scopes nest; time spent in an inner scope of a different phase
+     * isn't counted by the outer scope so, for example, execution time
+     * doesn't include the time taken finding objects. An inner scope of
+     * the same phase (i.e. a recursive search) is left to the outer one.
+     *
+     * @since test-cascades 1.1.5
+     */
+    class ProfilerScope
+    {
+        public:
+            /*!
+             * \brief ProfilerScope Start timing a phase
+             *
+             * \param phase The phase
+             *
+             * @since test-cascades 1.1.5
+             */
+            explicit ProfilerScope(const Profiler::Phase phase);
+            /*!
+             * \brief ~ProfilerScope Stop timing and record the phase
+             *
+             * @since test-cascades 1.1.5
+             */
+            ~ProfilerScope();
+        protected:
+        private:
+            /*!
+             * \brief innermost The innermost active scope
+             */
+            static ProfilerScope * innermost;
+            /*!
+             * \brief phase The phase being timed
+             */
+            const Profiler::Phase phase;
+            /*!
+             * \brief outer The scope this one is nested in
+             */
+            ProfilerScope * const outer;
+            /*!
+             * \brief active @c false if the outer scope is timing this phase
+             */
+            const bool active;
+            /*!
+             * \brief timer Times the scope
+             */
+            QElapsedTimer timer;
+            /*!
+             * \brief nestedNs Time spent in nested scopes
+             */
+            qint64 nestedNs;
+    };
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
+
+#endif  // PROFILER_H_
@@ -0,0 +1,79 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#ifndef PROPERTYCACHE_H_
+#define PROPERTYCACHE_H_
+
+#include <QByteArray>
+#include <QHash>
+#include <QMetaProperty>
+#include <QObject>
+#include <QPair>
+#include <QVariant>
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    /*!
+     * \brief The PropertyCache class remembers where a property is in a
+     * meta object so repeated reads don't search the properties by name.
+     *
+     * The index is cached for each meta object and name and checked
+     * against the name when it's used, as a deleted QML object's meta
+     * object may be replaced by another at the same address. The
+     * returned QMetaProperty has the notify signal for features that
+     * watch the property.
+     *
+     * @since test-cascades 1.1.5
+     */
+    class PropertyCache
+    {
+        public:
+            /*!
+             * \brief property Find a property of an object
+             *
+             * \param object The object
+             * \param name The property name
+             *
+             * \return The property, not valid if the meta object doesn't
+             * have it (it may still be a dynamic property)
+             *
+             * @since test-cascades 1.1.5
+             */
+            static QMetaProperty property(const QObject * const object, const char * const name);
+            /*!
+             * \brief read Read a property of an object
+             *
+             * \param object The object
+             * \param name The property name
+             *
+             * \return The value, as QObject::property would return it
+             *
+             * @since test-cascades 1.1.5
+             */
+            static QVariant read(const QObject * const object, const char * const name);
+        protected:
+        private:
+            /*!
+             * \brief PropertyCache Not created, everything is static
+             */
+            PropertyCache();
+            /*!
+             * \brief MAX_ENTRIES The most entries before the cache is
+             * emptied, QML objects can have a meta object each
+             */
+            static const int MAX_ENTRIES;
+            /*!
+             * \brief indexes The property index for each meta object and
+             * name, -1 if it doesn't have it
+             */
+            static QHash<QPair<const QMetaObject*, QByteArray>, int> indexes;
+    };
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
+
+#endif  // PROPERTYCACHE_H_
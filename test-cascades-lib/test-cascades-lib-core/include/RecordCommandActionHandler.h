@@ -6,7 +6,7 @@
 
 #include <bb/cascades/AbstractActionItem>
 
-#include "RecordCommand.h"
+#include "Recorder.h"
 
 namespace truphone
 {
@@ -20,7 +20,7 @@ namespace cascades
      *
      * @since test-cascades 1.0.0
      */
-    class RecordCommandActionHandler : public RecordCommand::RecordCommandHandler
+    class RecordCommandActionHandler : public Recorder::RecordCommandHandler
     {
     Q_OBJECT
     public:
@@ -35,7 +35,7 @@ namespace cascades
          * @since test-cascades 1.0.0
          */
         RecordCommandActionHandler(
-                RecordCommand * const recorder,
+                Recorder * const recorder,
                 bb::cascades::AbstractActionItem * const action,
                 QObject * parent = 0)
             : RecordCommandHandler(parent),
@@ -72,7 +72,7 @@ namespace cascades
         /*!
          * \brief recorder Our parent recorder
          */
-        RecordCommand * const recorder;
+        Recorder * const recorder;
         /*!
          * \brief action The action that we're listening to
          */
@@ -8,7 +8,7 @@
 #include <bb/cascades/DropDown>
 #include <bb/cascades/Option>
 
-#include "RecordCommand.h"
+#include "Recorder.h"
 
 namespace truphone
 {
@@ -22,7 +22,7 @@ namespace cascades
      *
      * @since test-cascades 1.0.0
      */
-    class RecordCommandDropDownHandler : public RecordCommand::RecordCommandHandler
+    class RecordCommandDropDownHandler : public Recorder::RecordCommandHandler
     {
         Q_OBJECT
         public:
@@ -35,7 +35,7 @@ namespace cascades
              *
              * @since test-cascades 1.0.0
              */
-            RecordCommandDropDownHandler(RecordCommand * const recorder,
+            RecordCommandDropDownHandler(Recorder * const recorder,
                                          bb::cascades::DropDown * const dropDown,
                                          QObject * parent = 0):
                 RecordCommandHandler(parent),
@@ -61,7 +61,7 @@ namespace cascades
             /*!
              * \brief recorder The recorder to notify
              */
-            RecordCommand * const recorder;
+            Recorder * const recorder;
             /*!
              * \brief dropDown The drop down list we're listening to
              */
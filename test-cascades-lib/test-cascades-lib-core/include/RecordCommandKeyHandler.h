@@ -10,7 +10,7 @@
 #include <bb/cascades/Control>
 #include <bb/cascades/UIObject>
 
-#include "RecordCommand.h"
+#include "Recorder.h"
 
 namespace truphone
 {
@@ -24,7 +24,7 @@ namespace cascades
      *
      * @since test-cascades 1.0.0
      */
-    class RecordCommandKeyHandler : public RecordCommand::RecordCommandHandler
+    class RecordCommandKeyHandler : public Recorder::RecordCommandHandler
     {
         Q_OBJECT
         public:
@@ -37,7 +37,7 @@ namespace cascades
              *
              * @since test-cascades 1.0.0
              */
-            RecordCommandKeyHandler(RecordCommand * const recorder,
+            RecordCommandKeyHandler(Recorder * const recorder,
                                     bb::cascades::UIObject * const receiver,
                                     QObject * parent = 0):
                 RecordCommandHandler(parent),
@@ -85,7 +85,7 @@ namespace cascades
             /*!
              * \brief recorder The recorder to notify
              */
-            RecordCommand * const recorder;
+            Recorder * const recorder;
             /*!
              * \brief keyHandler The key handler we create to bind to the object
              */
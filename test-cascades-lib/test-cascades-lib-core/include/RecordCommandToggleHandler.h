@@ -7,7 +7,7 @@
 #include <QObject>
 #include <bb/cascades/AbstractToggleButton>
 
-#include "RecordCommand.h"
+#include "Recorder.h"
 
 namespace truphone
 {
@@ -21,7 +21,7 @@ namespace cascades
      *
      * @since test-cascades 1.0.0
      */
-    class RecordCommandToggleHandler : public RecordCommand::RecordCommandHandler
+    class RecordCommandToggleHandler : public Recorder::RecordCommandHandler
     {
         Q_OBJECT
         public:
@@ -34,7 +34,7 @@ namespace cascades
              *
              * @since test-cascades 1.0.0
              */
-            RecordCommandToggleHandler(RecordCommand * const recorder,
+            RecordCommandToggleHandler(Recorder * const recorder,
                                        bb::cascades::AbstractToggleButton * const button,
                                        QObject * parent = 0):
                 RecordCommandHandler(parent),
@@ -58,7 +58,7 @@ namespace cascades
             /*!
              * \brief recorder The recorder to notify
              */
-            RecordCommand * const recorder;
+            Recorder * const recorder;
             /*!
              * \brief button The button we're listening to
              */
@@ -7,7 +7,7 @@
 #include <QObject>
 #include <bb/cascades/TouchEvent>
 
-#include "RecordCommand.h"
+#include "Recorder.h"
 
 namespace truphone
 {
@@ -20,7 +20,7 @@ namespace cascades
      *
      * @since test-cascades 1.0.0
      */
-    class RecordCommandTouchHandler : public RecordCommand::RecordCommandHandler
+    class RecordCommandTouchHandler : public Recorder::RecordCommandHandler
     {
         Q_OBJECT
         public:
@@ -33,7 +33,7 @@ namespace cascades
              *
              * @since test-cascades 1.0.0
              */
-            RecordCommandTouchHandler(RecordCommand * const recorder,
+            RecordCommandTouchHandler(Recorder * const recorder,
                                       QObject * const receiver,
                                       QObject * parent = 0):
                 RecordCommandHandler(parent),
@@ -57,7 +57,7 @@ namespace cascades
             /*!
              * \brief recorder The recorder to notify
              */
-            RecordCommand * const recorder;
+            Recorder * const recorder;
             /*!
              * \brief receiver The receiver of the events
              */
@@ -0,0 +1,355 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#ifndef RECORDER_H_
+#define RECORDER_H_
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QTime>
+#include <bb/cascades/Application>
+#include <bb/cascades/KeyListener>
+#include <bb/cascades/Page>
+#include <bb/cascades/TouchEvent>
+#include <bb/cascades/AbstractToggleButton>
+#include <bb/cascades/DropDown>
+#include <bb/cascades/Option>
+#include <bb/cascades/Tab>
+#include <bb/system/SystemToast>
+#include <bb/system/SystemUiResult>
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    class Connection;
+    class RecordCommandKeyHandler;
+    class RecordCommandTouchHandler;
+    class RecordCommandActionHandler;
+    class RecordCommandToggleHandler;
+    class RecordCommandDropDownHandler;
+    /*!
+     * \brief The Recorder class monitors the events on the phone and
+     * sends them to every client that has subscribed with @c record so
+     * they can be replayed later on.
+     *
+     * There's one recorder however many clients are recording (a CLI
+     * writing a script, a dashboard, a log). Each event is formatted and
+     * encoded once and the same buffer is written to every subscriber.
+     * The recorder stops when the last subscriber leaves.
+     *
+     * @since test-cascades 1.1.5
+     */
+    class Recorder : public QObject
+    {
+    Q_OBJECT
+    public:
+        /*!
+         * \brief The RecordCommandHandler class is the base class
+         * for all record command handlers/listeners
+         *
+         * @since test-cascades 1.0.0
+         */
+        class RecordCommandHandler : public QObject
+        {
+            protected:
+            /*!
+             * \brief RecordCommandHandler
+             *
+             * \param parent
+             *
+             * @since test-cascades 1.0.0
+             */
+            explicit RecordCommandHandler(QObject * parent = 0 )
+                : QObject(parent) {}
+            /*!
+             * \brief ~RecordCommandHandler Destructor
+             *
+             *@since test-cascades 1.0.0
+             */
+            ~RecordCommandHandler() {}
+        };
+
+        /*!
+         * \brief ~Recorder Destructor
+         *
+         * @since test-cascades 1.1.5
+         */
+        ~Recorder();
+        /*!
+         * \brief subscribe Send the events to a client, starting the
+         * recorder if it isn't running
+         *
+         * \param client The client
+         *
+         * @since test-cascades 1.1.5
+         */
+        static void subscribe(Connection * const client);
+        /*!
+         * \brief unsubscribe Stop sending the events to a client, the
+         * recorder stops if it was the last one
+         *
+         * \param client The client
+         *
+         * \return @c true if the client was subscribed
+         *
+         * @since test-cascades 1.1.5
+         */
+        static bool unsubscribe(Connection * const client);
+        /*!
+         * \brief stop Stop the recorder for every subscriber
+         *
+         * \return @c true if the recorder was running
+         *
+         * @since test-cascades 1.1.5
+         */
+        static bool stop(void);
+        /*!
+         * \brief eventFilter Used to work out when new objects are added
+         * or removed from the scene. We use this to install our listeners.
+         *
+         * \param receiver The object that receives the event
+         * \param event The event, includes the target for the event
+         * \return @c true if we filter it out, @c if we leave it to happen.
+         * Because we're transparent and just using it for hooking into things
+         * we always return @c false
+         *
+         * @since test-cascades 1.0.0
+         */
+        bool eventFilter(QObject * const receiver, QEvent * const event);
+        /*!
+         * \brief touched Call-back called from a listener. Used to write out
+         * the event details to the subscribers
+         *
+         * \param receiver The receiver of the event
+         * \param event The event that occured
+         *
+         * @since test-cascades 1.0.0
+         */
+        void touched(const QObject * const receiver,
+                     const bb::cascades::TouchEvent * const event);
+        /*!
+         * \brief keyed Call-back called from a listener. Used to write out
+         * the event details to the subscribers
+         *
+         * \param receiver The receiver of the event
+         * \param event The event that occured
+         *
+         * @since test-cascades 1.0.0
+         */
+        void keyed(const QObject * const receiver,
+                   const bb::cascades::KeyEvent * const event);
+        /*!
+         * \brief toggled Call-back called from a listener. Used to write out
+         * the event details to the subscribers
+         *
+         * \param button The ToggleButton that changed
+         * \param newState The new state of the button
+         *
+         * @since test-cascades 1.0.0
+         */
+         void toggled(const bb::cascades::AbstractToggleButton * const button,
+                      const bool newState);
+        /*!
+         * \brief dropDownChanged Call-back called from a listener. Used to write out
+         * the event details to the subscribers
+         *
+         * \param dropDown The drop down list that changed
+         * \param option The new option that was selected
+         *
+         * @since test-cascades 1.0.0
+         */
+         void dropDownChanged(
+                const bb::cascades::DropDown * const dropDown,
+                const bb::cascades::Option* const option);
+        /*!
+         * \brief actionExecuted Call-back called from a listener. Used to write out
+         * the event details to the subscribers
+         *
+         * \param action The action that was performed
+         *
+         * @since test-cascades 1.0.0
+         */
+        void actionExecuted(bb::cascades::AbstractActionItem * action);
+    private slots:
+        /*!
+         * \brief subscriberDisconnected Slot for a subscriber going away
+         *
+         * \param client The client
+         *
+         * @since test-cascades 1.1.5
+         */
+        void subscriberDisconnected(Connection * const client);
+        /*!
+         * \brief tabChanged Slot for when tabs change
+         *
+         * \param tab The new tab
+         *
+         * @since test-cascades 1.0.0
+         */
+        void tabChanged(bb::cascades::Tab* tab);
+        /*!
+         * \brief onPopFinished Slot for when a Page is popped from a NavigationPane
+         *
+         * \param page The page that was popped from the pane
+         *
+         * @since test-cascades 1.0.0
+         */
+        void onPopFinished(bb::cascades::Page* page);
+        /*!
+         * \brief toastStarted Slot for when a new toast is opened
+         *
+         * \param text The text for the toast
+         *
+         * @since test-cascades 1.0.0
+         */
+        void toastStarted(const QString& text);
+        /*!
+         * \brief toastEnded Slot for when a toast is removed/finished
+         *
+         * \param result The result of the toast
+         *
+         * @since test-cascades 1.0.0
+         */
+        void toastEnded(bb::system::SystemUiResult::Type result);
+    private:
+        /*!
+         * \brief The Subscriber struct is a client receiving the events
+         */
+        struct Subscriber
+        {
+            /*!
+             * \brief client The client, cleared if it's deleted
+             */
+            QPointer<Connection> client;
+            /*!
+             * \brief sinceEvent Time since its last event, for its sleeps
+             */
+            QElapsedTimer sinceEvent;
+        };
+        /*!
+         * \brief Recorder Start recording
+         *
+         * @since test-cascades 1.1.5
+         */
+        Recorder();
+        /*!
+         * \brief subscribers The clients receiving the events
+         */
+        QList<Subscriber> subscribers;
+        /*!
+         * \brief lastEventTime The time at which the last event occured. Used
+         * to record how long the user takes between commands and these are written
+         * out as sleep commands.
+         */
+        QTime lastEventTime;
+        /*!
+         * \brief lastReceiver The last object to receive an event
+         */
+        const QObject * lastReceiver;
+        /*!
+         * \brief lastTarget The last object to be be the target of the event
+         */
+        QObject * lastTarget;
+        /*!
+         * \brief lastTouchType The last kind of touch event
+         */
+        bb::cascades::TouchType::Type lastTouchType;
+        /*!
+         * \brief ignoreEvents Should we ignore events? Used to stop
+         * recursion when objects are added
+         */
+        bool ignoreEvents;
+        /*!
+         * \brief ctrlAndShiftPressed Used with CTRL+SHIFT
+         * to not record events whilst we're clicking on things which instead
+         * writes out test commands.
+         */
+        bool ctrlAndShiftPressed;
+        /*!
+         * \brief keyListeners Hash of all the objects that have a key listener
+         */
+        QHash<QObject*const, RecordCommandKeyHandler*> keyListeners;
+        /*!
+         * \brief touchListeners Hash of all the objects that have a touch listener
+         */
+        QHash<QObject*const, RecordCommandTouchHandler*> touchListeners;
+        /*!
+         * \brief actionListeners Hash of all the objects that have an action listener
+         */
+        QHash<QObject*const, RecordCommandActionHandler*> actionListeners;
+        /*!
+         * \brief toggleListeners Hash of all the objects that have a toggle listener
+         */
+        QHash<QObject*const, RecordCommandToggleHandler*> toggleListeners;
+        /*!
+         * \brief dropDownListeners Hash of all the objects that have a drop down listener
+         */
+        QHash<QObject*const, RecordCommandDropDownHandler*> dropDownListeners;
+        /*!
+         * \brief connectedPanes A hash of all the panes that we have a connection to
+         */
+        QHash<const bb::cascades::AbstractPane*const, QBool> connectedPanes;
+        /*!
+         * \brief connectedToasts A hash of all the System Toasts we have a connection to
+         */
+        QHash<const bb::system::SystemToast*const, QBool> connectedToasts;
+        /*!
+         * \brief instance The recorder, @c NULL if nothing's recording
+         */
+        static Recorder * instance;
+
+        /*!
+         * \brief addListenersToUiObjects When objects are added (or at startup) we need to
+         * add listeners to objects.
+         *
+         * \param obj The object we want to add listeners to
+         * \param childrenToo If @c true, listeners will be added all the children of @c obj
+         * \param callLevel The current call level
+         * \param maxCallLevel The maximum call level
+         *
+         * @since test-cascades 1.0.0
+         */
+        void addListenersToUiObjects(QObject * const obj,
+                                     const bool childrenToo,
+                                     const size_t callLevel = 0,
+                                     const size_t maxCallLevel = 50);
+
+        /*!
+         * \brief updateSleepValue Update the time being used since the last
+         * event, the sleeps are written by publish for each subscriber
+         *
+         * \return The time, in milliseconds, since the last event occured
+         *
+         * @since test-cascades 1.0.0
+         */
+        int updateSleepValue();
+
+        /*!
+         * \brief publish Send an event to all the subscribers, each one
+         * gets a sleep first if it's been long enough since its last event
+         *
+         * \param event The event line, encoded once for all of them
+         *
+         * @since test-cascades 1.1.5
+         */
+        void publish(const QString& event);
+
+        /*!
+         * \brief testObjectProperties Called when we want to dump test
+         * commands for all the properties of the current object
+         *
+         * @since test-cascades 1.0.0
+         */
+        void testObjectProperties(const QObject * const);
+    };
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
+
+#endif  // RECORDER_H_
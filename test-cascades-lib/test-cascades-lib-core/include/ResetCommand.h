@@ -0,0 +1,118 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#ifndef RESETCOMMAND_H_
+#define RESETCOMMAND_H_
+
+#include <QObject>
+#include <bb/cascades/AbstractPane>
+
+#include "Command.h"
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    /*!
+     * \brief The ResetCommand class puts the application back into a
+     * known state so another script can run on the same connection.
+     * It removes all the spies, stops recording for this client, pops
+     * every navigation pane back to its first page and clears the list
+     * selections.
+     *
+     * @since test-cascades 1.1.5
+     */
+    class ResetCommand : public Command
+    {
+    Q_OBJECT
+    public:
+        /*!
+         * \brief getCmd Return the name of this command
+         *
+         * \return Command name
+         *
+         * @since test-cascades 1.1.5
+         */
+        static QString getCmd()
+        {
+            return CMD_NAME;
+        }
+        /*!
+         * \brief create Create a new instance of this Command
+         *
+         * \param s The TCP socket associated with the client
+         * \param parent The parent object
+         * \return Returns a new instance of the Command
+         *
+         * @since test-cascades 1.1.5
+         */
+        static Command* create(class Connection * const s,
+                               QObject * parent = 0)
+        {
+            return new ResetCommand(s, parent);
+        }
+        /*!
+         * \brief ResetCommand Constructor
+         *
+         * \param socket The TCP socket associated with the client
+         * \param parent The parent object
+         *
+         * @since test-cascades 1.1.5
+         */
+        ResetCommand(class Connection * const socket,
+                     QObject* parent = 0);
+        /*!
+         * \brief ~ResetCommand Destructor
+         *
+         * @since test-cascades 1.1.5
+         */
+        ~ResetCommand();
+        /*
+         * See super
+         */
+        bool executeCommand(QStringList * const arguments);
+        /*
+         * See super
+         */
+        void showHelp(void);
+    protected:
+        /*!
+         * \brief popToRoot Pop every navigation pane under @c pane back
+         * to its first page, including the panes in every tab
+         *
+         * \param pane The pane to start from
+         * \param callLevel The current recursive call level
+         * \param maxCallLevel The maximum recursive call level
+         * \return The number of pages popped
+         *
+         * @since test-cascades 1.1.5
+         */
+        static int popToRoot(bb::cascades::AbstractPane * const pane,
+                             const size_t callLevel = 0,
+                             const size_t maxCallLevel = 100);
+        /*!
+         * \brief clearListSelections Clear the selection of every list
+         * and leave multi-select mode
+         *
+         * \return The number of lists
+         *
+         * @since test-cascades 1.1.5
+         */
+        static int clearListSelections(void);
+    private:
+        /*!
+         * \brief CMD_NAME The name of this command
+         */
+        static const QString CMD_NAME;
+        /*!
+         * \brief client The TCP socket associated with the client
+         */
+        class Connection * const client;
+    };
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
+
+#endif  // RESETCOMMAND_H_
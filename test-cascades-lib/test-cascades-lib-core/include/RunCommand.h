@@ -0,0 +1,274 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#ifndef RUNCOMMAND_H_
+#define RUNCOMMAND_H_
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QStringList>
+#include <QElapsedTimer>
+
+#include "Command.h"
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    /*!
+     * \brief The RunCommand class plays a whole script inside the
+     * harness so the time between commands doesn't include a round
+     * trip to the client.
+     *
+     * Scripts are uploaded a line at a time by name and kept until
+     * they're cleared so they can be run again. The script lines
+     * are the same as the CLI's: commands, comments, @c call of
+     * another uploaded script and the @c retry, @c retry-interval,
+     * @c retry-max-intervals and @c failure-ok cli-settings (others
+     * are ignored). Every command's result is written back as it
+     * finishes:
+     *
+     * @code
+     * RUN <script>:<line> RETRY <retry> <attemptUs> <reply>
+     * RUN <script>:<line> DONE <retries> <attemptUs> <durationUs> <pass|fail|accepted> <reply>
+     * @endcode
+     *
+     * followed by @c OK or, if a command failed, an @c ERROR.
+     *
+     * @since test-cascades 1.1.5
+     */
+    class RunCommand : public Command
+    {
+    Q_OBJECT
+    public:
+        /*!
+         * \brief getCmd Return the name of this command
+         *
+         * \return Command name
+         *
+         * @since test-cascades 1.1.5
+         */
+        static QString getCmd()
+        {
+            return CMD_NAME;
+        }
+        /*!
+         * \brief create Create a new instance of this Command
+         *
+         * \param s The TCP socket associated with the client
+         * \param parent The parent object
+         * \return Returns a new instance of the Command
+         *
+         * @since test-cascades 1.1.5
+         */
+        static Command* create(class Connection * const s,
+                               QObject * parent = 0)
+        {
+            return new RunCommand(s, parent);
+        }
+        /*!
+         * \brief RunCommand Constructor
+         *
+         * \param socket The TCP socket associated with the client
+         * \param parent The parent object
+         *
+         * @since test-cascades 1.1.5
+         */
+        RunCommand(class Connection * const socket,
+                   QObject* parent = 0);
+        /*!
+         * \brief ~RunCommand Destructor
+         *
+         * @since test-cascades 1.1.5
+         */
+        ~RunCommand();
+        /*
+         * See super
+         */
+        bool executeCommand(QStringList * const arguments);
+        /*
+         * See super
+         */
+        void cleanUp(void)
+        {
+            // a running script deletes itself when it finishes
+            if (not this->running)
+            {
+                this->deleteLater();
+            }
+        }
+        /*
+         * See super
+         */
+        void showHelp(void);
+        /*!
+         * \brief commandReplied Called with the reply to the command
+         * being played
+         *
+         * \param reply The reply
+         *
+         * @since test-cascades 1.1.5
+         */
+        Q_INVOKABLE void commandReplied(const QString& reply);
+    protected slots:
+        /*!
+         * \brief playNext Play the script up to the next command and send it
+         *
+         * @since test-cascades 1.1.5
+         */
+        void playNext();
+        /*!
+         * \brief sendCommand Send the current command (again)
+         *
+         * @since test-cascades 1.1.5
+         */
+        void sendCommand();
+        /*!
+         * \brief handleReply Act on the reply to the current command
+         *
+         * @since test-cascades 1.1.5
+         */
+        void handleReply();
+        /*!
+         * \brief clientDisconnected Stop when the client goes away
+         *
+         * @since test-cascades 1.1.5
+         */
+        void clientDisconnected();
+    private:
+        /*!
+         * \brief The RunFrame struct is a script being played
+         */
+        struct RunFrame
+        {
+            /*!
+             * \brief name The script name
+             */
+            QString name;
+            /*!
+             * \brief lines The script
+             */
+            QStringList lines;
+            /*!
+             * \brief next The index of the next line to play
+             */
+            int next;
+        };
+        /*!
+         * \brief CMD_NAME The name of this command
+         */
+        static const QString CMD_NAME;
+        /*!
+         * \brief MAX_CALL_DEPTH How deep calls can be nested
+         */
+        static const int MAX_CALL_DEPTH;
+        /*!
+         * \brief MAX_REPLY The longest command reply passed on, clients
+         * read lines of up to 1024 bytes
+         */
+        static const int MAX_REPLY;
+        /*!
+         * \brief scripts The uploaded scripts keyed by name
+         */
+        static QHash<QString, QStringList> scripts;
+        /*!
+         * \brief client The TCP socket associated with the client
+         */
+        class Connection * const client;
+        /*!
+         * \brief running @c true while a script is playing
+         */
+        bool running;
+        /*!
+         * \brief frames The scripts being played, the called one last
+         */
+        QList<RunFrame> frames;
+        /*!
+         * \brief retry @c true to retry failed commands
+         */
+        bool retry;
+        /*!
+         * \brief retryInterval The ms between retries
+         */
+        int retryInterval;
+        /*!
+         * \brief retryMaxIntervals The number of retries
+         */
+        int retryMaxIntervals;
+        /*!
+         * \brief failureOk @c true to carry on after a failure
+         */
+        bool failureOk;
+        /*!
+         * \brief commandId The script and line of the current command
+         */
+        QString commandId;
+        /*!
+         * \brief commandLine The current command
+         */
+        QString commandLine;
+        /*!
+         * \brief retries The retries of the current command
+         */
+        int retries;
+        /*!
+         * \brief reply The reply to the current command
+         */
+        QString reply;
+        /*!
+         * \brief commandTimer Times the current command
+         */
+        QElapsedTimer commandTimer;
+        /*!
+         * \brief attemptTimer Times the current attempt
+         */
+        QElapsedTimer attemptTimer;
+        /*!
+         * \brief commands The number of commands played
+         */
+        int commands;
+        /*!
+         * \brief start Start playing a script
+         *
+         * \param name The name to report the lines with
+         * \param lines The script
+         *
+         * @since test-cascades 1.1.5
+         */
+        void start(const QString& name, const QStringList& lines);
+        /*!
+         * \brief applySetting Apply a cli-setting line
+         *
+         * \param tokens The line split on spaces
+         *
+         * \return @c true if the setting was valid
+         *
+         * @since test-cascades 1.1.5
+         */
+        bool applySetting(const QStringList& tokens);
+        /*!
+         * \brief writeDone Write the result of the current command
+         *
+         * \param verdict @c pass, @c fail or @c accepted
+         * \param attemptUs The time of the last attempt
+         *
+         * @since test-cascades 1.1.5
+         */
+        void writeDone(const QString& verdict, const qint64 attemptUs);
+        /*!
+         * \brief finish Stop playing and send the final reply
+         *
+         * \param finalReply The reply to the run command
+         *
+         * @since test-cascades 1.1.5
+         */
+        void finish(const QString& finalReply);
+    };
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
+
+#endif  // RUNCOMMAND_H_
@@ -0,0 +1,82 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#ifndef RUNCONNECTION_H_
+#define RUNCONNECTION_H_
+
+#include <QPointer>
+#include <QString>
+
+#include "Connection.h"
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    /*!
+     * \brief The RunConnection class is the connection given to commands
+     * played by the @c run (or @c probe) command. Rather than sending what
+     * the command writes to a client it captures the command's reply (the
+     * first line starting with @c OK or @c ERROR) and hands it to the
+     * runner's invokable @c commandReplied(QString). Anything else the
+     * command writes is dropped.
+     *
+     * @since test-cascades 1.1.5
+     */
+    class RunConnection : public Connection
+    {
+        public:
+            /*!
+             * \brief RunConnection Create a connection for one command
+             *
+             * \param runner The command waiting for the reply
+             *
+             * @since test-cascades 1.1.5
+             */
+            explicit RunConnection(QObject * const runner);
+            /*!
+             * \brief ~RunConnection Destructor
+             *
+             * @since test-cascades 1.1.5
+             */
+            virtual ~RunConnection();
+            /*
+             * See super
+             */
+            qint64 write(const QString& data);
+            /*
+             * See super
+             */
+            qint64 write(const QByteArray& data)
+            {
+                return this->write(QString::fromUtf8(data.constData(), data.size()));
+            }
+            /*
+             * See super
+             */
+            bool flush(void)
+            {
+                return true;
+            }
+        protected:
+        private:
+            /*!
+             * \brief runner The command waiting for the reply, cleared if it's gone
+             */
+            QPointer<QObject> runner;
+            /*!
+             * \brief buffer Written data not yet ended by a new line
+             */
+            QString buffer;
+            /*!
+             * \brief replied @c true once the reply was captured
+             */
+            bool replied;
+    };
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
+
+#endif  // RUNCONNECTION_H_
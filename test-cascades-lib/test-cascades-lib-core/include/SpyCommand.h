@@ -5,6 +5,7 @@
 #define SPYCOMMAND_H_
 
 #include <QObject>
+#include <QTimer>
 
 #include "Command.h"
 
@@ -74,8 +75,64 @@ namespace cascades
          * See super
          */
         virtual void showHelp(void);
+        /*!
+         * \brief removeAllSpies Disconnect and delete every spy
+         *
+         * \return The number of spies removed
+         *
+         * @since test-cascades 1.1.5
+         */
+        static int removeAllSpies(void);
+        /*
+         * See super
+         */
+        void cleanUp(void)
+        {
+            // a wait deletes itself when it's answered
+            if (not this->waiting)
+            {
+                this->deleteLater();
+            }
+        }
+        /*!
+         * \brief spyFired Called by the spy being waited on when its
+         * signal fires
+         *
+         * \param count The number of times the signal has fired
+         *
+         * @since test-cascades 1.1.5
+         */
+        void spyFired(const quint64 count);
+        /*!
+         * \brief spyKilled Called by the spy being waited on when it's
+         * removed
+         *
+         * @since test-cascades 1.1.5
+         */
+        void spyKilled(void);
     protected slots:
+        /*!
+         * \brief waitTimedOut Slot for the wait timing out
+         *
+         * @since test-cascades 1.1.5
+         */
+        void waitTimedOut(void);
+        /*!
+         * \brief clientDisconnected Slot for the client going away
+         * during a wait
+         *
+         * @since test-cascades 1.1.5
+         */
+        void clientDisconnected(void);
     private:
+        /*!
+         * \brief finishWait Stop waiting and reply
+         *
+         * \param reply The reply
+         *
+         * @since test-cascades 1.1.5
+         */
+        void finishWait(const QString& reply);
         /*!
          * \brief CMD_NAME The name of this command
          */
@@ -92,6 +149,22 @@ namespace cascades
          * \brief spyPrivateSingleton Private data
          */
         static SpyCommandPrivate * spyPrivateSingleton;
+        /*!
+         * \brief waiting @c true while a wait is waiting
+         */
+        bool waiting;
+        /*!
+         * \brief waitName The spy being waited on
+         */
+        QString waitName;
+        /*!
+         * \brief waitCount The count being waited for
+         */
+        quint64 waitCount;
+        /*!
+         * \brief waitTimer The wait timeout
+         */
+        QTimer waitTimer;
     };
 }  // namespace cascades
 }  // namespace test
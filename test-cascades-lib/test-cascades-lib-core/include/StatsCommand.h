@@ -0,0 +1,98 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#ifndef STATSCOMMAND_H_
+#define STATSCOMMAND_H_
+
+#include <QObject>
+
+#include "Command.h"
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    /*!
+     * \brief The StatsCommand class reports where the harness has
+     * spent its time (parsing, finding objects, executing and writing)
+     * for each command so harness overhead can be told apart from the
+     * application being slow.
+     *
+     * @since test-cascades 1.1.5
+     */
+    class StatsCommand : public Command
+    {
+    Q_OBJECT
+    public:
+        /*!
+         * \brief getCmd Return the name of this command
+         *
+         * \return Command name
+         *
+         * @since test-cascades 1.1.5
+         */
+        static QString getCmd()
+        {
+            return CMD_NAME;
+        }
+        /*!
+         * \brief create Create a new instance of this Command
+         *
+         * \param s The TCP socket associated with the client
+         * \param parent The parent object
+         * \return Returns a new instance of the Command
+         *
+         * @since test-cascades 1.1.5
+         */
+        static Command* create(class Connection * const s,
+                               QObject * parent = 0)
+        {
+            return new StatsCommand(s, parent);
+        }
+        /*!
+         * \brief StatsCommand Constructor
+         *
+         * \param socket The TCP socket associated with the client
+         * \param parent The parent object
+         *
+         * @since test-cascades 1.1.5
+         */
+        StatsCommand(class Connection * const socket,
+                     QObject* parent = 0);
+        /*!
+         * \brief ~StatsCommand Destructor
+         *
+         * @since test-cascades 1.1.5
+         */
+        ~StatsCommand();
+        /*
+         * See super
+         */
+        bool executeCommand(QStringList * const arguments);
+        /*
+         * See super
+         */
+        void showHelp(void);
+    protected:
+    private:
+        /*!
+         * \brief CMD_NAME The name of this command
+         */
+        static const QString CMD_NAME;
+        /*!
+         * \brief MAX_REPLY The longest reply, clients read lines
+         * of up to 1024 bytes
+         */
+        static const int MAX_REPLY;
+        /*!
+         * \brief client The TCP socket associated with the client
+         */
+        class Connection * const client;
+    };
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
+
+#endif  // STATSCOMMAND_H_
@@ -83,16 +83,6 @@ namespace cascades
          * See super
          */
         void showHelp(void);
-    protected slots:
-    private:
-        /*!
-         * \brief CMD_NAME The name of this command
-         */
-        static const QString CMD_NAME;
-        /*!
-         * \brief client The TCP socket associated with the client
-         */
-        class Connection * const client;
         /*!
          * \brief finishButton Complete the dialog
          *
@@ -103,8 +93,8 @@ namespace cascades
          *
          * @since test-cascades 1.0.10
          */
-        bool finishButton(bb::system::SystemDialog * const dialog,
-                          const bb::system::SystemUiResult::Type result);
+        static bool finishButton(bb::system::SystemDialog * const dialog,
+                                 const bb::system::SystemUiResult::Type result);
         /*!
          * \brief finishButton Complete the prompt
          *
@@ -115,8 +105,29 @@ namespace cascades
          *
          * @since test-cascades 1.1.0
          */
-        bool finishButton(bb::system::SystemPrompt * const prompt,
-                          const bb::system::SystemUiResult::Type result);
+        static bool finishButton(bb::system::SystemPrompt * const prompt,
+                                 const bb::system::SystemUiResult::Type result);
+    protected slots:
+    private:
+        /*!
+         * \brief findDialog Find a dialog or prompt
+         *
+         * \param type The class, a dialog or a prompt
+         * \param name The object name or path
+         *
+         * \return The object or @c NULL
+         *
+         * @since test-cascades 1.1.5
+         */
+        static QObject * findDialog(const QMetaObject& type, const QString& name);
+        /*!
+         * \brief CMD_NAME The name of this command
+         */
+        static const QString CMD_NAME;
+        /*!
+         * \brief client The TCP socket associated with the client
+         */
+        class Connection * const client;
     };
 }  // namespace cascades
 }  // namespace test
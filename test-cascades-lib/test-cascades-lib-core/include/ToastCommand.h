@@ -76,20 +76,13 @@ namespace cascades
         void showHelp(void);
     protected:
         /*!
-         * \brief findVisibleToast From top object, scan and find a toast that's visible
+         * \brief findVisibleToast Find a toast that's visible
          *
-         * \param object The starting point of the search
-         * \param searchLevel The current recursive search level
-         * \param maxSearchLevel The maximum recursive search level
-         * \return A @c SystemToast or @c NULL if one wasn't found or
-         * none are visible
+         * \return A @c SystemToast or @c NULL if none are visible
          *
          * @since test-cascades 1.0.0
          */
-        static const bb::system::SystemToast * findVisibleToast(
-                QObject * const object,
-                const size_t searchLevel = 0,
-                const size_t maxSearchLevel = 100);
+        static const bb::system::SystemToast * findVisibleToast(void);
     private:
         /*!
          * \brief CMD_NAME The name of this command
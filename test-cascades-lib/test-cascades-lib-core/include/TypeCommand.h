@@ -0,0 +1,174 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#ifndef TYPECOMMAND_H_
+#define TYPECOMMAND_H_
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QStringList>
+#include <QTimer>
+
+#include <bb/cascades/Control>
+
+#include "Command.h"
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    /*!
+     * \brief The TypeCommand class types text into a field a character
+     * at a time at a given rate, like someone typing.
+     *
+     * Each character is inserted at the cursor with the field's editor
+     * rather than by setting the whole text, so the work for a keystroke
+     * doesn't grow with the length of the field. The reply is sent once
+     * the last character has been typed.
+     *
+     * @since test-cascades 1.1.5
+     */
+    class TypeCommand : public Command
+    {
+    Q_OBJECT
+    public:
+        /*!
+         * \brief getCmd Return the name of this command
+         *
+         * \return Command name
+         *
+         * @since test-cascades 1.1.5
+         */
+        static QString getCmd()
+        {
+            return CMD_NAME;
+        }
+        /*!
+         * \brief create Create a new instance of this Command
+         *
+         * \param s The TCP socket associated with the client
+         * \param parent The parent object
+         * \return Returns a new instance of the Command
+         *
+         * @since test-cascades 1.1.5
+         */
+        static Command* create(class Connection * const s,
+                               QObject * parent = 0)
+        {
+            return new TypeCommand(s, parent);
+        }
+        /*!
+         * \brief insertText Insert text at the cursor of a TextField or
+         * TextArea without setting the whole text
+         *
+         * \param field The field
+         * \param text The text to insert
+         * \param atEnd @c true to move the cursor to the end first, as
+         * appending to the text always did
+         *
+         * \return @c false if the object isn't a TextField or TextArea
+         *
+         * @since test-cascades 1.1.5
+         */
+        static bool insertText(QObject * const field,
+                               const QString& text,
+                               const bool atEnd = false);
+        /*!
+         * \brief TypeCommand Constructor
+         *
+         * \param socket The TCP socket associated with the client
+         * \param parent The parent object
+         *
+         * @since test-cascades 1.1.5
+         */
+        TypeCommand(class Connection * const socket,
+                    QObject* parent = 0);
+        /*!
+         * \brief ~TypeCommand Destructor
+         *
+         * @since test-cascades 1.1.5
+         */
+        ~TypeCommand();
+        /*
+         * See super
+         */
+        bool executeCommand(QStringList * const arguments);
+        /*
+         * See super
+         */
+        void cleanUp(void)
+        {
+            // typing deletes itself when it's finished
+            if (not this->typing)
+            {
+                this->deleteLater();
+            }
+        }
+        /*
+         * See super
+         */
+        void showHelp(void);
+    protected:
+    private slots:
+        /*!
+         * \brief typeNext Type the next character
+         *
+         * @since test-cascades 1.1.5
+         */
+        void typeNext(void);
+        /*!
+         * \brief clientDisconnected Slot for the client going away
+         *
+         * @since test-cascades 1.1.5
+         */
+        void clientDisconnected(void);
+    private:
+        /*!
+         * \brief finish Stop typing and reply
+         *
+         * \param reply The reply, empty to not reply
+         *
+         * @since test-cascades 1.1.5
+         */
+        void finish(const QString& reply);
+        /*!
+         * \brief CMD_NAME The name of this command
+         */
+        static const QString CMD_NAME;
+        /*!
+         * \brief client The TCP socket associated with the client
+         */
+        class Connection * const client;
+        /*!
+         * \brief typing @c true until the command replies
+         */
+        bool typing;
+        /*!
+         * \brief field The field being typed into
+         */
+        QPointer<bb::cascades::Control> field;
+        /*!
+         * \brief text The text to type
+         */
+        QString text;
+        /*!
+         * \brief typed The number of characters typed so far
+         */
+        int typed;
+        /*!
+         * \brief clock Started when typing starts
+         */
+        QElapsedTimer clock;
+        /*!
+         * \brief keyTimer Types each character
+         */
+        QTimer keyTimer;
+    };
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
+
+#endif  // TYPECOMMAND_H_
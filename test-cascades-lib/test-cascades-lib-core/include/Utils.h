@@ -37,6 +37,19 @@ namespace cascades
         static QStringList tokenise(const QString& delim,
                                     const QString& buffer,
                                     const bool includeDelim = true);
+        /*!
+         * \brief untokenise Rebuild the text that was tokenised with the
+         * delimiters included, i.e. to pass the rest of a command on as-is
+         *
+         * \param delim The delimiters used to tokenise the text, the
+         * space is the only one not included as a token
+         * \param tokens The tokens
+         * \return The text (less any leading or trailing spaces)
+         *
+         * @since test-cascades 1.1.5
+         */
+        static QString untokenise(const QString& delim,
+                                  const QStringList& tokens);
 
         // from Hooq
 
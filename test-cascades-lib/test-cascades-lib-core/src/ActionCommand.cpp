@@ -9,6 +9,7 @@
 
 #include "ActionCommand.h"
 #include "Connection.h"
+#include "ObjectRegistry.h"
 
 using bb::cascades::AbstractPane;
 using bb::cascades::AbstractActionItem;
@@ -159,36 +160,20 @@ namespace cascades
                 }
                 else if (pane)
                 {
-                    AbstractActionItem * action = pane->findChild<AbstractActionItem*>(name);
+                    AbstractActionItem * const action = findAction(pane, name);
                     if (action)
                     {
                         ret = executeAction(action);
+                        if (not ret)
+                        {
+                            this->client->write(tr("ERROR: Failed to execute the"\
+                                                " named action") + "\r\n");
+                        }
                     }
                     else
                     {
-                        action = Application::instance()->findChild<AbstractActionItem*>(name);
-                        if (action)
-                        {
-                            ret = executeAction(action);
-                        }
-                        else
-                        {
-                            action = findAction(pane, name);
-                            if (action)
-                            {
-                                ret = executeAction(action);
-                                if (not ret)
-                                {
-                                    this->client->write(tr("ERROR: Failed to execute the"\
-                                                        " named action") + "\r\n");
-                                }
-                            }
-                            else
-                            {
-                                this->client->write(
-                                            tr("ERROR: Unable to find the named action") + "\r\n");
-                            }
-                        }
+                        this->client->write(
+                                    tr("ERROR: Unable to find the named action") + "\r\n");
                     }
                 }
                 else
@@ -218,44 +203,39 @@ namespace cascades
     }
 
     AbstractActionItem * ActionCommand::findAction(
-            const QObject * const obj,
-            const QString& name,
-            const size_t call_depth,
-            const size_t max_call_depth)
+            const QObject * const root,
+            const QString& name)
     {
-        AbstractActionItem *ret = NULL, *tmp = NULL;
-
-        // check the call depth to avoid stack thrash
-        if (call_depth < max_call_depth)
+        const QList<QObject*> actions =
+                ObjectRegistry::instance()->objects(AbstractActionItem::staticMetaObject);
+        // the object name under the root, then anywhere, then the title under the root
+        for (int pass = 0 ; pass < 3 ; pass++)
         {
-            tmp = qobject_cast<AbstractActionItem*>(const_cast<QObject*>(obj));
-            if (tmp)
+            foreach (QObject * const object, actions)
             {
-                // check this object
-                const QString title = tmp->title();
-                if (not title.isEmpty())
+                AbstractActionItem * const action = qobject_cast<AbstractActionItem*>(object);
+                const bool matched = pass == 2 ?
+                            (not action->title().isEmpty() and action->title() == name)
+                          : action->objectName() == name;
+                if (matched and (pass == 1 or isUnder(action, root)))
                 {
-                    if (title == name)
-                    {
-                        ret = tmp;
-                    }
+                    return action;
                 }
             }
-            // isn't this object, check the children
-            if (not ret)
+        }
+        return NULL;
+    }
+
+    bool ActionCommand::isUnder(const QObject * object, const QObject * const root)
+    {
+        for ( ; object ; object = object->parent())
+        {
+            if (object == root)
             {
-                Q_FOREACH(const QObject * const child, obj->children())
-                {
-                    ret = findAction(child, name, call_depth+1, max_call_depth);
-                    if (ret)
-                    {
-                        break;
-                    }
-                }
+                return true;
             }
         }
-
-        return ret;
+        return false;
     }
 
     Page * ActionCommand::findCurrentPage(
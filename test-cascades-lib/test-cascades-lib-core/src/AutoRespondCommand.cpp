@@ -0,0 +1,122 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#include "AutoRespondCommand.h"
+
+#include <QString>
+#include <QObject>
+
+#include <bb/system/SystemUiResult>
+
+#include "AutoResponder.h"
+#include "Connection.h"
+#include "Utils.h"
+
+using bb::system::SystemUiResult;
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    const QString AutoRespondCommand::CMD_NAME = "autorespond";
+
+    AutoRespondCommand::AutoRespondCommand(Connection * const socket,
+                                           QObject* parent)
+        : Command(parent),
+          client(socket)
+    {
+    }
+
+    AutoRespondCommand::~AutoRespondCommand()
+    {
+    }
+
+    bool AutoRespondCommand::executeCommand(QStringList * const arguments)
+    {
+        bool ret = false;
+        AutoResponder * const responder = AutoResponder::instance();
+        if (arguments->isEmpty())
+        {
+            // not translated; protocol
+            this->client->write(QString("OK ") + responder->summary() + "\r\n");
+        }
+        else if (arguments->size() == 1 and arguments->first() == "clear")
+        {
+            responder->clear();
+            ret = true;
+        }
+        else if (arguments->size() == 3 and arguments->first() == "dialog")
+        {
+            const QString action = arguments->last();
+            SystemUiResult::Type result = SystemUiResult::None;
+            bool known = true;
+            if (action == "confirm")
+            {
+                result = SystemUiResult::ConfirmButtonSelection;
+            }
+            else if (action == "cancel")
+            {
+                result = SystemUiResult::CancelButtonSelection;
+            }
+            else if (action == "custom")
+            {
+                result = SystemUiResult::CustomButtonSelection;
+            }
+            else if (action == "button")
+            {
+                result = SystemUiResult::ButtonSelection;
+            }
+            else if (action not_eq "none")
+            {
+                known = false;
+            }
+            if (known)
+            {
+                responder->addDialogRule(arguments->at(1), result);
+                ret = true;
+            }
+            else
+            {
+                this->client->write(tr("ERROR: Need to specify confirm, cancel, custom, " \
+                                       "button or none") + "\r\n");
+            }
+        }
+        else if (arguments->size() >= 2 and arguments->first() == "toast")
+        {
+            QString text = Utils::untokenise(", ", arguments->mid(1));
+            if (text.length() >= 2 and text.startsWith('"') and text.endsWith('"'))
+            {
+                text = text.mid(1, text.length() - 2);
+            }
+            responder->addToastRule(text);
+            ret = true;
+        }
+        else
+        {
+            this->client->write(tr("ERROR: autorespond [clear|dialog <name|*> <action>|" \
+                                   "toast <text|*>]") + "\r\n");
+        }
+        return ret;
+    }
+
+    void AutoRespondCommand::showHelp()
+    {
+        this->client->write(tr("> autorespond") + "\r\n");
+        this->client->write(tr("> autorespond dialog <name|*> " \
+                               "<confirm|cancel|custom|button|none>") + "\r\n");
+        this->client->write(tr("> autorespond toast <text|*>") + "\r\n");
+        this->client->write(tr("> autorespond clear") + "\r\n");
+        this->client->write(tr("Answer a system dialog or prompt with that name, or " \
+                               "dismiss a toast") + "\r\n");
+        this->client->write(tr("containing the text (which may be quoted), as soon as " \
+                               "it's shown. The") + "\r\n");
+        this->client->write(tr("first matching rule is used. With no arguments, show the " \
+                               "rules and") + "\r\n");
+        this->client->write(tr("how many times each has fired. Clear and reset remove " \
+                               "the rules.") + "\r\n");
+    }
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
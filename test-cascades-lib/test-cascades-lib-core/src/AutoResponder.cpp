@@ -0,0 +1,262 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#include "AutoResponder.h"
+
+#include <QEvent>
+#include <QStringList>
+#include <bb/cascades/Application>
+#include <bb/system/SystemDialog>
+#include <bb/system/SystemPrompt>
+#include <bb/system/SystemToast>
+
+#include "ObjectRegistry.h"
+#include "PropertyCache.h"
+#include "SystemDialogCommand.h"
+
+using bb::cascades::Application;
+using bb::system::SystemDialog;
+using bb::system::SystemPrompt;
+using bb::system::SystemToast;
+using bb::system::SystemUiResult;
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    AutoResponder * AutoResponder::singleton = NULL;
+    const int AutoResponder::CHECK_MS = 50;
+
+    AutoResponder * AutoResponder::instance()
+    {
+        if (not AutoResponder::singleton)
+        {
+            AutoResponder::singleton = new AutoResponder();
+        }
+        return AutoResponder::singleton;
+    }
+
+    AutoResponder::AutoResponder()
+        : QObject(NULL),
+          checkQueued(false)
+    {
+        this->checkTimer.setInterval(CHECK_MS);
+        connect(&this->checkTimer, SIGNAL(timeout()), SLOT(check()));
+    }
+
+    AutoResponder::~AutoResponder()
+    {
+        this->clear();
+    }
+
+    void AutoResponder::addDialogRule(const QString& name, const SystemUiResult::Type result)
+    {
+        Rule rule;
+        rule.toast = false;
+        rule.match = name;
+        rule.result = result;
+        rule.fired = 0;
+        this->rules.append(rule);
+        this->start();
+    }
+
+    void AutoResponder::addToastRule(const QString& text)
+    {
+        Rule rule;
+        rule.toast = true;
+        rule.match = text;
+        rule.result = SystemUiResult::None;
+        rule.fired = 0;
+        this->rules.append(rule);
+        this->start();
+    }
+
+    void AutoResponder::start(void)
+    {
+        if (this->checkTimer.isActive())
+        {
+            return;
+        }
+        this->watched.clear();
+        this->answered.clear();
+        ObjectRegistry * const registry = ObjectRegistry::instance();
+        foreach (QObject * const dialog, registry->objects(SystemDialog::staticMetaObject))
+        {
+            this->watch(dialog);
+        }
+        foreach (QObject * const prompt, registry->objects(SystemPrompt::staticMetaObject))
+        {
+            this->watch(prompt);
+        }
+        foreach (QObject * const toast, registry->objects(SystemToast::staticMetaObject))
+        {
+            this->watch(toast);
+        }
+        connect(registry, SIGNAL(registered(QObject*)), this, SLOT(objectRegistered(QObject*)));
+        Application::instance()->installEventFilter(this);
+        this->checkTimer.start();
+        this->queueCheck();
+    }
+
+    void AutoResponder::clear(void)
+    {
+        if (this->checkTimer.isActive())
+        {
+            Application::instance()->removeEventFilter(this);
+            disconnect(ObjectRegistry::instance(), NULL, this, NULL);
+            this->checkTimer.stop();
+        }
+        this->rules.clear();
+        this->watched.clear();
+        this->answered.clear();
+    }
+
+    QString AutoResponder::summary(void) const
+    {
+        QStringList described;
+        foreach (const Rule& rule, this->rules)
+        {
+            QString action = "dismiss";
+            if (not rule.toast)
+            {
+                switch (rule.result)
+                {
+                case SystemUiResult::ConfirmButtonSelection:
+                    action = "confirm";
+                    break;
+                case SystemUiResult::CancelButtonSelection:
+                    action = "cancel";
+                    break;
+                case SystemUiResult::CustomButtonSelection:
+                    action = "custom";
+                    break;
+                case SystemUiResult::ButtonSelection:
+                    action = "button";
+                    break;
+                default:
+                    action = "none";
+                    break;
+                }
+            }
+            described.append(QString("%1:%2=%3(%4)")
+                             .arg(rule.toast ? "toast" : "dialog")
+                             .arg(rule.match)
+                             .arg(action)
+                             .arg(rule.fired));
+        }
+        return described.join(" ");
+    }
+
+    // cppcheck-suppress unusedFunction
+    bool AutoResponder::eventFilter(QObject * const receiver, QEvent * const event)
+    {
+        Q_UNUSED(event);
+        if (this->watched.contains(receiver))
+        {
+            this->queueCheck();
+        }
+        return false;
+    }
+
+    void AutoResponder::queueCheck(void)
+    {
+        if (not this->checkQueued)
+        {
+            this->checkQueued = true;
+            QTimer::singleShot(0, this, SLOT(check()));
+        }
+    }
+
+    void AutoResponder::objectRegistered(QObject * object)
+    {
+        this->watch(object);
+        this->queueCheck();
+    }
+
+    void AutoResponder::watch(QObject * const object)
+    {
+        // a deleted object's address may be reused
+        if (not this->watched.value(object)
+                and (qobject_cast<SystemDialog*>(object)
+                     or qobject_cast<SystemPrompt*>(object)
+                     or qobject_cast<SystemToast*>(object)))
+        {
+            this->watched.insert(object, object);
+            this->answered.remove(object);
+        }
+    }
+
+    void AutoResponder::check(void)
+    {
+        this->checkQueued = false;
+        // answering runs the event loop so the list may change underneath
+        QList<QPointer<QObject> > showing;
+        QHash<QObject*, QPointer<QObject> >::iterator it = this->watched.begin();
+        while (it not_eq this->watched.end())
+        {
+            QObject * const object = it.value();
+            if (not object)
+            {
+                this->answered.remove(it.key());
+                it = this->watched.erase(it);
+                continue;
+            }
+            // the same visible property the toast command checks
+            if (not PropertyCache::read(object, "visible").toBool())
+            {
+                // it can be answered again the next time it's shown
+                this->answered.remove(object);
+            }
+            else if (not this->answered.contains(object))
+            {
+                this->answered.insert(object);
+                showing.append(object);
+            }
+            ++it;
+        }
+        foreach (const QPointer<QObject>& object, showing)
+        {
+            if (object)
+            {
+                this->respond(object);
+            }
+        }
+    }
+
+    bool AutoResponder::respond(QObject * const object)
+    {
+        SystemToast * const toast = qobject_cast<SystemToast*>(object);
+        SystemDialog * const dialog = qobject_cast<SystemDialog*>(object);
+        SystemPrompt * const prompt = qobject_cast<SystemPrompt*>(object);
+        for (int i = 0 ; i < this->rules.size() ; i++)
+        {
+            Rule& rule = this->rules[i];
+            if (toast and rule.toast
+                    and (rule.match == "*" or toast->body().contains(rule.match)))
+            {
+                rule.fired++;
+                toast->cancel();
+                return true;
+            }
+            if ((dialog or prompt) and not rule.toast
+                    and (rule.match == "*" or rule.match == object->objectName()))
+            {
+                rule.fired++;
+                if (dialog)
+                {
+                    SystemDialogCommand::finishButton(dialog, rule.result);
+                }
+                else
+                {
+                    SystemDialogCommand::finishButton(prompt, rule.result);
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
@@ -11,8 +11,10 @@
 #include "CascadesHarness.h"
 #include "Connection.h"
 #include "CommandFactory.h"
+#include "ObjectRegistry.h"
 #include "Utils.h"
 #include "Server.h"
+#include "Profiler.h"
 
 namespace truphone
 {
@@ -27,6 +29,10 @@ namespace cascades
         telnetSocket(new Server(this)),
         delim(", ")
     {
+        // the stats cover the life of the harness
+        Profiler::reset();
+        // objects are registered as they're created from now on
+        ObjectRegistry::instance();
         if (this->serverSocket)
         {
             connect(this->serverSocket,
@@ -101,6 +107,8 @@ namespace cascades
 
     void CascadesHarness::handleNewTelnetConnection(Connection * connection)
     {
+        // typed a character at a time
+        connection->setWholeLines(false);
         connect(connection,
                 SIGNAL(packetReceived(Connection*, const QString&)),
                 SLOT(processTelnetPacket(Connection*, const QString&)));
@@ -136,21 +144,36 @@ namespace cascades
 
     void CascadesHarness::processPacket(Connection * connection, const QString& packet)
     {
-        QStringList tokens = Utils::tokenise(this->delim, packet.trimmed());
+        Profiler::commandStarted();
+        QString command;
+        QStringList tokens;
+        {
+            ProfilerScope parse(Profiler::PARSE);
+            tokens = Utils::tokenise(this->delim, packet.trimmed());
+        }
         qDebug() << "test-cascades-lib: " << packet.trimmed();
         if (not tokens.empty())
         {
-            const QString command = tokens.first();
+            command = tokens.first();
             if (not command.startsWith("#", Qt::CaseInsensitive))
             {
                 tokens.removeFirst();
-                Command * const cmd = CommandFactory::getCommand(
-                            connection,
-                            command,
-                            this);
+                Command * cmd = NULL;
+                {
+                    ProfilerScope parse(Profiler::PARSE);
+                    cmd = CommandFactory::getCommand(
+                                connection,
+                                command,
+                                this);
+                }
                 if (cmd)
                 {
-                    const bool cmdOk = cmd->executeCommand(&tokens);
+                    bool cmdOk = false;
+                    {
+                        // finding objects and writing are timed separately
+                        ProfilerScope execute(Profiler::EXECUTE);
+                        cmdOk = cmd->executeCommand(&tokens);
+                    }
                     if (cmdOk)
                     {
                         // not translated; protocol
@@ -166,6 +189,7 @@ namespace cascades
                 }
             }
         }
+        Profiler::commandFinished(command);
     }
 }  // namespace cascades
 }  // namespace test
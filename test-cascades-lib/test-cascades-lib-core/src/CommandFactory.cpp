@@ -31,6 +31,18 @@
 #include "SegmentCommand.h"
 #include "SystemDialogCommand.h"
 #include "QuitCommand.h"
+#include "StatsCommand.h"
+#include "ResetCommand.h"
+#include "RunCommand.h"
+#include "JankCommand.h"
+#include "MemCommand.h"
+#include "LeakCommand.h"
+#include "ProbeCommand.h"
+#include "OutboundCommand.h"
+#include "GestureCommand.h"
+#include "TypeCommand.h"
+#include "MonkeyCommand.h"
+#include "AutoRespondCommand.h"
 
 using truphone::test::cascades::Command;
 using truphone::test::cascades::ClickCommand;
@@ -58,6 +70,18 @@ using truphone::test::cascades::ListCommand;
 using truphone::test::cascades::SegmentCommand;
 using truphone::test::cascades::SystemDialogCommand;
 using truphone::test::cascades::QuitCommand;
+using truphone::test::cascades::StatsCommand;
+using truphone::test::cascades::ResetCommand;
+using truphone::test::cascades::RunCommand;
+using truphone::test::cascades::JankCommand;
+using truphone::test::cascades::MemCommand;
+using truphone::test::cascades::LeakCommand;
+using truphone::test::cascades::ProbeCommand;
+using truphone::test::cascades::OutboundCommand;
+using truphone::test::cascades::GestureCommand;
+using truphone::test::cascades::TypeCommand;
+using truphone::test::cascades::MonkeyCommand;
+using truphone::test::cascades::AutoRespondCommand;
 
 namespace truphone
 {
@@ -216,6 +240,30 @@ namespace cascades
                new CommandFactoryEntry(&SystemDialogCommand::create));
         insert(QuitCommand::getCmd(),
                new CommandFactoryEntry(&QuitCommand::create));
+        insert(StatsCommand::getCmd(),
+               new CommandFactoryEntry(&StatsCommand::create));
+        insert(ResetCommand::getCmd(),
+               new CommandFactoryEntry(&ResetCommand::create));
+        insert(RunCommand::getCmd(),
+               new CommandFactoryEntry(&RunCommand::create));
+        insert(JankCommand::getCmd(),
+               new CommandFactoryEntry(&JankCommand::create));
+        insert(MemCommand::getCmd(),
+               new CommandFactoryEntry(&MemCommand::create));
+        insert(LeakCommand::getCmd(),
+               new CommandFactoryEntry(&LeakCommand::create));
+        insert(ProbeCommand::getCmd(),
+               new CommandFactoryEntry(&ProbeCommand::create));
+        insert(OutboundCommand::getCmd(),
+               new CommandFactoryEntry(&OutboundCommand::create));
+        insert(GestureCommand::getCmd(),
+               new CommandFactoryEntry(&GestureCommand::create));
+        insert(TypeCommand::getCmd(),
+               new CommandFactoryEntry(&TypeCommand::create));
+        insert(MonkeyCommand::getCmd(),
+               new CommandFactoryEntry(&MonkeyCommand::create));
+        insert(AutoRespondCommand::getCmd(),
+               new CommandFactoryEntry(&AutoRespondCommand::create));
     }
 
     Command * CommandFactory::getCommand(
@@ -3,34 +3,74 @@
  */
 #include "Connection.h"
 
+#include <QElapsedTimer>
+#include <QTimer>
+
+#include "Profiler.h"
+
 namespace truphone
 {
 namespace test
 {
 namespace cascades
 {
+    const qint64 Connection::DEFAULT_LIMIT = 4 * 1024 * 1024;
+    const qint64 Connection::SOCKET_HIGH_WATER = 64 * 1024;
+    const int Connection::BLOCK_MS = 1000;
+
     Connection::Connection(
             QTcpSocket * const clientSocket,
             QObject* parent) :
         QObject(parent),
-        socket(clientSocket)
+        socket(clientSocket),
+        wholeLines(true),
+        queuedBytes(0),
+        maxQueuedBytes(0),
+        queueLimit(DEFAULT_LIMIT),
+        overflowPolicy(DROP_OLDEST),
+        dropped(0),
+        coalesced(0),
+        blockedMs(0),
+        passBlockedMs(0),
+        passEndQueued(false)
     {
         connect(this->socket,
                 SIGNAL(readyRead()),
                 SLOT(processPacket()));
 
+        connect(this->socket,
+                SIGNAL(bytesWritten(qint64)),
+                SLOT(sendQueued()));
+
         connect(socket,
                 SIGNAL(disconnected()),
                 SLOT(connectionDied()));
     }
 
+    Connection::Connection(QObject* parent) :
+        QObject(parent),
+        socket(NULL),
+        wholeLines(true),
+        queuedBytes(0),
+        maxQueuedBytes(0),
+        queueLimit(DEFAULT_LIMIT),
+        overflowPolicy(DROP_OLDEST),
+        dropped(0),
+        coalesced(0),
+        blockedMs(0),
+        passBlockedMs(0),
+        passEndQueued(false)
+    {
+    }
+
     Connection::~Connection()
     {
     }
 
     void Connection::processPacket(void)
     {
-        while (this->socket->bytesAvailable())
+        while (this->wholeLines ?
+               this->socket->canReadLine() : this->socket->bytesAvailable())
         {
             // read in a command from the client
 
@@ -48,29 +88,182 @@ namespace cascades
 
     qint64 Connection::write(const char * const data)
     {
-        const QByteArray qData(data);
-        this->socket->flush();
-        const qint64 written = this->socket->write(qData);
-        if (written == qData.length())
+        return this->write(QByteArray(data));
+    }
+
+    qint64 Connection::write(const QByteArray& data)
+    {
+        ProfilerScope timed(Profiler::WRITE);
+        // replies are never dropped
+        this->enqueue(data, QByteArray(), false);
+        return data.length();
+    }
+
+    void Connection::stream(const QByteArray& data,
+                            const QByteArray& kind,
+                            const bool replaceable)
+    {
+        if (not this->socket)
+        {
+            this->write(data);
+            return;
+        }
+        ProfilerScope timed(Profiler::WRITE);
+        this->sendQueued();
+        if (this->queueLimit > 0 and this->queuedBytes + data.length() > this->queueLimit)
+        {
+            switch (this->overflowPolicy)
+            {
+            case BLOCK:
+                {
+                    // each wait stalls the UI thread, so a pass that streams
+                    // a lot to a slow client only stalls for BLOCK_MS
+                    const qint64 budget = BLOCK_MS - this->passBlockedMs;
+                    QElapsedTimer blocked;
+                    blocked.start();
+                    while (this->queuedBytes + data.length() > this->queueLimit
+                           and this->socket->state() == QAbstractSocket::ConnectedState
+                           and blocked.elapsed() < budget
+                           and this->socket->waitForBytesWritten(budget - blocked.elapsed()))
+                    {
+                        this->sendQueued();
+                    }
+                    this->blockedMs += blocked.elapsed();
+                    this->passBlockedMs += blocked.elapsed();
+                    if (not this->passEndQueued)
+                    {
+                        this->passEndQueued = true;
+                        QTimer::singleShot(0, this, SLOT(passEnded()));
+                    }
+                }
+                break;
+            case COALESCE:
+                // a recording's events don't replace each other, they're dropped
+                for (int i = this->queue.size() - 1 ; replaceable and i >= 0 ; i--)
+                {
+                    if (this->queue.at(i).replaceable and this->queue.at(i).kind == kind)
+                    {
+                        this->queuedBytes -= this->queue.at(i).data.length();
+                        this->queue.removeAt(i);
+                        this->coalesced++;
+                    }
+                }
+                break;
+            case DROP_OLDEST:
+                break;
+            case DISCONNECT:
+                qWarning("Connection queue is over %lld bytes, disconnecting",
+                         this->queueLimit);
+                this->queue.clear();
+                this->queuedBytes = 0;
+                this->socket->abort();
+                return;
+            }
+            while (this->queuedBytes + data.length() > this->queueLimit and this->dropOldest())
+            {
+            }
+        }
+        this->enqueue(data, kind, replaceable);
+    }
+
+    bool Connection::dropOldest(void)
+    {
+        for (int i = 0 ; i < this->queue.size() ; i++)
         {
-            this->socket->flush();
+            Outbound& oldest = this->queue[i];
+            if (oldest.kind.isEmpty())
+            {
+                continue;
+            }
+            this->queuedBytes -= oldest.data.length();
+            this->dropped++;
+            // consecutive drops share a gap line
+            if (i > 0 and this->queue.at(i - 1).gap > 0)
+            {
+                this->queue[i - 1].gap++;
+                this->queue.removeAt(i);
+            }
+            else
+            {
+                oldest.data.clear();
+                oldest.kind.clear();
+                oldest.replaceable = false;
+                oldest.gap = 1;
+            }
+            return true;
         }
-        else
+        return false;
+    }
+
+    void Connection::enqueue(const QByteArray& data,
+                             const QByteArray& kind,
+                             const bool replaceable)
+    {
+        Outbound outbound;
+        outbound.data = data;
+        outbound.kind = kind;
+        outbound.replaceable = replaceable;
+        outbound.gap = 0;
+        this->queue.append(outbound);
+        this->queuedBytes += data.length();
+        this->maxQueuedBytes = qMax(this->maxQueuedBytes, this->queuedBytes);
+        this->sendQueued();
+    }
+
+    void Connection::sendQueued(void)
+    {
+        if (not this->socket)
+        {
+            return;
+        }
+        while (not this->queue.isEmpty()
+               and this->socket->bytesToWrite() < SOCKET_HIGH_WATER)
         {
-            qWarning("Connection transmitted {%d} of {%d}, data {%s}",
-                     (int)(written), qData.length(), data);
+            const Outbound next = this->queue.takeFirst();
+            this->queuedBytes -= next.data.length();
+            // not translated; protocol, scripts skip lines starting with #
+            const QByteArray data = next.gap > 0 ?
+                        "# GAP " + QByteArray::number(next.gap) + "\r\n" : next.data;
+            const qint64 written = this->socket->write(data);
+            if (written not_eq data.length())
+            {
+                qWarning("Connection transmitted {%d} of {%d}, data {%s}",
+                         (int)(written), data.length(), data.constData());
+            }
         }
-        return written;
+        this->socket->flush();
+    }
+
+    void Connection::passEnded(void)
+    {
+        this->passEndQueued = false;
+        this->passBlockedMs = 0;
+    }
+
+    QString Connection::queueStats(void) const
+    {
+        static const char * const policies[] = { "block", "coalesce", "drop-oldest", "disconnect" };
+        return QString("policy=%1 limit=%2 queued=%3 socket=%4 max=%5 dropped=%6"
+                       " coalesced=%7 blockedMs=%8")
+                .arg(policies[this->overflowPolicy])
+                .arg(this->queueLimit)
+                .arg(this->queuedBytes)
+                .arg(this->socket ? this->socket->bytesToWrite() : 0)
+                .arg(this->maxQueuedBytes)
+                .arg(this->dropped)
+                .arg(this->coalesced)
+                .arg(this->blockedMs);
     }
 
     qint64 Connection::write(const QString& data)
     {
-        return this->write(data.toUtf8().constData());
+        ProfilerScope timed(Profiler::WRITE);
+        return this->write(data.toUtf8());
     }
 
     bool Connection::flush(void)
     {
-        return this->socket->flush();
+        return this->socket and this->socket->flush();
     }
 
     void Connection::connectionDied(void)
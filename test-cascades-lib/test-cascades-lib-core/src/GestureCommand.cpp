@@ -0,0 +1,226 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#include "GestureCommand.h"
+
+#include <QString>
+#include <QObject>
+
+#include <bb/cascades/Application>
+#include <bb/cascades/TouchEvent>
+
+#include "Connection.h"
+#include "Utils.h"
+
+using bb::cascades::Application;
+using bb::cascades::TouchEvent;
+using bb::cascades::TouchType;
+using bb::cascades::VisualNode;
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    const QString GestureCommand::CMD_NAME = "gesture";
+    const int GestureCommand::DEFAULT_HZ = 60;
+    const int GestureCommand::MAX_HZ = 1000;
+    const int GestureCommand::DRAG_HOLD_MS = 200;
+
+    GestureCommand::GestureCommand(Connection * const socket,
+                                   QObject* parent)
+        : Command(parent),
+          client(socket),
+          playing(false),
+          profile(SWIPE),
+          durationMs(0),
+          moves(0)
+    {
+        connect(&this->sampleTimer, SIGNAL(timeout()), SLOT(sample()));
+    }
+
+    GestureCommand::~GestureCommand()
+    {
+    }
+
+    bool GestureCommand::executeCommand(QStringList * const arguments)
+    {
+        // gesture <swipe|drag|fling> <target> <fx> <fy> <tx> <ty> <ms> [<hz>]
+        if (arguments->size() < 7 or arguments->size() > 8)
+        {
+            this->client->write(tr("ERROR: gesture <swipe|drag|fling> <target> <fromX> " \
+                                   "<fromY> <toX> <toY> <durationMs> [<hz>]") + "\r\n");
+            return false;
+        }
+        const QString profileName = arguments->takeFirst();
+        if (profileName == "swipe")
+        {
+            this->profile = SWIPE;
+        }
+        else if (profileName == "drag")
+        {
+            this->profile = DRAG;
+        }
+        else if (profileName == "fling")
+        {
+            this->profile = FLING;
+        }
+        else
+        {
+            this->client->write(tr("ERROR: The gesture must be swipe, drag or fling") + "\r\n");
+            return false;
+        }
+        const QString targetName = arguments->takeFirst();
+
+        bool ok = true;
+        double coordinates[4];
+        for (int i = 0 ; i < 4 and ok ; i++)
+        {
+            coordinates[i] = arguments->takeFirst().toDouble(&ok);
+        }
+        this->durationMs = ok ? arguments->takeFirst().toInt(&ok) : 0;
+        const int hz = (ok and not arguments->isEmpty()) ?
+                    arguments->takeFirst().toInt(&ok) : DEFAULT_HZ;
+        if (not ok or this->durationMs < 1 or hz < 1 or hz > MAX_HZ)
+        {
+            this->client->write(tr("ERROR: The positions, duration and rate (1 to %1) " \
+                                   "must be numbers").arg(MAX_HZ) + "\r\n");
+            return false;
+        }
+        if (this->profile == DRAG and this->durationMs <= DRAG_HOLD_MS)
+        {
+            this->client->write(tr("ERROR: A drag must be longer than the %1ms hold")
+                                .arg(DRAG_HOLD_MS) + "\r\n");
+            return false;
+        }
+        this->from = QPointF(coordinates[0], coordinates[1]);
+        this->to = QPointF(coordinates[2], coordinates[3]);
+
+        this->target = qobject_cast<VisualNode*>(Utils::findObject(targetName));
+        if (not this->target)
+        {
+            this->client->write(tr("ERROR: The target doesn't exist or isn't a visual " \
+                                   "element") + "\r\n");
+            return false;
+        }
+
+        this->clock.start();
+        if (not this->send(TouchType::Down, this->from))
+        {
+            this->client->write(tr("ERROR: Failed to call touch on the target") + "\r\n");
+            return false;
+        }
+        this->playing = true;
+        connect(this->client,
+                SIGNAL(disconnected(Connection*const)),
+                SLOT(clientDisconnected()));
+        this->sampleTimer.start(qMax(1, 1000 / hz));
+        return false;
+    }
+
+    double GestureCommand::progress(const qint64 elapsedMs) const
+    {
+        double t = qMin(1.0, static_cast<double>(elapsedMs) / this->durationMs);
+        switch (this->profile)
+        {
+        case DRAG:
+            t = qMax(0.0, static_cast<double>(elapsedMs - DRAG_HOLD_MS)
+                     / (this->durationMs - DRAG_HOLD_MS));
+            t = qMin(1.0, t);
+            // fall through, it moves like a swipe once it's held
+        case SWIPE:
+            // smoothstep, no speed at either end
+            return t * t * (3.0 - 2.0 * t);
+        case FLING:
+            // fastest as it's released
+            return t * t;
+        }
+        return t;
+    }
+
+    bool GestureCommand::send(const TouchType::Type type, const QPointF& at)
+    {
+        // the positions are the target's so they're used for all three
+        TouchEvent * const te = new TouchEvent(type,
+                                               at.x(), at.y(),
+                                               at.x(), at.y(),
+                                               at.x(), at.y(),
+                                               this->target);
+        const bool invoked = QMetaObject::invokeMethod(
+                    this->target,
+                    "touch",
+                    Q_ARG(bb::cascades::TouchEvent*, te));
+        te->deleteLater();
+        return invoked;
+    }
+
+    void GestureCommand::sample(void)
+    {
+        if (not this->playing)
+        {
+            return;
+        }
+        if (not this->target)
+        {
+            this->finish(tr("ERROR: The target was deleted during the gesture") + "\r\n");
+            return;
+        }
+        const qint64 elapsedMs = this->clock.elapsed();
+        const double p = this->progress(elapsedMs);
+        const QPointF at = this->from + (this->to - this->from) * p;
+        if (not (this->profile == DRAG and elapsedMs < DRAG_HOLD_MS))
+        {
+            this->send(TouchType::Move, at);
+            this->moves++;
+        }
+        if (elapsedMs >= this->durationMs)
+        {
+            this->send(TouchType::Up, this->to);
+            Application::processEvents();
+            // not translated; protocol
+            this->finish(QString("OK %1 %2").arg(this->moves).arg(this->clock.elapsed())
+                         + "\r\n");
+        }
+    }
+
+    void GestureCommand::clientDisconnected(void)
+    {
+        if (this->playing and this->target)
+        {
+            // don't leave the touch down
+            this->send(TouchType::Cancel, this->from);
+        }
+        this->finish(QString());
+    }
+
+    void GestureCommand::finish(const QString& reply)
+    {
+        if (not this->playing)
+        {
+            return;
+        }
+        this->playing = false;
+        this->sampleTimer.stop();
+        if (not reply.isEmpty())
+        {
+            this->client->write(reply);
+        }
+        this->deleteLater();
+    }
+
+    void GestureCommand::showHelp()
+    {
+        this->client->write(tr("> gesture <swipe|drag|fling> <target> <fromX> <fromY> " \
+                               "<toX> <toY> <durationMs> [<hz>]") + "\r\n");
+        this->client->write(tr("Touch the target at from, move to to over the duration " \
+                               "sampling at hz") + "\r\n");
+        this->client->write(tr("(60 by default) and release it. A swipe speeds up and " \
+                               "slows down, a drag") + "\r\n");
+        this->client->write(tr("holds still for 200ms first and a fling is released at " \
+                               "full speed. Replies") + "\r\n");
+        this->client->write(tr("OK <moves> <ms> once the touch is released.") + "\r\n");
+    }
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
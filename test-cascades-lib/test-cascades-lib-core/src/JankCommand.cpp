@@ -0,0 +1,133 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#include "JankCommand.h"
+
+#include <QString>
+#include <QObject>
+
+#include "Connection.h"
+#include "JankMonitor.h"
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    const QString JankCommand::CMD_NAME = "jank";
+    const int JankCommand::MAX_REPLY = 1000;
+    const int JankCommand::DEFAULT_INTERVAL_MS = 5;
+    const int JankCommand::DEFAULT_THRESHOLD_MS = 50;
+
+    JankCommand::JankCommand(Connection * const socket,
+                             QObject* parent)
+        : Command(parent),
+          client(socket)
+    {
+    }
+
+    JankCommand::~JankCommand()
+    {
+    }
+
+    bool JankCommand::executeCommand(QStringList * const arguments)
+    {
+        bool ret = false;
+        JankMonitor * const monitor = JankMonitor::instance();
+        const QString subCommand = arguments->isEmpty() ? QString() : arguments->takeFirst();
+        if (subCommand.isNull())
+        {
+            // not translated; protocol
+            this->client->write(QString("OK ") + monitor->summary(MAX_REPLY) + "\r\n");
+        }
+        else if (subCommand == "start" and arguments->size() <= 2)
+        {
+            bool intervalOk = true;
+            bool thresholdOk = true;
+            const int interval = arguments->isEmpty() ?
+                        DEFAULT_INTERVAL_MS : arguments->at(0).toInt(&intervalOk);
+            const int threshold = arguments->size() < 2 ?
+                        DEFAULT_THRESHOLD_MS : arguments->at(1).toInt(&thresholdOk);
+            if (not intervalOk or not thresholdOk or interval < 1 or threshold < 1)
+            {
+                this->client->write(tr("ERROR: The interval and threshold must be " \
+                                       "at least 1ms") + "\r\n");
+            }
+            else
+            {
+                monitor->start(interval, threshold);
+                ret = true;
+            }
+        }
+        else if (subCommand == "stop" and arguments->isEmpty())
+        {
+            monitor->stop();
+            ret = true;
+        }
+        else if (subCommand == "reset" and arguments->isEmpty())
+        {
+            monitor->reset();
+            ret = true;
+        }
+        else if (subCommand == "assert" and arguments->size() == 1)
+        {
+            bool ok = false;
+            const int limit = arguments->first().toInt(&ok);
+            if (not ok or limit < 1)
+            {
+                this->client->write(tr("ERROR: The limit must be at least 1ms") + "\r\n");
+            }
+            else if (not monitor->isRunning())
+            {
+                this->client->write(tr("ERROR: jank isn't running") + "\r\n");
+            }
+            else if (monitor->maxLateMs() >= limit)
+            {
+                // beats under the threshold aren't kept so what ran isn't known
+                const qint64 lateMs = monitor->maxLateMs();
+                if (monitor->worstMs() == lateMs)
+                {
+                    this->client->write(tr("ERROR: The UI thread stalled for %1ms (%2)")
+                                        .arg(lateMs)
+                                        .arg(monitor->worstCommand()) + "\r\n");
+                }
+                else
+                {
+                    this->client->write(tr("ERROR: The UI thread stalled for %1ms")
+                                        .arg(lateMs) + "\r\n");
+                }
+            }
+            else
+            {
+                ret = true;
+            }
+        }
+        else
+        {
+            this->client->write(tr("ERROR: jank [start [<interval> [<threshold>]]" \
+                                   "|stop|reset|assert <ms>]") + "\r\n");
+        }
+        return ret;
+    }
+
+    void JankCommand::showHelp()
+    {
+        this->client->write(tr("> jank") + "\r\n");
+        this->client->write(tr("> jank start [<interval ms> [<threshold ms>]]") + "\r\n");
+        this->client->write(tr("> jank stop") + "\r\n");
+        this->client->write(tr("> jank reset") + "\r\n");
+        this->client->write(tr("> jank assert <ms>") + "\r\n");
+        this->client->write(tr("Start a heartbeat on the UI thread (every 5ms by default) " \
+                               "and record") + "\r\n");
+        this->client->write(tr("the times it was late by the threshold (50ms by default) " \
+                               "or more along") + "\r\n");
+        this->client->write(tr("with the commands that ran meanwhile (app if none did). " \
+                               "jank shows a") + "\r\n");
+        this->client->write(tr("histogram of the delays and the worst stalls. Assert " \
+                               "fails if any beat") + "\r\n");
+        this->client->write(tr("was as late as <ms>, even under the threshold.") + "\r\n");
+    }
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
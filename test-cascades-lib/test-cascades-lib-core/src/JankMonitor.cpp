@@ -0,0 +1,177 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#include "JankMonitor.h"
+
+#include <QStringList>
+
+#include "Profiler.h"
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    const int JankMonitor::MAX_WORST = 10;
+    JankMonitor * JankMonitor::singleton = NULL;
+
+    JankMonitor * JankMonitor::instance()
+    {
+        if (not JankMonitor::singleton)
+        {
+            JankMonitor::singleton = new JankMonitor();
+        }
+        return JankMonitor::singleton;
+    }
+
+    JankMonitor::JankMonitor()
+        : QObject(NULL),
+          thresholdMs(0)
+    {
+        connect(&this->timer, SIGNAL(timeout()), SLOT(beat()));
+        this->reset();
+    }
+
+    JankMonitor::~JankMonitor()
+    {
+    }
+
+    void JankMonitor::start(const int intervalMs, const int threshold)
+    {
+        this->thresholdMs = threshold;
+        this->reset();
+        this->timer.setInterval(intervalMs);
+        this->timer.start();
+        this->sinceBeat.start();
+    }
+
+    void JankMonitor::stop(void)
+    {
+        this->timer.stop();
+    }
+
+    void JankMonitor::reset(void)
+    {
+        this->beats = 0;
+        this->stalls = 0;
+        this->maxLateUs = 0;
+        for (int i = 0 ; i < BUCKETS ; i++)
+        {
+            this->buckets[i] = 0;
+        }
+        this->worst.clear();
+        this->lastCommandCount = Profiler::commandCount();
+        this->uptime.start();
+        this->sinceBeat.start();
+    }
+
+    void JankMonitor::beat(void)
+    {
+        const qint64 sinceUs = this->sinceBeat.nsecsElapsed() / 1000;
+        this->sinceBeat.start();
+        const qint64 lateUs = qMax(static_cast<qint64>(0),
+                                   sinceUs - this->timer.interval() * 1000);
+
+        // bucket n holds beats less than 2^n us late
+        int bucket = 0;
+        for (qint64 us = lateUs ; us > 0 and bucket < BUCKETS - 1 ; us >>= 1)
+        {
+            bucket++;
+        }
+        this->buckets[bucket]++;
+        this->beats++;
+        this->maxLateUs = qMax(this->maxLateUs, lateUs);
+
+        // commands run on this thread so any since the last beat ran
+        // during the stall (the counter goes back to 0 on a stats reset)
+        const quint64 commandCount = Profiler::commandCount();
+        const quint64 commands = commandCount >= this->lastCommandCount ?
+                    commandCount - this->lastCommandCount : commandCount;
+        this->lastCommandCount = commandCount;
+
+        if (lateUs < this->thresholdMs * 1000)
+        {
+            return;
+        }
+        this->stalls++;
+        Stall stall;
+        stall.lateMs = lateUs / 1000;
+        stall.atMs = this->uptime.elapsed();
+        stall.command = commands > 0 ? Profiler::lastCommand() : QString("app");
+        stall.commands = commands;
+
+        int i = 0;
+        while (i < this->worst.size() and this->worst.at(i).lateMs >= stall.lateMs)
+        {
+            i++;
+        }
+        if (i < MAX_WORST)
+        {
+            this->worst.insert(i, stall);
+            if (this->worst.size() > MAX_WORST)
+            {
+                this->worst.removeLast();
+            }
+        }
+    }
+
+    qint64 JankMonitor::worstMs(void) const
+    {
+        return this->worst.isEmpty() ? 0 : this->worst.first().lateMs;
+    }
+
+    QString JankMonitor::worstCommand(void) const
+    {
+        return this->worst.isEmpty() ? QString() : this->worst.first().command;
+    }
+
+    qint64 JankMonitor::percentileUs(const int percent) const
+    {
+        const quint64 wanted = qMax(static_cast<quint64>(1),
+                                    (this->beats * percent + 99) / 100);
+        quint64 seen = 0;
+        for (int i = 0 ; i < BUCKETS ; i++)
+        {
+            seen += this->buckets[i];
+            if (seen >= wanted)
+            {
+                return qMin((static_cast<qint64>(1) << i) - 1, this->maxLateUs);
+            }
+        }
+        return this->maxLateUs;
+    }
+
+    QString JankMonitor::summary(const int maxLength) const
+    {
+        QString line = QString("running=%1 interval=%2ms threshold=%3ms up=%4ms"
+                               " beats=%5 stalls=%6 p50=%7us p99=%8us max=%9us")
+                .arg(this->isRunning() ? 1 : 0)
+                .arg(this->timer.interval())
+                .arg(this->thresholdMs)
+                .arg(this->uptime.elapsed())
+                .arg(this->beats)
+                .arg(this->stalls)
+                .arg(this->percentileUs(50))
+                .arg(this->percentileUs(99))
+                .arg(this->maxLateUs);
+        for (int i = 0 ; i < this->worst.size() ; i++)
+        {
+            const Stall& stall = this->worst.at(i);
+            QString entry = QString("; %1ms %2").arg(stall.lateMs).arg(stall.command);
+            if (stall.commands > 1)
+            {
+                entry += QString("(+%1)").arg(stall.commands - 1);
+            }
+            entry += QString(" at %1ms").arg(stall.atMs);
+            if (line.length() + entry.length() > maxLength)
+            {
+                break;
+            }
+            line += entry;
+        }
+        return line;
+    }
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
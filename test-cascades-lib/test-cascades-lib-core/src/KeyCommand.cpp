@@ -9,6 +9,7 @@
 
 #include "Utils.h"
 #include "Connection.h"
+#include "TypeCommand.h"
 
 using bb::cascades::AbstractTextControl;
 using bb::cascades::Application;
@@ -108,9 +109,11 @@ namespace cascades
                         {
                             if (theKey >= ' ' and theKey <= 'z')
                             {
-                                field->setProperty("text",
-                                                   QVariant(field->property("text").toString()
-                                                              + QChar(theKey)));
+                                // appended as it always was, without copying the text
+                                if (not TypeCommand::insertText(field, QChar(theKey), true))
+                                {
+                                    field->setText(field->text() + QChar(theKey));
+                                }
                             }
                             else
                             {
@@ -0,0 +1,146 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#include "LeakCommand.h"
+
+#include <QString>
+#include <QObject>
+#include <QPair>
+#include <QtAlgorithms>
+
+#include "Connection.h"
+#include "LeakTracker.h"
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    const QString LeakCommand::CMD_NAME = "leak";
+    const int LeakCommand::MAX_REPLY = 1000;
+
+    /*!
+     * \brief moreSurvivors Order buckets by the most survivors
+     */
+    static bool moreSurvivors(const QPair<int, QString>& a,
+                              const QPair<int, QString>& b)
+    {
+        return a.first > b.first;
+    }
+
+    LeakCommand::LeakCommand(Connection * const socket,
+                             QObject* parent)
+        : Command(parent),
+          client(socket)
+    {
+    }
+
+    LeakCommand::~LeakCommand()
+    {
+    }
+
+    bool LeakCommand::executeCommand(QStringList * const arguments)
+    {
+        bool ret = false;
+        LeakTracker * const tracker = LeakTracker::instance();
+        const QString subCommand = arguments->isEmpty() ? QString() : arguments->takeFirst();
+        if (subCommand.isNull())
+        {
+            // not translated; protocol
+            this->client->write(QString("OK tracking=%1 created=%2 destroyed=%3")
+                                .arg(tracker->isTracking() ? 1 : 0)
+                                .arg(tracker->created())
+                                .arg(tracker->destroyed()) + "\r\n");
+        }
+        else if (subCommand == "begin" and arguments->isEmpty())
+        {
+            tracker->begin();
+            ret = true;
+        }
+        else if (subCommand == "end" and arguments->size() <= 1)
+        {
+            bool ok = true;
+            const int allowed = arguments->isEmpty() ? -1 : arguments->first().toInt(&ok);
+            if (not ok or (not arguments->isEmpty() and allowed < 0))
+            {
+                this->client->write(tr("ERROR: leak end [<allowed survivors>]") + "\r\n");
+            }
+            else if (not tracker->isTracking())
+            {
+                this->client->write(tr("ERROR: leak begin hasn't been called") + "\r\n");
+            }
+            else
+            {
+                tracker->end();
+                int survived = 0;
+                foreach (const int count, tracker->survivors())
+                {
+                    survived += count;
+                }
+                QString reply;
+                if (allowed >= 0 and survived > allowed)
+                {
+                    reply = tr("ERROR: %1 objects survived").arg(survived);
+                }
+                else
+                {
+                    // not translated; protocol
+                    reply = QString("OK created=%1 destroyed=%2 survived=%3")
+                            .arg(tracker->created())
+                            .arg(tracker->destroyed())
+                            .arg(survived);
+                }
+                this->client->write(reply + survivorList(reply.length()) + "\r\n");
+            }
+        }
+        else
+        {
+            this->client->write(tr("ERROR: leak [begin|end [<allowed survivors>]]") + "\r\n");
+        }
+        return ret;
+    }
+
+    QString LeakCommand::survivorList(const int length)
+    {
+        const QHash<QString, int>& survivors = LeakTracker::instance()->survivors();
+        QList<QPair<int, QString> > buckets;
+        for (QHash<QString, int>::const_iterator it = survivors.constBegin() ;
+             it not_eq survivors.constEnd() ;
+             ++it)
+        {
+            buckets.append(qMakePair(it.value(), it.key()));
+        }
+        qStableSort(buckets.begin(), buckets.end(), moreSurvivors);
+
+        QString list;
+        for (int i = 0 ; i < buckets.size() ; i++)
+        {
+            const QString entry = QString("; %1=%2")
+                    .arg(buckets.at(i).second)
+                    .arg(buckets.at(i).first);
+            if (length + list.length() + entry.length() > MAX_REPLY)
+            {
+                break;
+            }
+            list += entry;
+        }
+        return list;
+    }
+
+    void LeakCommand::showHelp()
+    {
+        this->client->write(tr("> leak") + "\r\n");
+        this->client->write(tr("> leak begin") + "\r\n");
+        this->client->write(tr("> leak end [<allowed survivors>]") + "\r\n");
+        this->client->write(tr("Track the QObjects created with a parent from begin " \
+                               "until end, then") + "\r\n");
+        this->client->write(tr("show how many are still alive by class@parent, most " \
+                               "first. Objects") + "\r\n");
+        this->client->write(tr("waiting to be deleted later are deleted first. With " \
+                               "<allowed survivors>") + "\r\n");
+        this->client->write(tr("it's an error if more than that survived.") + "\r\n");
+    }
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
@@ -0,0 +1,141 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#include "LeakTracker.h"
+
+#include <QChildEvent>
+#include <QCoreApplication>
+#include <QEvent>
+#include <bb/cascades/Application>
+
+#include "Command.h"
+#include "Connection.h"
+#include "Utils.h"
+
+using bb::cascades::Application;
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    LeakTracker * LeakTracker::singleton = NULL;
+
+    LeakTracker * LeakTracker::instance()
+    {
+        if (not LeakTracker::singleton)
+        {
+            LeakTracker::singleton = new LeakTracker();
+        }
+        return LeakTracker::singleton;
+    }
+
+    LeakTracker::LeakTracker()
+        : QObject(NULL),
+          tracking(false),
+          createdCount(0),
+          destroyedCount(0)
+    {
+    }
+
+    LeakTracker::~LeakTracker()
+    {
+        if (this->tracking)
+        {
+            Application::instance()->removeEventFilter(this);
+        }
+    }
+
+    void LeakTracker::begin(void)
+    {
+        if (this->tracking)
+        {
+            Application::instance()->removeEventFilter(this);
+        }
+        foreach (QObject * const object, this->live.keys())
+        {
+            disconnect(object, SIGNAL(destroyed(QObject*)),
+                       this, SLOT(objectDestroyed(QObject*)));
+        }
+        this->live.clear();
+        this->survivorCounts.clear();
+        this->createdCount = 0;
+        this->destroyedCount = 0;
+        // objects the last command deleted later aren't new leaks
+        QCoreApplication::sendPostedEvents(NULL, QEvent::DeferredDelete);
+        this->tracking = true;
+        Application::instance()->installEventFilter(this);
+    }
+
+    void LeakTracker::end(void)
+    {
+        if (not this->tracking)
+        {
+            return;
+        }
+        // objects going away are deleted before they're counted
+        QCoreApplication::sendPostedEvents(NULL, QEvent::DeferredDelete);
+        Application::instance()->removeEventFilter(this);
+        this->tracking = false;
+
+        this->survivorCounts.clear();
+        for (QHash<QObject*, QPointer<QObject> >::const_iterator it = this->live.constBegin() ;
+             it not_eq this->live.constEnd() ;
+             ++it)
+        {
+            const QObject * const object = it.key();
+            if (this->isHarnessObject(object))
+            {
+                continue;
+            }
+            // the path is only worked out for the survivors
+            const QObject * const parent = object->parent() ? object->parent() : it.value();
+            this->survivorCounts[QString(object->metaObject()->className()) + "@"
+                                 + (parent ? Utils::objectPath(parent) : QString("-"))]++;
+        }
+    }
+
+    bool LeakTracker::isHarnessObject(const QObject * object) const
+    {
+        for ( ; object ; object = object->parent())
+        {
+            // Command has no meta object of its own
+            if (object == this
+                    or dynamic_cast<const Command*>(object)
+                    or qobject_cast<const Connection*>(object))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // cppcheck-suppress unusedFunction
+    bool LeakTracker::eventFilter(QObject * const receiver, QEvent * const event)
+    {
+        if (event->type() == QEvent::ChildAdded)
+        {
+            QObject * const child = static_cast<QChildEvent*>(event)->child();
+            // reparented objects are only counted once
+            if (child and not this->live.contains(child))
+            {
+                this->live.insert(child, receiver);
+                this->createdCount++;
+                connect(child, SIGNAL(destroyed(QObject*)),
+                        this, SLOT(objectDestroyed(QObject*)));
+            }
+        }
+        return false;
+    }
+
+    void LeakTracker::objectDestroyed(QObject * object)
+    {
+        if (this->live.remove(object) > 0)
+        {
+            this->destroyedCount++;
+        }
+    }
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
@@ -16,6 +16,7 @@
 #include <bb/cascades/AbstractActionItem>
 
 #include "Connection.h"
+#include "PropertyCache.h"
 #include "Utils.h"
 
 using bb::cascades::ListView;
@@ -385,9 +386,11 @@ namespace cascades
                         Control * actionControl = NULL;
                         QList<Control*> controls
                                 = listView->findChildren<Control*>();
+                        const QByteArray componentProperty = listComponentKey.toUtf8();
                         Q_FOREACH(Control * control, controls)
                         {
-                            if (control->property(listComponentKey.toUtf8().constData()).toString()
+                            if (PropertyCache::read(control,
+                                                    componentProperty.constData()).toString()
                                     == element.toMap()[dataModelKey].toString())
                             {
                                 actionControl = control;
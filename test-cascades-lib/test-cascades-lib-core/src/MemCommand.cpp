@@ -0,0 +1,166 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#include "MemCommand.h"
+
+#include <QString>
+#include <QObject>
+#include <QPair>
+#include <QtAlgorithms>
+
+#include "Connection.h"
+#include "MemorySampler.h"
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    const QString MemCommand::CMD_NAME = "mem";
+    const int MemCommand::MAX_REPLY = 1000;
+
+    /*!
+     * \brief moreObjects Order classes by the most objects
+     */
+    static bool moreObjects(const QPair<int, QString>& a,
+                            const QPair<int, QString>& b)
+    {
+        return a.first > b.first;
+    }
+
+    MemCommand::MemCommand(Connection * const socket,
+                           QObject* parent)
+        : Command(parent),
+          client(socket)
+    {
+    }
+
+    MemCommand::~MemCommand()
+    {
+    }
+
+    bool MemCommand::executeCommand(QStringList * const arguments)
+    {
+        bool ret = false;
+        MemorySampler * const sampler = MemorySampler::instance();
+        const QString subCommand = arguments->isEmpty() ? QString() : arguments->takeFirst();
+        if (subCommand.isNull())
+        {
+            // not translated; protocol
+            this->client->write(QString("OK ")
+                                + MemorySampler::format(sampler->sample()) + "\r\n");
+        }
+        else if (subCommand == "objects" and arguments->size() <= 1)
+        {
+            bool ok = true;
+            // 0 is all of them
+            const int top = arguments->isEmpty() ? 0 : arguments->first().toInt(&ok);
+            if (not ok or top < 0)
+            {
+                this->client->write(tr("ERROR: mem objects [<count>]") + "\r\n");
+            }
+            else
+            {
+                const QHash<QString, int> counts = MemorySampler::countObjects();
+                QList<QPair<int, QString> > classes;
+                int total = 0;
+                for (QHash<QString, int>::const_iterator it = counts.constBegin() ;
+                     it not_eq counts.constEnd() ;
+                     ++it)
+                {
+                    classes.append(qMakePair(it.value(), it.key()));
+                    total += it.value();
+                }
+                qStableSort(classes.begin(), classes.end(), moreObjects);
+                QString reply = QString("OK total=%1 classes=%2").arg(total).arg(classes.size());
+                for (int i = 0 ; i < classes.size() and (top == 0 or i < top) ; i++)
+                {
+                    const QString entry = QString(" %1=%2")
+                            .arg(classes.at(i).second)
+                            .arg(classes.at(i).first);
+                    if (reply.length() + entry.length() > MAX_REPLY)
+                    {
+                        break;
+                    }
+                    reply += entry;
+                }
+                this->client->write(reply + "\r\n");
+            }
+        }
+        else if (subCommand == "start" and (arguments->size() == 1
+                                            or (arguments->size() == 2
+                                                and arguments->last() == "stream")))
+        {
+            bool ok = false;
+            const int interval = arguments->first().toInt(&ok);
+            if (not ok or interval < 1)
+            {
+                this->client->write(tr("ERROR: The interval must be at least 1ms") + "\r\n");
+            }
+            else
+            {
+                sampler->start(interval, arguments->size() == 2 ? this->client : NULL);
+                ret = true;
+            }
+        }
+        else if (subCommand == "stop" and arguments->isEmpty())
+        {
+            sampler->stop();
+            ret = true;
+        }
+        else if (subCommand == "clear" and arguments->isEmpty())
+        {
+            sampler->clear();
+            ret = true;
+        }
+        else if (subCommand == "samples" and arguments->isEmpty())
+        {
+            // the newest samples that fit, oldest first
+            const QList<MemorySampler::Sample>& samples = sampler->samples();
+            const QString header = QString("OK running=%1 samples=%2")
+                    .arg(sampler->isRunning() ? 1 : 0)
+                    .arg(samples.size());
+            QStringList entries;
+            int length = header.length();
+            for (int i = samples.size() - 1 ; i >= 0 ; i--)
+            {
+                const QString entry = QString("; ") + MemorySampler::format(samples.at(i));
+                if (length + entry.length() > MAX_REPLY)
+                {
+                    break;
+                }
+                length += entry.length();
+                entries.prepend(entry);
+            }
+            this->client->write(header + entries.join("") + "\r\n");
+        }
+        else
+        {
+            this->client->write(tr("ERROR: mem [objects [<count>]|start <interval> " \
+                                   "[stream]|stop|clear|samples]") + "\r\n");
+        }
+        return ret;
+    }
+
+    void MemCommand::showHelp()
+    {
+        this->client->write(tr("> mem") + "\r\n");
+        this->client->write(tr("> mem objects [<count>]") + "\r\n");
+        this->client->write(tr("> mem start <interval ms> [stream]") + "\r\n");
+        this->client->write(tr("> mem stop") + "\r\n");
+        this->client->write(tr("> mem clear") + "\r\n");
+        this->client->write(tr("> mem samples") + "\r\n");
+        this->client->write(tr("Show the resident, virtual and heap size (in kB), the " \
+                               "number of QObjects") + "\r\n");
+        this->client->write(tr("and the commands run so far. Objects shows the classes " \
+                               "with the most") + "\r\n");
+        this->client->write(tr("objects. Start samples on an interval, keeping the last " \
+                               "720 samples;") + "\r\n");
+        this->client->write(tr("with stream each sample is also written to this " \
+                               "connection as a # MEM line.") + "\r\n");
+        this->client->write(tr("Samples shows the newest samples that fit on a line.") + "\r\n");
+    }
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
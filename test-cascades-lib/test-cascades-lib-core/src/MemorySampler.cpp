@@ -0,0 +1,161 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#include "MemorySampler.h"
+
+#include <malloc.h>
+#include <unistd.h>
+#include <QFile>
+#include <QStringList>
+#include <bb/cascades/Application>
+#include <bb/cascades/AbstractPane>
+
+#include "Connection.h"
+#include "Profiler.h"
+
+using bb::cascades::Application;
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    const int MemorySampler::MAX_SAMPLES = 720;
+    MemorySampler * MemorySampler::singleton = NULL;
+
+    MemorySampler * MemorySampler::instance()
+    {
+        if (not MemorySampler::singleton)
+        {
+            MemorySampler::singleton = new MemorySampler();
+        }
+        return MemorySampler::singleton;
+    }
+
+    MemorySampler::MemorySampler()
+        : QObject(NULL)
+    {
+        connect(&this->timer, SIGNAL(timeout()), SLOT(sampleTimeout()));
+        this->uptime.start();
+    }
+
+    MemorySampler::~MemorySampler()
+    {
+    }
+
+    MemorySampler::Sample MemorySampler::sample(void) const
+    {
+        Sample s;
+        s.atMs = this->uptime.elapsed();
+        s.rssKb = -1;
+        s.vmKb = -1;
+
+        // size resident shared text lib data dt, in pages
+        QFile statm("/proc/self/statm");
+        if (statm.open(QIODevice::ReadOnly))
+        {
+            const QList<QByteArray> pages = statm.readAll().simplified().split(' ');
+            const qint64 pageKb = sysconf(_SC_PAGESIZE) / 1024;
+            if (pages.size() >= 2)
+            {
+                s.vmKb = pages.at(0).toLongLong() * pageKb;
+                s.rssKb = pages.at(1).toLongLong() * pageKb;
+            }
+        }
+
+        const struct mallinfo heap = mallinfo();
+        s.heapKb = heap.uordblks / 1024;
+
+        const QHash<QString, int> counts = countObjects();
+        s.objects = 0;
+        for (QHash<QString, int>::const_iterator it = counts.constBegin() ;
+             it not_eq counts.constEnd() ;
+             ++it)
+        {
+            s.objects += it.value();
+        }
+
+        s.commands = Profiler::commandCount();
+        s.command = Profiler::lastCommand();
+        return s;
+    }
+
+    QHash<QString, int> MemorySampler::countObjects(void)
+    {
+        QHash<QString, int> counts;
+        Application * const app = Application::instance();
+        countObjects(app, &counts);
+        // the scene isn't always a child of the application
+        const QObject * scene = app->scene();
+        const QObject * ancestor = scene;
+        while (ancestor and ancestor not_eq app)
+        {
+            ancestor = ancestor->parent();
+        }
+        if (scene and not ancestor)
+        {
+            countObjects(scene, &counts);
+        }
+        return counts;
+    }
+
+    void MemorySampler::countObjects(const QObject * const object,
+                                     QHash<QString, int> * const counts)
+    {
+        (*counts)[object->metaObject()->className()]++;
+        Q_FOREACH(const QObject * const child, object->children())
+        {
+            countObjects(child, counts);
+        }
+    }
+
+    void MemorySampler::start(const int intervalMs, Connection * const streamTo)
+    {
+        this->stream = streamTo;
+        this->timer.setInterval(intervalMs);
+        this->timer.start();
+    }
+
+    void MemorySampler::stop(void)
+    {
+        this->timer.stop();
+        this->stream = NULL;
+    }
+
+    void MemorySampler::clear(void)
+    {
+        this->stored.clear();
+    }
+
+    void MemorySampler::sampleTimeout(void)
+    {
+        const Sample s = this->sample();
+        this->stored.append(s);
+        if (this->stored.size() > MAX_SAMPLES)
+        {
+            this->stored.removeFirst();
+        }
+        if (this->stream)
+        {
+            // not translated; protocol, a comment so it isn't taken for a reply
+            this->stream->stream((QString("# MEM ") + format(s) + "\r\n").toUtf8(),
+                                 "MEM",
+                                 true);
+        }
+    }
+
+    QString MemorySampler::format(const Sample& sample)
+    {
+        return QString("at=%1ms rss=%2kB vm=%3kB heap=%4kB objects=%5 commands=%6 last=%7")
+                .arg(sample.atMs)
+                .arg(sample.rssKb)
+                .arg(sample.vmKb)
+                .arg(sample.heapKb)
+                .arg(sample.objects)
+                .arg(sample.commands)
+                .arg(sample.command.isEmpty() ? QString("-") : sample.command);
+    }
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
@@ -0,0 +1,304 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#include "MonkeyCommand.h"
+
+#include <QString>
+#include <QObject>
+
+#include <bb/cascades/AbstractActionItem>
+#include <bb/cascades/AbstractPane>
+#include <bb/cascades/AbstractToggleButton>
+#include <bb/cascades/Application>
+#include <bb/cascades/Control>
+#include <bb/cascades/DataModel>
+#include <bb/cascades/DropDown>
+#include <bb/cascades/ListView>
+#include <bb/cascades/NavigationPane>
+#include <bb/cascades/TabbedPane>
+#include <bb/cascades/TextArea>
+#include <bb/cascades/TextField>
+
+#include "Connection.h"
+#include "RunConnection.h"
+#include "CommandFactory.h"
+#include "Utils.h"
+
+using bb::cascades::AbstractActionItem;
+using bb::cascades::AbstractToggleButton;
+using bb::cascades::Application;
+using bb::cascades::Control;
+using bb::cascades::DropDown;
+using bb::cascades::ListView;
+using bb::cascades::NavigationPane;
+using bb::cascades::TabbedPane;
+using bb::cascades::TextArea;
+using bb::cascades::TextField;
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    const QString MonkeyCommand::CMD_NAME = "monkey";
+    const int MonkeyCommand::DEFAULT_STALL_MS = 2000;
+    const int MonkeyCommand::MAX_RATE = 1000;
+    const int MonkeyCommand::MAX_PER_TICK = 16;
+
+    MonkeyCommand::MonkeyCommand(Connection * const socket,
+                                 QObject* parent)
+        : Command(parent),
+          client(socket),
+          running(false),
+          trace(false),
+          state(0),
+          events(0),
+          rate(0),
+          stallMs(DEFAULT_STALL_MS),
+          played(0),
+          failed(0)
+    {
+        connect(&this->eventTimer, SIGNAL(timeout()), SLOT(tick()));
+    }
+
+    MonkeyCommand::~MonkeyCommand()
+    {
+    }
+
+    bool MonkeyCommand::executeCommand(QStringList * const arguments)
+    {
+        if (not arguments->isEmpty() and arguments->last() == "trace")
+        {
+            this->trace = true;
+            arguments->removeLast();
+        }
+        bool ok = arguments->size() == 3 or arguments->size() == 4;
+        const quint32 seed = ok ? arguments->at(0).toUInt(&ok) : 0;
+        this->events = ok ? arguments->at(1).toInt(&ok) : 0;
+        this->rate = ok ? arguments->at(2).toInt(&ok) : 0;
+        if (ok and arguments->size() == 4)
+        {
+            this->stallMs = arguments->at(3).toInt(&ok);
+        }
+        if (not ok or this->events < 1 or this->rate < 1 or this->rate > MAX_RATE
+                or this->stallMs < 1)
+        {
+            this->client->write(tr("ERROR: monkey <seed> <events> <events per second> " \
+                                   "[<stall ms>] [trace]") + "\r\n");
+            return false;
+        }
+        this->state = seed;
+
+        this->running = true;
+        connect(this->client,
+                SIGNAL(disconnected(Connection*const)),
+                SLOT(clientDisconnected()));
+        this->clock.start();
+        this->sinceTick.start();
+        this->eventTimer.start(qMax(1, 1000 / this->rate));
+        return false;
+    }
+
+    int MonkeyCommand::random(const int range)
+    {
+        // the same sequence on every device and build
+        this->state = this->state * 1664525u + 1013904223u;
+        return static_cast<int>((static_cast<quint64>(this->state) * range) >> 32);
+    }
+
+    void MonkeyCommand::findTargets(QObject * const object, QList<QObject*> * const targets)
+    {
+        const Control * const control = qobject_cast<Control*>(object);
+        if (control and (not control->isVisible() or not control->isEnabled()))
+        {
+            return;
+        }
+        const AbstractActionItem * const action = qobject_cast<AbstractActionItem*>(object);
+        if (control or (action and action->isEnabled()))
+        {
+            targets->append(object);
+        }
+        // only what's showing
+        const NavigationPane * const navPane = qobject_cast<NavigationPane*>(object);
+        const TabbedPane * const tabbedPane = qobject_cast<TabbedPane*>(object);
+        if (navPane)
+        {
+            if (navPane->top())
+            {
+                findTargets(navPane->top(), targets);
+            }
+        }
+        else if (tabbedPane)
+        {
+            if (tabbedPane->activePane())
+            {
+                findTargets(tabbedPane->activePane(), targets);
+            }
+        }
+        else
+        {
+            foreach (QObject * const child, object->children())
+            {
+                findTargets(child, targets);
+            }
+        }
+    }
+
+    QString MonkeyCommand::eventFor(QObject * const target)
+    {
+        const AbstractActionItem * const action = qobject_cast<AbstractActionItem*>(target);
+        if (action)
+        {
+            const QString name = action->objectName().isEmpty() ?
+                        action->title() : action->objectName();
+            return (name.isEmpty() or name.contains(' ')) ? QString() : "action " + name;
+        }
+        const QString path = Utils::objectPath(target);
+        if (path.contains(' '))
+        {
+            return QString();
+        }
+        if (qobject_cast<AbstractToggleButton*>(target))
+        {
+            return "toggle " + path + (this->random(2) ? " true" : " false");
+        }
+        const DropDown * const dropDown = qobject_cast<DropDown*>(target);
+        if (dropDown)
+        {
+            return dropDown->count() > 0 ?
+                        QString("dropdown %1 %2").arg(path).arg(this->random(dropDown->count()))
+                      : QString();
+        }
+        ListView * const listView = qobject_cast<ListView*>(target);
+        if (listView)
+        {
+            const int size = listView->dataModel() ?
+                        listView->dataModel()->childCount(listView->rootIndexPath()) : 0;
+            return size > 0 ?
+                        QString("list %1 tap index %2").arg(path).arg(this->random(size))
+                      : QString();
+        }
+        if (qobject_cast<TextField*>(target) or qobject_cast<TextArea*>(target))
+        {
+            // printable, or a backspace
+            const int key = this->random(8) ? ' ' + this->random('z' - ' ' + 1) : '\b';
+            return QString("key %1 1 0 0 0 %2").arg(key).arg(path);
+        }
+        return "click " + path;
+    }
+
+    void MonkeyCommand::play(void)
+    {
+        QList<QObject*> targets;
+        findTargets(Application::instance()->scene(), &targets);
+        QObject * const menu = Application::instance()->menu();
+        if (menu)
+        {
+            findTargets(menu, &targets);
+        }
+        QString event;
+        // a few goes at finding something that can be played
+        for (int i = 0 ; i < 4 and event.isEmpty() and not targets.isEmpty() ; i++)
+        {
+            event = this->eventFor(targets.at(this->random(targets.size())));
+        }
+        this->played++;
+        if (event.isEmpty())
+        {
+            this->failed++;
+            return;
+        }
+        this->lastEvent = event;
+        if (this->trace)
+        {
+            // not translated; protocol, scripts skip lines starting with #
+            this->client->stream(QString("# MONKEY %1 %2\r\n").arg(this->played).arg(event)
+                                 .toUtf8(), "MONKEY");
+        }
+
+        QStringList arguments = event.split(' ');
+        const QString command = arguments.takeFirst();
+        RunConnection * const capture = new RunConnection(this);
+        Command * const cmd = CommandFactory::getCommand(capture, command, this->parent());
+        if (cmd)
+        {
+            if (not cmd->executeCommand(&arguments))
+            {
+                // i.e. the index has gone since it was picked
+                this->failed++;
+            }
+            cmd->cleanUp();
+        }
+        // a long run would otherwise keep one for every event
+        capture->deleteLater();
+    }
+
+    void MonkeyCommand::commandReplied(const QString& reply)
+    {
+        Q_UNUSED(reply);
+    }
+
+    void MonkeyCommand::tick(void)
+    {
+        if (not this->running)
+        {
+            return;
+        }
+        const qint64 gapMs = this->sinceTick.restart();
+        if (gapMs > this->stallMs)
+        {
+            this->finish(tr("ERROR: Stalled for %1ms after event %2 {%3}")
+                         .arg(gapMs).arg(this->played).arg(this->lastEvent) + "\r\n");
+            return;
+        }
+        const qint64 due = qMin(static_cast<qint64>(this->events),
+                                this->clock.elapsed() * this->rate / 1000 + 1);
+        for (int i = 0 ; i < MAX_PER_TICK and this->played < due and this->running ; i++)
+        {
+            this->play();
+        }
+        if (this->running and this->played >= this->events)
+        {
+            // not translated; protocol
+            this->finish(QString("OK %1 %2 %3").arg(this->played).arg(this->failed)
+                         .arg(this->clock.elapsed()) + "\r\n");
+        }
+    }
+
+    void MonkeyCommand::clientDisconnected(void)
+    {
+        this->finish(QString());
+    }
+
+    void MonkeyCommand::finish(const QString& reply)
+    {
+        if (not this->running)
+        {
+            return;
+        }
+        this->running = false;
+        this->eventTimer.stop();
+        if (not reply.isEmpty())
+        {
+            this->client->write(reply);
+        }
+        this->deleteLater();
+    }
+
+    void MonkeyCommand::showHelp()
+    {
+        this->client->write(tr("> monkey <seed> <events> <events per second> [<stall ms>] " \
+                               "[trace]") + "\r\n");
+        this->client->write(tr("Play random clicks, keys, toggles, dropdowns, list taps and " \
+                               "actions at") + "\r\n");
+        this->client->write(tr("visible, enabled objects. The same seed plays the same " \
+                               "events. With trace") + "\r\n");
+        this->client->write(tr("each is sent as # MONKEY <n> <command>. Stops with an error " \
+                               "if the UI") + "\r\n");
+        this->client->write(tr("thread stalls (2000ms by default), otherwise replies " \
+                               "OK <events> <failed> <ms>.") + "\r\n");
+    }
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
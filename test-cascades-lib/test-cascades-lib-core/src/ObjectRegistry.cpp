@@ -0,0 +1,151 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#include "ObjectRegistry.h"
+
+#include <QChildEvent>
+#include <QEvent>
+#include <QTimer>
+#include <bb/cascades/AbstractActionItem>
+#include <bb/cascades/Application>
+#include <bb/system/SystemDialog>
+#include <bb/system/SystemPrompt>
+#include <bb/system/SystemToast>
+
+using bb::cascades::AbstractActionItem;
+using bb::cascades::Application;
+using bb::system::SystemDialog;
+using bb::system::SystemPrompt;
+using bb::system::SystemToast;
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    ObjectRegistry * ObjectRegistry::singleton = NULL;
+
+    ObjectRegistry * ObjectRegistry::instance()
+    {
+        if (not ObjectRegistry::singleton)
+        {
+            ObjectRegistry::singleton = new ObjectRegistry();
+        }
+        return ObjectRegistry::singleton;
+    }
+
+    ObjectRegistry::ObjectRegistry()
+        : QObject(NULL),
+          sortQueued(false)
+    {
+        this->types.append(&SystemToast::staticMetaObject);
+        this->types.append(&SystemDialog::staticMetaObject);
+        this->types.append(&SystemPrompt::staticMetaObject);
+        this->types.append(&AbstractActionItem::staticMetaObject);
+
+        // the only walk, new objects are seen as they're added
+        foreach (QObject * const object, Application::instance()->findChildren<QObject*>())
+        {
+            this->add(object);
+        }
+        Application::instance()->installEventFilter(this);
+    }
+
+    ObjectRegistry::~ObjectRegistry()
+    {
+        Application::instance()->removeEventFilter(this);
+    }
+
+    // cppcheck-suppress unusedFunction
+    bool ObjectRegistry::eventFilter(QObject * const receiver, QEvent * const event)
+    {
+        Q_UNUSED(receiver);
+        if (event->type() == QEvent::ChildAdded)
+        {
+            this->added.append(static_cast<QChildEvent*>(event)->child());
+            if (not this->sortQueued)
+            {
+                this->sortQueued = true;
+                QTimer::singleShot(0, this, SLOT(sort()));
+            }
+        }
+        return false;
+    }
+
+    void ObjectRegistry::sort(void)
+    {
+        this->sortQueued = false;
+        // registering may add more
+        while (not this->added.isEmpty())
+        {
+            const QList<QPointer<QObject> > fresh = this->added;
+            this->added.clear();
+            foreach (const QPointer<QObject>& object, fresh)
+            {
+                if (object)
+                {
+                    this->add(object);
+                    // i.e. a component's tree, parented before its root was
+                    foreach (QObject * const child, object->findChildren<QObject*>())
+                    {
+                        this->add(child);
+                    }
+                }
+            }
+        }
+    }
+
+    void ObjectRegistry::add(QObject * const object)
+    {
+        for (const QMetaObject * meta = object->metaObject() ; meta ; meta = meta->superClass())
+        {
+            if (this->types.contains(meta))
+            {
+                QHash<QObject*, QPointer<QObject> >& ofType = this->live[meta];
+                // reparented, or a deleted object's address reused
+                if (ofType.value(object) not_eq object)
+                {
+                    ofType.insert(object, object);
+                    emit registered(object);
+                }
+                return;
+            }
+        }
+    }
+
+    QList<QObject*> ObjectRegistry::objects(const QMetaObject& type)
+    {
+        this->sort();
+        QList<QObject*> found;
+        QHash<QObject*, QPointer<QObject> >& ofType = this->live[&type];
+        QHash<QObject*, QPointer<QObject> >::iterator it = ofType.begin();
+        while (it not_eq ofType.end())
+        {
+            if (it.value())
+            {
+                found.append(it.value());
+                ++it;
+            }
+            else
+            {
+                it = ofType.erase(it);
+            }
+        }
+        return found;
+    }
+
+    QObject * ObjectRegistry::find(const QMetaObject& type, const QString& name)
+    {
+        foreach (QObject * const object, this->objects(type))
+        {
+            if (object->objectName() == name)
+            {
+                return object;
+            }
+        }
+        return NULL;
+    }
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
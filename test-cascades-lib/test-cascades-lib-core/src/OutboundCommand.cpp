@@ -0,0 +1,109 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#include "OutboundCommand.h"
+
+#include <QString>
+#include <QObject>
+
+#include "Connection.h"
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    const QString OutboundCommand::CMD_NAME = "outbound";
+
+    OutboundCommand::OutboundCommand(Connection * const socket,
+                                     QObject* parent)
+        : Command(parent),
+          client(socket)
+    {
+    }
+
+    OutboundCommand::~OutboundCommand()
+    {
+    }
+
+    bool OutboundCommand::executeCommand(QStringList * const arguments)
+    {
+        bool ret = false;
+        if (arguments->isEmpty())
+        {
+            // not translated; protocol
+            this->client->write(QString("OK ") + this->client->queueStats() + "\r\n");
+        }
+        else if (arguments->size() <= 2)
+        {
+            const QString policyName = arguments->first();
+            Connection::OverflowPolicy policy = Connection::DROP_OLDEST;
+            bool known = true;
+            if (policyName == "block")
+            {
+                policy = Connection::BLOCK;
+            }
+            else if (policyName == "coalesce")
+            {
+                policy = Connection::COALESCE;
+            }
+            else if (policyName == "drop-oldest")
+            {
+                policy = Connection::DROP_OLDEST;
+            }
+            else if (policyName == "disconnect")
+            {
+                policy = Connection::DISCONNECT;
+            }
+            else
+            {
+                known = false;
+            }
+            bool ok = true;
+            const qint64 limitKb = arguments->size() == 2 ?
+                        arguments->last().toLongLong(&ok) : 4096;
+            if (not known)
+            {
+                this->client->write(tr("ERROR: Unknown policy") + "\r\n");
+            }
+            else if (not ok or limitKb < 0)
+            {
+                this->client->write(tr("ERROR: The limit must be a number of kB") + "\r\n");
+            }
+            else
+            {
+                this->client->setOverflow(policy, limitKb * 1024);
+                ret = true;
+            }
+        }
+        else
+        {
+            this->client->write(tr("ERROR: outbound " \
+                                   "[block|coalesce|drop-oldest|disconnect [<limit kB>]]")
+                                + "\r\n");
+        }
+        return ret;
+    }
+
+    void OutboundCommand::showHelp()
+    {
+        this->client->write(tr("> outbound") + "\r\n");
+        this->client->write(tr("> outbound <block|coalesce|drop-oldest|disconnect> " \
+                               "[<limit kB>]") + "\r\n");
+        this->client->write(tr("Show the bytes queued for this connection, the most queued, " \
+                               "and what was") + "\r\n");
+        this->client->write(tr("dropped, coalesced or blocked. Replies are always sent; " \
+                               "streamed data") + "\r\n");
+        this->client->write(tr("(recordings, mem) over the limit (4096kB by default, 0 for " \
+                               "none) blocks") + "\r\n");
+        this->client->write(tr("the UI thread for up to a second each event loop pass, " \
+                               "replaces queued") + "\r\n");
+        this->client->write(tr("mem samples with the newest, is replaced oldest first by a " \
+                               "# GAP <n>") + "\r\n");
+        this->client->write(tr("line or disconnects. Recorded events aren't coalesced, " \
+                               "they're dropped.") + "\r\n");
+    }
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
@@ -0,0 +1,247 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#include "ProbeCommand.h"
+
+#include <QString>
+#include <QObject>
+#include <QMetaProperty>
+
+#include "Connection.h"
+#include "RunConnection.h"
+#include "CommandFactory.h"
+#include "PropertyCache.h"
+#include "RecordCommand.h"
+#include "RunCommand.h"
+#include "ExitCommand.h"
+#include "QuitCommand.h"
+#include "Utils.h"
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    const QString ProbeCommand::CMD_NAME = "probe";
+    const int ProbeCommand::POLL_MS = 1;
+
+    ProbeCommand::ProbeCommand(Connection * const socket,
+                               QObject* parent)
+        : Command(parent),
+          client(socket),
+          probing(false),
+          equal(true),
+          notified(false)
+    {
+        this->pollTimer.setInterval(POLL_MS);
+        this->timeoutTimer.setSingleShot(true);
+        connect(&this->pollTimer, SIGNAL(timeout()), SLOT(check()));
+        connect(&this->timeoutTimer, SIGNAL(timeout()), SLOT(timedOut()));
+    }
+
+    ProbeCommand::~ProbeCommand()
+    {
+    }
+
+    bool ProbeCommand::executeCommand(QStringList * const arguments)
+    {
+        const int until = arguments->lastIndexOf("until");
+        bool timeoutOk = false;
+        const int timeout = arguments->isEmpty() ? 0 : arguments->first().toInt(&timeoutOk);
+        // probe <timeout> <command...> until <object> <property> [==|!=] <value>
+        if (not timeoutOk or timeout < 1 or until < 2 or arguments->size() - until < 3)
+        {
+            this->client->write(tr("ERROR: probe <timeout> <command> until <object> " \
+                                   "<property> [==|!=] <value>") + "\r\n");
+            return false;
+        }
+
+        QStringList action = arguments->mid(1, until - 1);
+        QStringList condition = arguments->mid(until + 1);
+        this->objectName = condition.takeFirst();
+        this->propertyName = condition.takeFirst().toUtf8();
+        if (not condition.isEmpty()
+                and (condition.first() == "==" or condition.first() == "!="))
+        {
+            this->equal = condition.takeFirst() == "==";
+        }
+        this->expected = Utils::untokenise(", ", condition);
+        if (this->expected.length() >= 2
+                and this->expected.startsWith('"') and this->expected.endsWith('"'))
+        {
+            this->expected = this->expected.mid(1, this->expected.length() - 2);
+        }
+
+        const QString command = action.takeFirst();
+        if (command == CMD_NAME
+                or command == RunCommand::getCmd()
+                or command == RecordCommand::getCmd()
+                or command == ExitCommand::getCmd()
+                or command == QuitCommand::getCmd())
+        {
+            this->client->write(tr("ERROR: That command can't be probed") + "\r\n");
+            return false;
+        }
+        QString actual;
+        if (this->conditionMet(&actual))
+        {
+            this->client->write(tr("ERROR: The condition is met before the command") + "\r\n");
+            return false;
+        }
+
+        this->probing = true;
+        connect(this->client,
+                SIGNAL(disconnected(Connection*const)),
+                SLOT(clientDisconnected()));
+        this->timeoutTimer.start(timeout);
+        // a poll would skew what's measured, so only without a notify
+        if (not this->notified)
+        {
+            this->pollTimer.start();
+        }
+        this->clock.start();
+
+        RunConnection * const capture = new RunConnection(this);
+        Command * const cmd = CommandFactory::getCommand(capture,
+                                                         command,
+                                                         this->parent());
+        if (cmd)
+        {
+            if (cmd->executeCommand(&action))
+            {
+                // not translated; protocol
+                capture->write(QString("OK") + "\r\n");
+            }
+            cmd->cleanUp();
+        }
+        else
+        {
+            capture->write(tr("ERROR: I don't understand that command") + "\r\n");
+        }
+        // the command may have done it already
+        this->check();
+        return false;
+    }
+
+    bool ProbeCommand::conditionMet(QString * const actual)
+    {
+        if (not this->object)
+        {
+            this->object = Utils::findObject(this->objectName);
+            this->notified = false;
+        }
+        if (not this->object)
+        {
+            return false;
+        }
+        if (not this->notified)
+        {
+            // checked as soon as it changes rather than on the next poll
+            const QMetaProperty property =
+                    PropertyCache::property(this->object, this->propertyName.constData());
+            if (property.hasNotifySignal())
+            {
+                this->notified = QMetaObject::connect(
+                            this->object,
+                            property.notifySignalIndex(),
+                            this,
+                            this->metaObject()->indexOfSlot("check()"),
+                            Qt::DirectConnection);
+            }
+            if (this->notified)
+            {
+                connect(this->object, SIGNAL(destroyed()), SLOT(objectDestroyed()));
+                this->pollTimer.stop();
+            }
+        }
+        *actual = PropertyCache::read(this->object, this->propertyName.constData()).toString();
+        return (*actual == this->expected) == this->equal;
+    }
+
+    void ProbeCommand::check(void)
+    {
+        if (not this->probing)
+        {
+            return;
+        }
+        const qint64 elapsedUs = this->clock.nsecsElapsed() / 1000;
+        QString actual;
+        if (this->conditionMet(&actual))
+        {
+            // not translated; protocol
+            this->finish(QString("OK %1").arg(elapsedUs) + "\r\n");
+        }
+    }
+
+    void ProbeCommand::commandReplied(const QString& reply)
+    {
+        if (this->probing and reply.startsWith("ERROR"))
+        {
+            this->finish(tr("ERROR: The command failed: %1").arg(reply) + "\r\n");
+        }
+    }
+
+    void ProbeCommand::timedOut(void)
+    {
+        // it may have changed without a notify since the last poll
+        this->check();
+        if (this->probing)
+        {
+            QString actual;
+            this->conditionMet(&actual);
+            this->finish((this->object ? tr("ERROR: Timed out, the value is {%1}").arg(actual)
+                                       : tr("ERROR: Timed out, the element doesn't exist"))
+                         + "\r\n");
+        }
+    }
+
+    void ProbeCommand::clientDisconnected(void)
+    {
+        this->finish(QString());
+    }
+
+    void ProbeCommand::objectDestroyed(void)
+    {
+        this->notified = false;
+        if (this->probing)
+        {
+            this->pollTimer.start();
+        }
+    }
+
+    void ProbeCommand::finish(const QString& reply)
+    {
+        if (not this->probing)
+        {
+            return;
+        }
+        this->probing = false;
+        this->pollTimer.stop();
+        this->timeoutTimer.stop();
+        if (this->object)
+        {
+            disconnect(this->object, NULL, this, NULL);
+        }
+        if (not reply.isEmpty())
+        {
+            this->client->write(reply);
+        }
+        this->deleteLater();
+    }
+
+    void ProbeCommand::showHelp()
+    {
+        this->client->write(tr("> probe <timeout> <command> until <object> <property> " \
+                               "[==|!=] <value>") + "\r\n");
+        this->client->write(tr("Run the command and reply with the time (in us) until " \
+                               "the object's") + "\r\n");
+        this->client->write(tr("property is (==, the default) or isn't (!=) the value, " \
+                               "or an error") + "\r\n");
+        this->client->write(tr("after <timeout> ms. The value may be quoted. The property " \
+                               "mustn't match") + "\r\n");
+        this->client->write(tr("before the command is run.") + "\r\n");
+    }
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
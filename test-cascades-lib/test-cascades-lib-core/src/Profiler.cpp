@@ -0,0 +1,428 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#include "Profiler.h"
+
+#include <QCoreApplication>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QStringList>
+#include <QThread>
+#include <QtAlgorithms>
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    /*!
+     * \brief BUCKETS The number of power of two histogram buckets
+     */
+    static const int BUCKETS = 32;
+
+    /*!
+     * \brief The CommandProfile class holds the counters for one verb
+     *
+     * @since test-cascades 1.1.5
+     */
+    class CommandProfile
+    {
+    public:
+        /*!
+         * \brief CommandProfile Create empty counters
+         *
+         * @since test-cascades 1.1.5
+         */
+        CommandProfile()
+            : count(0),
+              maxNs(0)
+        {
+            for (int i = 0 ; i < Profiler::PHASES ; i++)
+            {
+                this->phaseNs[i] = 0;
+            }
+            for (int i = 0 ; i < BUCKETS ; i++)
+            {
+                this->buckets[i] = 0;
+            }
+        }
+        /*!
+         * \brief add Count a command
+         *
+         * \param totalNs How long the whole command took
+         *
+         * @since test-cascades 1.1.5
+         */
+        void add(const qint64 totalNs)
+        {
+            // bucket n holds times of less than 2^n us
+            int bucket = 0;
+            for (qint64 us = totalNs / 1000 ; us > 0 and bucket < BUCKETS - 1 ; us >>= 1)
+            {
+                bucket++;
+            }
+            this->buckets[bucket]++;
+            this->count++;
+            this->maxNs = qMax(this->maxNs, totalNs);
+        }
+        /*!
+         * \brief totalNs The time of all the phases
+         *
+         * \return The time in nanoseconds
+         *
+         * @since test-cascades 1.1.5
+         */
+        qint64 totalNs() const
+        {
+            qint64 total = 0;
+            for (int i = 0 ; i < Profiler::PHASES ; i++)
+            {
+                total += this->phaseNs[i];
+            }
+            return total;
+        }
+        /*!
+         * \brief percentileUs The upper bound of the bucket holding
+         * a percentile
+         *
+         * \param percent The percentile (0-100)
+         *
+         * \return The time in microseconds
+         *
+         * @since test-cascades 1.1.5
+         */
+        qint64 percentileUs(const int percent) const
+        {
+            const quint64 wanted = qMax(static_cast<quint64>(1),
+                                        (this->count * percent + 99) / 100);
+            quint64 seen = 0;
+            for (int i = 0 ; i < BUCKETS ; i++)
+            {
+                seen += this->buckets[i];
+                if (seen >= wanted)
+                {
+                    return qMin((static_cast<qint64>(1) << i) - 1, this->maxNs / 1000);
+                }
+            }
+            return this->maxNs / 1000;
+        }
+        /*!
+         * \brief count The number of commands
+         */
+        quint64 count;
+        /*!
+         * \brief phaseNs The time spent in each phase
+         */
+        qint64 phaseNs[Profiler::PHASES];
+        /*!
+         * \brief maxNs The longest command
+         */
+        qint64 maxNs;
+        /*!
+         * \brief buckets The histogram of command times
+         */
+        quint64 buckets[BUCKETS];
+    };
+
+    /*!
+     * \brief The ProfilerPrivate class holds the counters
+     *
+     * @since test-cascades 1.1.5
+     */
+    class ProfilerPrivate
+    {
+    public:
+        /*!
+         * \brief instance Get the counters
+         *
+         * \return The single instance
+         *
+         * @since test-cascades 1.1.5
+         */
+        static ProfilerPrivate * instance()
+        {
+            if (not ProfilerPrivate::singleton)
+            {
+                ProfilerPrivate::singleton = new ProfilerPrivate();
+            }
+            return ProfilerPrivate::singleton;
+        }
+        /*!
+         * \brief clear Reset all the counters
+         *
+         * @since test-cascades 1.1.5
+         */
+        void clear()
+        {
+            this->profiles.clear();
+            this->uiNs = 0;
+            this->commands = 0;
+            this->inCommand = false;
+            this->lastVerb.clear();
+            this->uptime.start();
+        }
+        /*!
+         * \brief onUiThread Check which thread we're on
+         *
+         * \return @c true if on the UI thread
+         *
+         * @since test-cascades 1.1.5
+         */
+        static bool onUiThread()
+        {
+            const QCoreApplication * const app = QCoreApplication::instance();
+            return app and QThread::currentThread() == app->thread();
+        }
+        /*!
+         * \brief profiles The counters keyed by verb
+         */
+        QHash<QString, CommandProfile> profiles;
+        /*!
+         * \brief uptime Time since the counters were reset
+         */
+        QElapsedTimer uptime;
+        /*!
+         * \brief uiNs Harness time on the UI thread
+         */
+        qint64 uiNs;
+        /*!
+         * \brief commands The number of commands run
+         */
+        quint64 commands;
+        /*!
+         * \brief lastVerb The verb of the last command
+         */
+        QString lastVerb;
+        /*!
+         * \brief inCommand @c true while a command is being timed
+         */
+        bool inCommand;
+        /*!
+         * \brief commandTimer Times the current command
+         */
+        QElapsedTimer commandTimer;
+        /*!
+         * \brief pendingNs The phases of the current command
+         */
+        qint64 pendingNs[Profiler::PHASES];
+    private:
+        /*!
+         * \brief ProfilerPrivate Create empty counters
+         */
+        ProfilerPrivate()
+        {
+            this->clear();
+        }
+        /*!
+         * \brief singleton The single instance
+         */
+        static ProfilerPrivate * singleton;
+    };
+
+    ProfilerPrivate * ProfilerPrivate::singleton = NULL;
+    ProfilerScope * ProfilerScope::innermost = NULL;
+
+    /*!
+     * \brief phaseValues Format the phase times of a profile
+     *
+     * \param profile The profile
+     *
+     * \return The phases in microseconds
+     */
+    static QString phaseValues(const CommandProfile& profile)
+    {
+        return QString(" parse=%1 find=%2 exec=%3 write=%4")
+                .arg(profile.phaseNs[Profiler::PARSE] / 1000)
+                .arg(profile.phaseNs[Profiler::FIND] / 1000)
+                .arg(profile.phaseNs[Profiler::EXECUTE] / 1000)
+                .arg(profile.phaseNs[Profiler::WRITE] / 1000);
+    }
+
+    /*!
+     * \brief busiestFirst Order verbs by the time they took
+     *
+     * \param left The first verb and its time
+     * \param right The second verb and its time
+     *
+     * \return @c true if @c left took longer
+     */
+    static bool busiestFirst(const QPair<qint64, QString>& left,
+                             const QPair<qint64, QString>& right)
+    {
+        return left.first > right.first;
+    }
+
+    void Profiler::commandStarted(void)
+    {
+        if (not ProfilerPrivate::onUiThread())
+        {
+            return;
+        }
+        ProfilerPrivate * const data = ProfilerPrivate::instance();
+        for (int i = 0 ; i < PHASES ; i++)
+        {
+            data->pendingNs[i] = 0;
+        }
+        data->inCommand = true;
+        data->commandTimer.start();
+    }
+
+    void Profiler::commandFinished(const QString& verb)
+    {
+        if (not ProfilerPrivate::onUiThread())
+        {
+            return;
+        }
+        ProfilerPrivate * const data = ProfilerPrivate::instance();
+        if (not data->inCommand)
+        {
+            return;
+        }
+        data->inCommand = false;
+        const qint64 totalNs = data->commandTimer.nsecsElapsed();
+        data->uiNs += totalNs;
+        if (not verb.isEmpty())
+        {
+            CommandProfile& profile = data->profiles[verb];
+            for (int i = 0 ; i < PHASES ; i++)
+            {
+                profile.phaseNs[i] += data->pendingNs[i];
+            }
+            profile.add(totalNs);
+            data->commands++;
+            data->lastVerb = verb;
+        }
+    }
+
+    void Profiler::record(const Phase phase, const qint64 ns)
+    {
+        if (not ProfilerPrivate::onUiThread())
+        {
+            return;
+        }
+        ProfilerPrivate * const data = ProfilerPrivate::instance();
+        if (data->inCommand)
+        {
+            data->pendingNs[phase] += ns;
+        }
+        else
+        {
+            // i.e. an async command writing its reply
+            CommandProfile& profile = data->profiles["async"];
+            profile.phaseNs[phase] += ns;
+            profile.add(ns);
+            data->uiNs += ns;
+        }
+    }
+
+    QString Profiler::summary(const int maxLength)
+    {
+        ProfilerPrivate * const data = ProfilerPrivate::instance();
+        const qint64 uptimeNs = qMax(static_cast<qint64>(1), data->uptime.nsecsElapsed());
+        QString line = QString("up=%1ms ui=%2us (%3%) commands=%4")
+                .arg(uptimeNs / 1000000)
+                .arg(data->uiNs / 1000)
+                .arg(100.0 * data->uiNs / uptimeNs, 0, 'f', 2)
+                .arg(data->commands);
+
+        QList<QPair<qint64, QString> > verbs;
+        QHash<QString, CommandProfile>::const_iterator it = data->profiles.constBegin();
+        for ( ; it not_eq data->profiles.constEnd() ; ++it)
+        {
+            verbs.append(qMakePair(it.value().totalNs(), it.key()));
+        }
+        qSort(verbs.begin(), verbs.end(), busiestFirst);
+
+        for (int i = 0 ; i < verbs.size() ; i++)
+        {
+            const QString& verb = verbs.at(i).second;
+            const CommandProfile& profile = data->profiles[verb];
+            const QString entry = QString("; %1 n=%2").arg(verb).arg(profile.count)
+                    + phaseValues(profile)
+                    + QString(" p50=%1 p99=%2 max=%3")
+                        .arg(profile.percentileUs(50))
+                        .arg(profile.percentileUs(99))
+                        .arg(profile.maxNs / 1000);
+            if (line.length() + entry.length() > maxLength)
+            {
+                line += QString("; +%1 more").arg(verbs.size() - i);
+                break;
+            }
+            line += entry;
+        }
+        return line;
+    }
+
+    QString Profiler::detail(const QString& verb)
+    {
+        ProfilerPrivate * const data = ProfilerPrivate::instance();
+        if (not data->profiles.contains(verb))
+        {
+            return QString();
+        }
+        const CommandProfile& profile = data->profiles[verb];
+        QStringList histogram;
+        for (int i = 0 ; i < BUCKETS ; i++)
+        {
+            if (profile.buckets[i])
+            {
+                histogram.append(QString("<%1:%2")
+                                 .arg(static_cast<qint64>(1) << i)
+                                 .arg(profile.buckets[i]));
+            }
+        }
+        return QString("%1 n=%2").arg(verb).arg(profile.count)
+                + phaseValues(profile)
+                + QString(" max=%1 hist=%2")
+                    .arg(profile.maxNs / 1000)
+                    .arg(histogram.join(","));
+    }
+
+    void Profiler::reset(void)
+    {
+        ProfilerPrivate::instance()->clear();
+    }
+
+    quint64 Profiler::commandCount(void)
+    {
+        return ProfilerPrivate::instance()->commands;
+    }
+
+    QString Profiler::lastCommand(void)
+    {
+        return ProfilerPrivate::instance()->lastVerb;
+    }
+
+    ProfilerScope::ProfilerScope(const Profiler::Phase timedPhase)
+        : phase(timedPhase),
+          outer(ProfilerScope::innermost),
+          active(ProfilerPrivate::onUiThread()
+                 and not (ProfilerScope::innermost
+                          and ProfilerScope::innermost->phase == timedPhase)),
+          nestedNs(0)
+    {
+        if (this->active)
+        {
+            ProfilerScope::innermost = this;
+            this->timer.start();
+        }
+    }
+
+    ProfilerScope::~ProfilerScope()
+    {
+        if (this->active)
+        {
+            const qint64 elapsedNs = this->timer.nsecsElapsed();
+            ProfilerScope::innermost = this->outer;
+            if (this->outer)
+            {
+                this->outer->nestedNs += elapsedNs;
+            }
+            Profiler::record(this->phase, elapsedNs - this->nestedNs);
+        }
+    }
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
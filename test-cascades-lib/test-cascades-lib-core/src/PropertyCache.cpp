@@ -0,0 +1,60 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#include "PropertyCache.h"
+
+#include <string.h>
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    const int PropertyCache::MAX_ENTRIES = 4096;
+    QHash<QPair<const QMetaObject*, QByteArray>, int> PropertyCache::indexes;
+
+    QMetaProperty PropertyCache::property(const QObject * const object, const char * const name)
+    {
+        const QMetaObject * const meta = object->metaObject();
+        const QPair<const QMetaObject*, QByteArray> key(meta, QByteArray::fromRawData(
+                                                            name, strlen(name)));
+        QHash<QPair<const QMetaObject*, QByteArray>, int>::const_iterator it =
+                indexes.constFind(key);
+        if (it not_eq indexes.constEnd())
+        {
+            const int index = it.value();
+            if (index < 0)
+            {
+                return QMetaProperty();
+            }
+            // only a name check, not a search
+            if (index < meta->propertyCount())
+            {
+                const QMetaProperty cached = meta->property(index);
+                if (strcmp(cached.name(), name) == 0)
+                {
+                    return cached;
+                }
+            }
+        }
+
+        if (indexes.size() >= MAX_ENTRIES)
+        {
+            indexes.clear();
+        }
+        const int index = meta->indexOfProperty(name);
+        // the key's data is the caller's so it's copied
+        indexes.insert(qMakePair(meta, QByteArray(name)), index);
+        return index < 0 ? QMetaProperty() : meta->property(index);
+    }
+
+    QVariant PropertyCache::read(const QObject * const object, const char * const name)
+    {
+        const QMetaProperty metaProperty = property(object, name);
+        // dynamic properties aren't in the meta object
+        return metaProperty.isValid() ? metaProperty.read(object) : object->property(name);
+    }
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
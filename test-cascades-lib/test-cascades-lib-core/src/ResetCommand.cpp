@@ -0,0 +1,138 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#include "ResetCommand.h"
+
+#include <QString>
+#include <QList>
+#include <QObject>
+#include <bb/cascades/AbstractPane>
+#include <bb/cascades/Application>
+#include <bb/cascades/ListView>
+#include <bb/cascades/MultiSelectHandler>
+#include <bb/cascades/NavigationPane>
+#include <bb/cascades/Tab>
+#include <bb/cascades/TabbedPane>
+
+#include "AutoResponder.h"
+#include "Connection.h"
+#include "Recorder.h"
+#include "SpyCommand.h"
+
+using bb::cascades::AbstractPane;
+using bb::cascades::Application;
+using bb::cascades::ListView;
+using bb::cascades::NavigationPane;
+using bb::cascades::Tab;
+using bb::cascades::TabbedPane;
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    const QString ResetCommand::CMD_NAME = "reset";
+
+    ResetCommand::ResetCommand(Connection * const socket,
+                               QObject* parent)
+        : Command(parent),
+          client(socket)
+    {
+    }
+
+    ResetCommand::~ResetCommand()
+    {
+    }
+
+    bool ResetCommand::executeCommand(QStringList * const arguments)
+    {
+        bool ret = false;
+        if (arguments->isEmpty())
+        {
+            SpyCommand::removeAllSpies();
+            // other connections may be recording too
+            Recorder::unsubscribe(this->client);
+            popToRoot(Application::instance()->scene());
+            clearListSelections();
+            // a script's rules shouldn't answer the next script's dialogs
+            if (AutoResponder::exists())
+            {
+                AutoResponder::instance()->clear();
+            }
+            ret = true;
+        }
+        else
+        {
+            this->client->write(tr("ERROR: No parameters for reset") + "\r\n");
+        }
+        return ret;
+    }
+
+    int ResetCommand::popToRoot(AbstractPane * const pane,
+                                const size_t callLevel,
+                                const size_t maxCallLevel)
+    {
+        int popped = 0;
+        if (pane and callLevel < maxCallLevel)
+        {
+            NavigationPane * const navPane = qobject_cast<NavigationPane*>(pane);
+            TabbedPane * const tabbedPane = qobject_cast<TabbedPane*>(pane);
+            if (navPane)
+            {
+                while (navPane->count() > 1)
+                {
+                    if (not navPane->pop())
+                    {
+                        break;
+                    }
+                    Application::processEvents();
+                    popped++;
+                }
+            }
+            else if (tabbedPane)
+            {
+                for (int i = 0 ; i < tabbedPane->count() ; i++)
+                {
+                    Tab * const tab = tabbedPane->at(i);
+                    if (tab)
+                    {
+                        popped += popToRoot(tab->content(), callLevel + 1, maxCallLevel);
+                    }
+                }
+            }
+        }
+        return popped;
+    }
+
+    int ResetCommand::clearListSelections(void)
+    {
+        int lists = 0;
+        AbstractPane * const scene = Application::instance()->scene();
+        if (scene)
+        {
+            Q_FOREACH(ListView * const listView, scene->findChildren<ListView*>())
+            {
+                if (listView->multiSelectHandler())
+                {
+                    listView->multiSelectHandler()->setActive(false);
+                }
+                listView->clearSelection();
+                lists++;
+            }
+        }
+        return lists;
+    }
+
+    void ResetCommand::showHelp()
+    {
+        this->client->write(tr("> reset") + "\r\n");
+        this->client->write(tr("Put the application back into a known state: remove the " \
+                               "spies, stop recording,") + "\r\n");
+        this->client->write(tr("pop the navigation panes to their first page, clear " \
+                               "the list selections") + "\r\n");
+        this->client->write(tr("and remove the autorespond rules") + "\r\n");
+    }
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
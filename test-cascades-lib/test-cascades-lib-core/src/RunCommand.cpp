@@ -0,0 +1,377 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#include "RunCommand.h"
+
+#include <QString>
+#include <QObject>
+#include <QTimer>
+
+#include "Connection.h"
+#include "RunConnection.h"
+#include "CommandFactory.h"
+#include "RecordCommand.h"
+#include "ExitCommand.h"
+#include "QuitCommand.h"
+#include "Utils.h"
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    const QString RunCommand::CMD_NAME = "run";
+    const int RunCommand::MAX_CALL_DEPTH = 10;
+    const int RunCommand::MAX_REPLY = 900;
+    QHash<QString, QStringList> RunCommand::scripts;
+
+    /*!
+     * \brief DEFAULT_RETRY_INTERVAL The CLI's default retry interval
+     */
+    static const int DEFAULT_RETRY_INTERVAL = 1000;
+    /*!
+     * \brief DEFAULT_RETRY_MAX_INTERVALS The CLI's default number of retries
+     */
+    static const int DEFAULT_RETRY_MAX_INTERVALS = 30;
+
+    RunCommand::RunCommand(Connection * const socket,
+                           QObject* parent)
+        : Command(parent),
+          client(socket),
+          running(false),
+          retry(false),
+          retryInterval(DEFAULT_RETRY_INTERVAL),
+          retryMaxIntervals(DEFAULT_RETRY_MAX_INTERVALS),
+          failureOk(false),
+          retries(0),
+          commands(0)
+    {
+    }
+
+    RunCommand::~RunCommand()
+    {
+    }
+
+    bool RunCommand::executeCommand(QStringList * const arguments)
+    {
+        bool ret = false;
+        const QString subCommand = arguments->isEmpty() ? QString() : arguments->first();
+        if (subCommand == "add")
+        {
+            if (arguments->size() >= 3)
+            {
+                // the line is played exactly as it was sent
+                scripts[arguments->at(1)].append(
+                            Utils::untokenise(", ", arguments->mid(2)));
+                ret = true;
+            }
+            else
+            {
+                this->client->write(tr("ERROR: run add <script> <line>") + "\r\n");
+            }
+        }
+        else if (subCommand == "clear")
+        {
+            if (arguments->size() == 1)
+            {
+                scripts.clear();
+                ret = true;
+            }
+            else if (arguments->size() == 2)
+            {
+                scripts.remove(arguments->at(1));
+                ret = true;
+            }
+            else
+            {
+                this->client->write(tr("ERROR: run clear <optional: script>") + "\r\n");
+            }
+        }
+        else if (subCommand == "inline")
+        {
+            if (arguments->size() >= 2)
+            {
+                this->start(subCommand,
+                            Utils::untokenise(", ", arguments->mid(1)).split("\\n"));
+            }
+            else
+            {
+                this->client->write(tr("ERROR: run inline <line>\\n<line>...") + "\r\n");
+            }
+        }
+        else if (arguments->size() == 1)
+        {
+            if (scripts.contains(subCommand))
+            {
+                this->start(subCommand, scripts.value(subCommand));
+            }
+            else
+            {
+                this->client->write(tr("ERROR: Unknown script") + "\r\n");
+            }
+        }
+        else
+        {
+            this->client->write(tr("ERROR: run <script>|add|clear|inline") + "\r\n");
+        }
+        return ret;
+    }
+
+    void RunCommand::start(const QString& name, const QStringList& lines)
+    {
+        RunFrame frame;
+        frame.name = name;
+        frame.lines = lines;
+        frame.next = 0;
+        this->frames.append(frame);
+        this->running = true;
+        connect(this->client,
+                SIGNAL(disconnected(Connection*const)),
+                SLOT(clientDisconnected()));
+        // the reply to run comes once the script finishes
+        QMetaObject::invokeMethod(this, "playNext", Qt::QueuedConnection);
+    }
+
+    void RunCommand::playNext()
+    {
+        while (not this->frames.isEmpty())
+        {
+            RunFrame& frame = this->frames.last();
+            if (frame.next >= frame.lines.size())
+            {
+                this->frames.removeLast();
+                continue;
+            }
+            frame.next++;
+            const QString line = frame.lines.at(frame.next - 1).trimmed();
+            const QString id = frame.name + ":" + QString::number(frame.next);
+            if (line.isEmpty() or line.startsWith('#'))
+            {
+                continue;
+            }
+
+            const QStringList tokens = line.split(' ', QString::SkipEmptyParts);
+            if (tokens.first() == "cli-setting")
+            {
+                if (not this->applySetting(tokens))
+                {
+                    this->finish(tr("ERROR: Bad cli-setting at ") + id);
+                    return;
+                }
+            }
+            else if (tokens.first() == "call")
+            {
+                if (tokens.size() not_eq 2 or not scripts.contains(tokens.at(1)))
+                {
+                    this->finish(tr("ERROR: Unknown script called at ") + id);
+                    return;
+                }
+                if (this->frames.size() >= MAX_CALL_DEPTH)
+                {
+                    this->finish(tr("ERROR: Calls are nested too deep at ") + id);
+                    return;
+                }
+                RunFrame called;
+                called.name = tokens.at(1);
+                called.lines = scripts.value(called.name);
+                called.next = 0;
+                this->frames.append(called);
+            }
+            else
+            {
+                this->commandId = id;
+                this->commandLine = line;
+                this->retries = 0;
+                this->commandTimer.start();
+                this->sendCommand();
+                return;
+            }
+        }
+        // not translated; protocol
+        this->finish(QString("OK ") + QString::number(this->commands));
+    }
+
+    bool RunCommand::applySetting(const QStringList& tokens)
+    {
+        if (tokens.size() < 2 or tokens.size() > 3)
+        {
+            return false;
+        }
+        const QString& name = tokens.at(1);
+        const bool reset = (tokens.size() == 2);
+        int value = 0;
+        bool ok = reset;
+        if (not reset)
+        {
+            if (tokens.at(2) == "true" or tokens.at(2) == "false")
+            {
+                value = (tokens.at(2) == "true");
+                ok = true;
+            }
+            else
+            {
+                value = tokens.at(2).toInt(&ok);
+                ok = ok and value >= 0;
+            }
+        }
+        if (not ok)
+        {
+            return false;
+        }
+
+        if (name == "retry")
+        {
+            this->retry = reset ? false : (value not_eq 0);
+        }
+        else if (name == "retry-interval")
+        {
+            this->retryInterval = reset ? DEFAULT_RETRY_INTERVAL : value;
+        }
+        else if (name == "retry-max-intervals")
+        {
+            this->retryMaxIntervals = reset ? DEFAULT_RETRY_MAX_INTERVALS : value;
+        }
+        else if (name == "failure-ok")
+        {
+            this->failureOk = reset ? false : (value not_eq 0);
+        }
+        else if (name not_eq "window")
+        {
+            // the CLI's send ahead window means nothing here
+            return false;
+        }
+        return true;
+    }
+
+    void RunCommand::sendCommand()
+    {
+        if (not this->running)
+        {
+            return;
+        }
+        this->attemptTimer.start();
+        QStringList tokens = Utils::tokenise(", ", this->commandLine);
+        const QString command = tokens.isEmpty() ? QString() : tokens.takeFirst();
+        if (command == CMD_NAME
+                or command == RecordCommand::getCmd()
+                or command == ExitCommand::getCmd()
+                or command == QuitCommand::getCmd())
+        {
+            // these outlive the command or act on the client's connection
+            this->commandReplied(tr("ERROR: Can't be used in a script that's run"));
+            return;
+        }
+
+        RunConnection * const capture = new RunConnection(this);
+        Command * const cmd = CommandFactory::getCommand(capture,
+                                                         command,
+                                                         this->parent());
+        if (cmd)
+        {
+            if (cmd->executeCommand(&tokens))
+            {
+                // not translated; protocol
+                capture->write(QString("OK") + "\r\n");
+            }
+            cmd->cleanUp();
+        }
+        else
+        {
+            capture->write(tr("ERROR: I don't understand that command") + "\r\n");
+        }
+    }
+
+    void RunCommand::commandReplied(const QString& commandReply)
+    {
+        if (this->running)
+        {
+            this->reply = commandReply.left(MAX_REPLY);
+            // let the application catch up before the next command,
+            // as it would between commands from the client
+            QMetaObject::invokeMethod(this, "handleReply", Qt::QueuedConnection);
+        }
+    }
+
+    void RunCommand::handleReply()
+    {
+        if (not this->running)
+        {
+            return;
+        }
+        const qint64 attemptUs = this->attemptTimer.nsecsElapsed() / 1000;
+        if (this->reply.startsWith("OK"))
+        {
+            this->writeDone("pass", attemptUs);
+            this->playNext();
+        }
+        else if (this->retry and this->retries < this->retryMaxIntervals)
+        {
+            this->retries++;
+            // not translated; protocol
+            this->client->write(QString("RUN %1 RETRY %2 %3 ")
+                                .arg(this->commandId)
+                                .arg(this->retries)
+                                .arg(attemptUs)
+                                + this->reply + "\r\n");
+            QTimer::singleShot(this->retryInterval, this, SLOT(sendCommand()));
+        }
+        else if (this->failureOk)
+        {
+            this->writeDone("accepted", attemptUs);
+            this->playNext();
+        }
+        else
+        {
+            this->writeDone("fail", attemptUs);
+            this->finish(tr("ERROR: The script stopped at ") + this->commandId);
+        }
+    }
+
+    void RunCommand::writeDone(const QString& verdict, const qint64 attemptUs)
+    {
+        this->commands++;
+        // not translated; protocol
+        this->client->write(QString("RUN %1 DONE %2 %3 %4 %5 ")
+                            .arg(this->commandId)
+                            .arg(this->retries)
+                            .arg(attemptUs)
+                            .arg(this->commandTimer.nsecsElapsed() / 1000)
+                            .arg(verdict)
+                            + this->reply + "\r\n");
+    }
+
+    void RunCommand::finish(const QString& finalReply)
+    {
+        this->client->write(finalReply + "\r\n");
+        this->running = false;
+        this->frames.clear();
+        this->deleteLater();
+    }
+
+    void RunCommand::clientDisconnected()
+    {
+        this->running = false;
+        this->frames.clear();
+        this->deleteLater();
+    }
+
+    void RunCommand::showHelp()
+    {
+        this->client->write(tr("> run add <script> <line>") + "\r\n");
+        this->client->write(tr("> run clear <optional: script>") + "\r\n");
+        this->client->write(tr("> run <script>") + "\r\n");
+        this->client->write(tr("> run inline <line>\\n<line>...") + "\r\n");
+        this->client->write(tr("Upload a script a line at a time and play it in the harness, " \
+                               "or play") + "\r\n");
+        this->client->write(tr("the lines given. Scripts can call other uploaded scripts " \
+                               "and use the") + "\r\n");
+        this->client->write(tr("retry and failure-ok cli-settings. Each command's result is " \
+                               "sent as a") + "\r\n");
+        this->client->write(tr("'RUN <script>:<line> DONE ...' line followed by OK or the " \
+                               "ERROR that") + "\r\n");
+        this->client->write(tr("stopped the script.") + "\r\n");
+    }
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
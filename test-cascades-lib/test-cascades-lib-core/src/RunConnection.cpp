@@ -0,0 +1,53 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#include "RunConnection.h"
+
+#include <QMetaObject>
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    RunConnection::RunConnection(QObject * const replyTo)
+        : Connection(static_cast<QObject*>(NULL)),
+          runner(replyTo),
+          replied(false)
+    {
+    }
+
+    RunConnection::~RunConnection()
+    {
+    }
+
+    qint64 RunConnection::write(const QString& data)
+    {
+        this->buffer += data;
+        int end = this->buffer.indexOf('\n');
+        while (end >= 0)
+        {
+            const QString line = this->buffer.left(end).trimmed();
+            this->buffer.remove(0, end + 1);
+            if (not this->replied
+                    and (line.startsWith("OK") or line.startsWith("ERROR")))
+            {
+                this->replied = true;
+                if (this->runner)
+                {
+                    QMetaObject::invokeMethod(this->runner,
+                                              "commandReplied",
+                                              Qt::DirectConnection,
+                                              Q_ARG(QString, line));
+                }
+                // async commands delete themselves once they've replied
+                this->deleteLater();
+            }
+            end = this->buffer.indexOf('\n');
+        }
+        return data.length();
+    }
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
@@ -6,7 +6,10 @@
 #include <QString>
 #include <QList>
 #include <QObject>
-#include <QSignalSpy>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QVector>
+#include <QtAlgorithms>
 
 #include "Utils.h"
 #include "Connection.h"
@@ -18,7 +21,12 @@ namespace test
 namespace cascades
 {
     /*!
-     * \brief The Spy class is a wrapper for the Signal Spy
+     * \brief The Spy class counts the emissions of a signal and keeps the
+     * times of the latest ones in a ring, not their arguments
+     *
+     * Like QSignalSpy it connects the signal to a method index past the
+     * end of QObject's own methods and catches the call in qt_metacall, so
+     * any signal can be spied on whatever its arguments.
      *
      * @since test-cascades 1.0.0
      */
@@ -43,8 +51,11 @@ namespace cascades
               mySpyName(name),
               myObject(object),
               mySignal(signal),
-              spy(NULL),
-              spyObject(NULL)
+              spyObject(NULL),
+              signalIndex(-1),
+              times(MAX_TIMES),
+              fired(0),
+              firstNs(0)
         {
         }
 
@@ -59,7 +70,7 @@ namespace cascades
         }
 
         /*!
-         * \brief connect Create and connect the SignalSpy to the object
+         * \brief connect Connect the spy to the object's signal
          *
          * \return True if the connection worked
          *
@@ -68,10 +79,7 @@ namespace cascades
         bool connect()
         {
             bool ret = true;
-            if (this->spy)
-            {
-                delete this->spy;
-            }
+            this->disconnectSignal();
             if (this->myObject.isNull() or this->myObject.isEmpty())
             {
                 ret = false;
@@ -84,19 +92,53 @@ namespace cascades
             {
                 ret = false;
             }
-            if (this->mySignal.isNull() or this->mySignal.isEmpty())
+            // the signal has the SIGNAL() code in front of it
+            if (this->mySignal.length() < 2)
             {
                 ret = false;
             }
             if (ret)
             {
-                const char * const signalName = this->mySignal.toUtf8().constData();
-                this->spy = new QSignalSpy(this->spyObject, signalName);
-                ret = this->spy->isValid();
+                const QByteArray signature =
+                        QMetaObject::normalizedSignature(this->mySignal.mid(1).toUtf8());
+                this->signalIndex = this->spyObject->metaObject()->indexOfSignal(signature);
+                ret = this->signalIndex >= 0
+                        and QMetaObject::connect(this->spyObject,
+                                                 this->signalIndex,
+                                                 this,
+                                                 QObject::staticMetaObject.methodCount(),
+                                                 Qt::DirectConnection);
+                if (ret)
+                {
+                    this->clock.start();
+                }
+                else
+                {
+                    this->signalIndex = -1;
+                }
             }
             return ret;
         }
 
+        /*!
+         * \brief qt_metacall Catches the spied on signal
+         *
+         * @since test-cascades 1.1.5
+         */
+        int qt_metacall(QMetaObject::Call call, int id, void ** arguments)
+        {
+            id = QObject::qt_metacall(call, id, arguments);
+            if (id >= 0)
+            {
+                if (call == QMetaObject::InvokeMetaMethod and id == 0)
+                {
+                    this->signalFired();
+                }
+                id--;
+            }
+            return id;
+        }
+
         /*!
          * \brief count The number of signals that were fired once spying started
          *
@@ -108,13 +150,13 @@ namespace cascades
          *
          * @since test-cascades 1.0.0
          */
-        int count(bool * valid = 0) const
+        quint64 count(bool * valid = 0) const
         {
-            int c = 0;
+            quint64 c = 0;
 
-            if (this->spy and this->spy->isValid())
+            if (this->signalIndex >= 0)
             {
-                c = this->spy->count();
+                c = this->fired;
                 if (valid)
                 {
                     *valid = true;
@@ -124,6 +166,69 @@ namespace cascades
             return c;
         }
 
+        /*!
+         * \brief stats The rate and times of the emissions
+         *
+         * \return The stats as @c name=value pairs, the times are since
+         * the spy was created and the gaps are between the emissions
+         * still in the ring
+         *
+         * @since test-cascades 1.1.5
+         */
+        QString stats() const
+        {
+            const int kept = static_cast<int>(qMin(this->fired,
+                                                   static_cast<quint64>(MAX_TIMES)));
+            const qint64 lastNs = kept > 0 ?
+                        this->times.at((this->fired - 1) % MAX_TIMES) : 0;
+            QVector<qint64> gapsNs;
+            gapsNs.reserve(kept);
+            for (quint64 i = this->fired - kept + 1 ; i < this->fired ; i++)
+            {
+                gapsNs.append(this->times.at(i % MAX_TIMES)
+                              - this->times.at((i - 1) % MAX_TIMES));
+            }
+            qSort(gapsNs);
+            const qint64 spanNs = lastNs - this->firstNs;
+            const double rate = (this->fired > 1 and spanNs > 0) ?
+                        (this->fired - 1) * 1000000000.0 / spanNs : 0.0;
+            return QString("count=%1 kept=%2 first=%3ms last=%4ms rate=%5/s"
+                           " p50=%6us p90=%7us p99=%8us max=%9us")
+                    .arg(this->fired)
+                    .arg(kept)
+                    .arg(this->fired > 0 ? this->firstNs / 1000000 : -1)
+                    .arg(this->fired > 0 ? lastNs / 1000000 : -1)
+                    .arg(rate, 0, 'f', 1)
+                    .arg(percentile(gapsNs, 50) / 1000)
+                    .arg(percentile(gapsNs, 90) / 1000)
+                    .arg(percentile(gapsNs, 99) / 1000)
+                    .arg(gapsNs.isEmpty() ? 0 : gapsNs.last() / 1000);
+        }
+
+        /*!
+         * \brief addWaiter Tell a command each time the signal fires
+         *
+         * \param waiter The command
+         *
+         * @since test-cascades 1.1.5
+         */
+        void addWaiter(SpyCommand * const waiter)
+        {
+            this->waiters.append(waiter);
+        }
+
+        /*!
+         * \brief removeWaiter Stop telling a command when the signal fires
+         *
+         * \param waiter The command
+         *
+         * @since test-cascades 1.1.5
+         */
+        void removeWaiter(SpyCommand * const waiter)
+        {
+            this->waiters.removeAll(waiter);
+        }
+
         /*!
          * \brief kill Kills the spy and removes it from the object
          *
@@ -131,15 +236,84 @@ namespace cascades
          */
         void kill()
         {
-            if (this->spy)
+            this->disconnectSignal();
+            // a waiter removes itself
+            const QList<QPointer<SpyCommand> > waiting = this->waiters;
+            foreach (const QPointer<SpyCommand>& waiter, waiting)
             {
-                delete this->spy;
+                if (waiter)
+                {
+                    waiter->spyKilled();
+                }
             }
-            this->spy = NULL;
+            this->waiters.clear();
         }
 
     protected:
     private:
+        /*!
+         * \brief MAX_TIMES The number of emission times kept
+         */
+        static const int MAX_TIMES = 1024;
+        /*!
+         * \brief percentile A percentile of sorted values
+         *
+         * \param sorted The values, sorted
+         * \param percent The percentile (0-100)
+         *
+         * \return The value or 0 if there are none
+         *
+         * @since test-cascades 1.1.5
+         */
+        static qint64 percentile(const QVector<qint64>& sorted, const int percent)
+        {
+            if (sorted.isEmpty())
+            {
+                return 0;
+            }
+            const int index = qMax(0, (sorted.size() * percent + 99) / 100 - 1);
+            return sorted.at(qMin(index, sorted.size() - 1));
+        }
+        /*!
+         * \brief signalFired Record an emission
+         *
+         * @since test-cascades 1.1.5
+         */
+        void signalFired()
+        {
+            const qint64 now = this->clock.nsecsElapsed();
+            if (this->fired == 0)
+            {
+                this->firstNs = now;
+            }
+            this->times[this->fired % MAX_TIMES] = now;
+            this->fired++;
+            // a waiter that's done removes itself
+            const QList<QPointer<SpyCommand> > waiting = this->waiters;
+            foreach (const QPointer<SpyCommand>& waiter, waiting)
+            {
+                if (waiter)
+                {
+                    waiter->spyFired(this->fired);
+                }
+            }
+        }
+        /*!
+         * \brief disconnectSignal Disconnect from the signal
+         *
+         * @since test-cascades 1.1.5
+         */
+        void disconnectSignal()
+        {
+            if (this->spyObject and this->signalIndex >= 0)
+            {
+                QMetaObject::disconnect(this->spyObject,
+                                        this->signalIndex,
+                                        this,
+                                        QObject::staticMetaObject.methodCount());
+            }
+            this->signalIndex = -1;
+        }
         /*!
          * \brief mySpyName The name of the spy
          */
@@ -153,13 +327,34 @@ namespace cascades
          */
         const QString mySignal;
         /*!
-         * \brief spy Our spy
+         * \brief spyObject The object to spy on
+         */
+        QPointer<QObject> spyObject;
+        /*!
+         * \brief signalIndex The index of the signal or -1 if the spy
+         * isn't connected
          */
-        QSignalSpy * spy;
+        int signalIndex;
         /*!
-         * \brief spyObject The object to spy on
+         * \brief clock Started when the spy connects
+         */
+        QElapsedTimer clock;
+        /*!
+         * \brief times The ring of the latest emission times
          */
-        QObject * spyObject;
+        QVector<qint64> times;
+        /*!
+         * \brief fired The number of emissions
+         */
+        quint64 fired;
+        /*!
+         * \brief firstNs The time of the first emission
+         */
+        qint64 firstNs;
+        /*!
+         * \brief waiters The commands waiting on the signal
+         */
+        QList<QPointer<SpyCommand> > waiters;
     };
 
     /*!
@@ -237,9 +432,9 @@ namespace cascades
          *
          * @since test-cascades 1.0.0
          */
-        Spy * getSpy(const QString &name)
+        Spy * getSpy(const QString &name) const
         {
-            return this->spies[name];
+            return this->spies.value(name);
         }
         /*!
          * \brief removeSpy Remove, disconnet and delete as spy
@@ -252,7 +447,7 @@ namespace cascades
         bool removeSpy(const QString &name)
         {
             bool found = false;
-            Spy * const spy = this->spies[name];
+            Spy * const spy = this->spies.value(name);
             if (spy)
             {
                 spy->kill();
@@ -262,6 +457,28 @@ namespace cascades
             }
             return found;
         }
+        /*!
+         * \brief removeAll Remove, disconnect and delete all the spies
+         *
+         * \return The number of spies removed
+         *
+         * @since test-cascades 1.1.5
+         */
+        int removeAll()
+        {
+            int removed = 0;
+            Q_FOREACH(Spy * spy, this->spies)
+            {
+                if (spy)
+                {
+                    spy->kill();
+                    delete spy;
+                    removed++;
+                }
+            }
+            this->spies.clear();
+            return removed;
+        }
 
     protected:
     private:
@@ -279,14 +496,28 @@ namespace cascades
         : Command(parent),
           client(socket),
           spyPrivate(((spyPrivateSingleton == NULL)
-                      ? spyPrivateSingleton = new SpyCommandPrivate() : spyPrivateSingleton))
+                      ? spyPrivateSingleton = new SpyCommandPrivate() : spyPrivateSingleton)),
+          waiting(false),
+          waitCount(0)
     {
+        this->waitTimer.setSingleShot(true);
+        connect(&this->waitTimer, SIGNAL(timeout()), SLOT(waitTimedOut()));
     }
 
     SpyCommand::~SpyCommand()
     {
     }
 
+    int SpyCommand::removeAllSpies(void)
+    {
+        int removed = 0;
+        if (spyPrivateSingleton)
+        {
+            removed = spyPrivateSingleton->removeAll();
+        }
+        return removed;
+    }
+
     bool SpyCommand::executeCommand(QStringList * const arguments)
     {
         bool ret = false;
@@ -345,7 +576,7 @@ namespace cascades
                         else
                         {
                             bool valid = false;
-                            const int count = spy->count(&valid);
+                            const quint64 count = spy->count(&valid);
                             if (not valid)
                             {
                                 this->client->write(tr("ERROR: Couldn't get the signal " \
@@ -353,7 +584,7 @@ namespace cascades
                             }
                             else
                             {
-                                if (count == expectedCount)
+                                if (count == static_cast<quint64>(expectedCount))
                                 {
                                     ret = true;
                                 }
@@ -371,6 +602,57 @@ namespace cascades
                     this->client->write(tr("ERROR: Count needs at least two parameter") + "\r\n");
                 }
             }
+            else if (command == "stats")
+            {
+                const Spy * const spy = this->spyPrivate->getSpy(arguments->first());
+                if (not spy)
+                {
+                    this->client->write(tr("ERROR: Couldn't find a spy with that name")
+                                        + "\r\n");
+                }
+                else
+                {
+                    // not translated; protocol
+                    this->client->write(QString("OK ") + spy->stats() + "\r\n");
+                }
+            }
+            else if (command == "wait")
+            {
+                bool countOk = false;
+                bool timeoutOk = false;
+                const QString name = arguments->first();
+                const int expectedCount = arguments->size() == 3 ?
+                            arguments->at(1).toInt(&countOk) : 0;
+                const int timeout = arguments->size() == 3 ?
+                            arguments->at(2).toInt(&timeoutOk) : 0;
+                Spy * const spy = this->spyPrivate->getSpy(name);
+                if (not countOk or not timeoutOk or expectedCount < 0 or timeout < 0)
+                {
+                    this->client->write(tr("ERROR: spy wait <spyName> <count> <timeout>")
+                                        + "\r\n");
+                }
+                else if (not spy)
+                {
+                    this->client->write(tr("ERROR: Couldn't find a spy with that name")
+                                        + "\r\n");
+                }
+                else if (spy->count() >= static_cast<quint64>(expectedCount))
+                {
+                    ret = true;
+                }
+                else
+                {
+                    // the reply comes when the signal fires or the time is up
+                    this->waiting = true;
+                    this->waitName = name;
+                    this->waitCount = expectedCount;
+                    spy->addWaiter(this);
+                    connect(this->client,
+                            SIGNAL(disconnected(Connection*const)),
+                            SLOT(clientDisconnected()));
+                    this->waitTimer.start(timeout);
+                }
+            }
             else if (command == "kill")
             {
                 const QString name = arguments->first();
@@ -396,12 +678,64 @@ namespace cascades
         return ret;
     }
 
+    void SpyCommand::spyFired(const quint64 count)
+    {
+        if (this->waiting and count >= this->waitCount)
+        {
+            // not translated; protocol
+            this->finishWait(QString("OK") + "\r\n");
+        }
+    }
+
+    void SpyCommand::spyKilled(void)
+    {
+        this->finishWait(tr("ERROR: The spy was killed") + "\r\n");
+    }
+
+    void SpyCommand::waitTimedOut(void)
+    {
+        const Spy * const spy = this->spyPrivate->getSpy(this->waitName);
+        this->finishWait(tr("ERROR: Timed out with the signal fired %1 times")
+                         .arg(spy ? spy->count() : 0) + "\r\n");
+    }
+
+    void SpyCommand::clientDisconnected(void)
+    {
+        this->finishWait(QString());
+    }
+
+    void SpyCommand::finishWait(const QString& reply)
+    {
+        if (not this->waiting)
+        {
+            return;
+        }
+        this->waiting = false;
+        this->waitTimer.stop();
+        Spy * const spy = this->spyPrivate->getSpy(this->waitName);
+        if (spy)
+        {
+            spy->removeWaiter(this);
+        }
+        if (not reply.isEmpty())
+        {
+            this->client->write(reply);
+        }
+        this->deleteLater();
+    }
+
     void SpyCommand::showHelp()
     {
         this->client->write(tr("> spy create <spyName> <object> <signal> - create a new Spy")
                             + "\r\n");
         this->client->write(tr("> spy count <spyName> <count> - check that the signal count for " \
                             "a spy is <count>") + "\r\n");
+        this->client->write(tr("> spy stats <spyName> - show the signal rate, the first and " \
+                            "last times (ms)") + "\r\n");
+        this->client->write(tr("  and the gaps (us) between the last 1024 signals") + "\r\n");
+        this->client->write(tr("> spy wait <spyName> <count> <timeout> - reply once the " \
+                            "signal count is") + "\r\n");
+        this->client->write(tr("  <count> or an error after <timeout> ms") + "\r\n");
         this->client->write(tr("> spy kill <spyName> - remove a spy") + "\r\n");
     }
 }  // namespace cascades
@@ -0,0 +1,77 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#include "StatsCommand.h"
+
+#include <QString>
+#include <QObject>
+
+#include "Connection.h"
+#include "Profiler.h"
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    const QString StatsCommand::CMD_NAME = "stats";
+    const int StatsCommand::MAX_REPLY = 1000;
+
+    StatsCommand::StatsCommand(Connection * const socket,
+                               QObject* parent)
+        : Command(parent),
+          client(socket)
+    {
+    }
+
+    StatsCommand::~StatsCommand()
+    {
+    }
+
+    bool StatsCommand::executeCommand(QStringList * const arguments)
+    {
+        bool ret = false;
+        if (arguments->isEmpty())
+        {
+            // not translated; protocol
+            this->client->write(QString("OK ") + Profiler::summary(MAX_REPLY) + "\r\n");
+        }
+        else if (arguments->size() == 1 and arguments->first() == "reset")
+        {
+            Profiler::reset();
+            ret = true;
+        }
+        else if (arguments->size() == 1)
+        {
+            const QString detail = Profiler::detail(arguments->first());
+            if (detail.isNull())
+            {
+                this->client->write(tr("ERROR: No stats for that command") + "\r\n");
+            }
+            else
+            {
+                this->client->write(QString("OK ") + detail + "\r\n");
+            }
+        }
+        else
+        {
+            this->client->write(tr("ERROR: stats [reset|<command>]") + "\r\n");
+        }
+        return ret;
+    }
+
+    void StatsCommand::showHelp()
+    {
+        this->client->write(tr("> stats") + "\r\n");
+        this->client->write(tr("> stats <command>") + "\r\n");
+        this->client->write(tr("> stats reset") + "\r\n");
+        this->client->write(tr("Show how long the harness spent parsing, finding objects, " \
+                               "executing and writing") + "\r\n");
+        this->client->write(tr("replies (in us) for each command, the time spent on the " \
+                               "UI thread and") + "\r\n");
+        this->client->write(tr("a histogram of the command times. Reset clears them.") + "\r\n");
+    }
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
@@ -13,6 +13,7 @@
 #include <bb/system/SystemUiResult>
 
 #include "Connection.h"
+#include "ObjectRegistry.h"
 #include "Utils.h"
 
 using bb::system::SystemDialog;
@@ -46,8 +47,8 @@ namespace cascades
         if (arguments->size() >= 1)
         {
             const QString dialogName = arguments->first();
-            SystemDialog * const dialog =
-                    qobject_cast<SystemDialog*>(Utils::findObject(dialogName));
+            SystemDialog * const dialog = qobject_cast<SystemDialog*>(
+                        findDialog(SystemDialog::staticMetaObject, dialogName));
             arguments->removeFirst();
             if (dialog)
             {
@@ -84,8 +85,8 @@ namespace cascades
             }
             else
             {
-                SystemPrompt * const prompt =
-                        qobject_cast<SystemPrompt*>(Utils::findObject(dialogName));
+                SystemPrompt * const prompt = qobject_cast<SystemPrompt*>(
+                            findDialog(SystemPrompt::staticMetaObject, dialogName));
                 if (prompt)
                 {
                     if (arguments->isEmpty())
@@ -142,6 +143,13 @@ namespace cascades
         return ret;
     }
 
+    QObject * SystemDialogCommand::findDialog(const QMetaObject& type, const QString& name)
+    {
+        QObject * const dialog = ObjectRegistry::instance()->find(type, name);
+        // a path rather than a name
+        return dialog ? dialog : Utils::findObject(name);
+    }
+
     bool SystemDialogCommand::finishButton(
             SystemDialog * const dialog,
             const SystemUiResult::Type result)
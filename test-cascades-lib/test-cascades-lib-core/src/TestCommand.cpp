@@ -5,6 +5,7 @@
 
 #include "Utils.h"
 #include "Connection.h"
+#include "PropertyCache.h"
 
 using truphone::test::cascades::Utils;
 
@@ -47,7 +48,7 @@ namespace cascades
             if (obj)
             {
                 bb::cascades::Application::processEvents();
-                const QVariant var = obj->property(property.toUtf8().constData());
+                const QVariant var = PropertyCache::read(obj, property.toUtf8().constData());
                 if (var.isNull())
                 {
                     // if no expected value is specified we're expected it to be null
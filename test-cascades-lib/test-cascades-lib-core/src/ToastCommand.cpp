@@ -3,14 +3,14 @@
  */
 #include "ToastCommand.h"
 
-#include <bb/cascades/Application>
 #include <QList>
 #include <QString>
 #include <QObject>
 
 #include "Connection.h"
+#include "ObjectRegistry.h"
+#include "PropertyCache.h"
 
-using bb::cascades::Application;
 using bb::system::SystemToast;
 
 namespace truphone
@@ -37,7 +37,7 @@ namespace cascades
         bool ret = false;
         if (arguments->size() >= 1)
         {
-            const SystemToast * toast = findVisibleToast(Application::instance());
+            const SystemToast * toast = findVisibleToast();
             const QString first = arguments->first();
             arguments->removeFirst();
             if (first == "true" or first == "false")
@@ -91,39 +91,17 @@ namespace cascades
         return ret;
     }
 
-    const SystemToast * ToastCommand::findVisibleToast(
-            QObject * const object,
-            const size_t searchLevel,
-            const size_t maxSearchLevel)
+    const SystemToast * ToastCommand::findVisibleToast(void)
     {
-        const SystemToast * returnObject = NULL;
-
-        if (searchLevel < maxSearchLevel)
+        foreach (QObject * const object,
+                 ObjectRegistry::instance()->objects(SystemToast::staticMetaObject))
         {
-            const SystemToast * const toast = qobject_cast<SystemToast*>(object);
-            if (toast)
+            if (PropertyCache::read(object, "visible").toBool())
             {
-                const bool propVisible = toast->property("visible").toBool();
-                if (propVisible)
-                {
-                    returnObject = toast;
-                }
-            }
-
-            if (not returnObject)
-            {
-                Q_FOREACH(QObject * const child, object->children())
-                {
-                    returnObject = findVisibleToast(child, searchLevel + 1, maxSearchLevel);
-                    if (returnObject)
-                    {
-                        break;
-                    }
-                }
+                return qobject_cast<SystemToast*>(object);
             }
         }
-
-        return returnObject;
+        return NULL;
     }
 
     void ToastCommand::showHelp()
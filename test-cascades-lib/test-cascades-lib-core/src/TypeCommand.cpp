@@ -0,0 +1,165 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#include "TypeCommand.h"
+
+#include <QString>
+#include <QObject>
+
+#include <bb/cascades/TextArea>
+#include <bb/cascades/TextEditor>
+#include <bb/cascades/TextField>
+
+#include "Connection.h"
+#include "Utils.h"
+
+using bb::cascades::Control;
+using bb::cascades::TextArea;
+using bb::cascades::TextEditor;
+using bb::cascades::TextField;
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+    const QString TypeCommand::CMD_NAME = "type";
+
+    TypeCommand::TypeCommand(Connection * const socket,
+                             QObject* parent)
+        : Command(parent),
+          client(socket),
+          typing(false),
+          typed(0)
+    {
+        connect(&this->keyTimer, SIGNAL(timeout()), SLOT(typeNext()));
+    }
+
+    TypeCommand::~TypeCommand()
+    {
+    }
+
+    bool TypeCommand::insertText(QObject * const field,
+                                 const QString& text,
+                                 const bool atEnd)
+    {
+        TextEditor * editor = NULL;
+        int length = 0;
+        TextField * const textField = qobject_cast<TextField*>(field);
+        if (textField)
+        {
+            editor = textField->editor();
+            length = atEnd ? textField->text().length() : 0;
+        }
+        else
+        {
+            TextArea * const textArea = qobject_cast<TextArea*>(field);
+            if (textArea)
+            {
+                editor = textArea->editor();
+                length = atEnd ? textArea->text().length() : 0;
+            }
+        }
+        if (editor)
+        {
+            if (atEnd)
+            {
+                editor->setCursorPosition(length);
+            }
+            editor->insertPlainText(text);
+        }
+        return editor;
+    }
+
+    bool TypeCommand::executeCommand(QStringList * const arguments)
+    {
+        bool rateOk = false;
+        const int rate = arguments->size() < 3 ? 0 : arguments->at(1).toInt(&rateOk);
+        if (not rateOk or rate < 0)
+        {
+            this->client->write(tr("ERROR: type <field> <keys per second> <text>") + "\r\n");
+            return false;
+        }
+        this->field = qobject_cast<Control*>(Utils::findObject(arguments->first()));
+        this->text = Utils::untokenise(", ", arguments->mid(2));
+        if (this->text.length() >= 2 and this->text.startsWith('"') and this->text.endsWith('"'))
+        {
+            this->text = this->text.mid(1, this->text.length() - 2);
+        }
+        if (not this->field or not insertText(this->field, QString()))
+        {
+            this->client->write(tr("ERROR: Object isn't a TextField or TextArea") + "\r\n");
+            return false;
+        }
+        if (not this->field->isFocused())
+        {
+            this->field->requestFocus();
+        }
+
+        this->typing = true;
+        connect(this->client,
+                SIGNAL(disconnected(Connection*const)),
+                SLOT(clientDisconnected()));
+        this->clock.start();
+        // 0 types a character on every pass of the event loop
+        this->keyTimer.start(rate > 0 ? qMax(1, 1000 / rate) : 0);
+        return false;
+    }
+
+    void TypeCommand::typeNext(void)
+    {
+        if (not this->typing)
+        {
+            return;
+        }
+        if (not this->field)
+        {
+            this->finish(tr("ERROR: The field was deleted while typing") + "\r\n");
+            return;
+        }
+        if (this->typed < this->text.length())
+        {
+            insertText(this->field, this->text.at(this->typed));
+            this->typed++;
+        }
+        if (this->typed == this->text.length())
+        {
+            // not translated; protocol
+            this->finish(QString("OK %1 %2").arg(this->typed).arg(this->clock.elapsed())
+                         + "\r\n");
+        }
+    }
+
+    void TypeCommand::clientDisconnected(void)
+    {
+        this->finish(QString());
+    }
+
+    void TypeCommand::finish(const QString& reply)
+    {
+        if (not this->typing)
+        {
+            return;
+        }
+        this->typing = false;
+        this->keyTimer.stop();
+        if (not reply.isEmpty())
+        {
+            this->client->write(reply);
+        }
+        this->deleteLater();
+    }
+
+    void TypeCommand::showHelp()
+    {
+        this->client->write(tr("> type <field> <keys per second> <text>") + "\r\n");
+        this->client->write(tr("Type the text (which may be quoted) into a TextField or " \
+                               "TextArea at the") + "\r\n");
+        this->client->write(tr("cursor a character at a time, 0 for as fast as possible. " \
+                               "Replies") + "\r\n");
+        this->client->write(tr("OK <characters> <ms> once the last one is typed.") + "\r\n");
+    }
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
@@ -8,6 +8,8 @@
 #include <bb/cascades/AbstractPane>
 #include <bb/cascades/QmlDocument>
 
+#include "Profiler.h"
+
 using bb::cascades::Application;
 using bb::cascades::QmlDocument;
 
@@ -82,6 +84,35 @@ namespace cascades
         return list;
     }
 
+    QString Utils::untokenise(const QString& delim,
+                              const QStringList& tokens)
+    {
+        QString text;
+        int i = 0;
+        while (i < tokens.size())
+        {
+            // every token up to the last was ended by a delimiter which
+            // is the next token unless it was a space
+            text += tokens.at(i);
+            i++;
+            if (i < tokens.size())
+            {
+                const QString& next = tokens.at(i);
+                if (next.length() == 1 and next.at(0) not_eq ' '
+                        and isDelim(delim, next.at(0).toAscii()))
+                {
+                    text += next;
+                    i++;
+                }
+                else
+                {
+                    text += ' ';
+                }
+            }
+        }
+        return text;
+    }
+
     // -------------------------------------------------
     // functions from hooq to get the unique object name
     // -------------------------------------------------
@@ -194,6 +225,8 @@ namespace cascades
 
     QObject* Utils::findObject(const QString& path, const bool scanQmlContent)
     {
+        // only the outermost search is timed
+        ProfilerScope find(Profiler::FIND);
         QObject * result = Application::instance()->scene()->findChild<QObject*>(path);
         if (not result)
         {
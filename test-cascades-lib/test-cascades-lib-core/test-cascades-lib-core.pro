@@ -42,7 +42,28 @@ SOURCES += \
     src/ListCommand.cpp \
     src/SegmentCommand.cpp \
     src/SystemDialogCommand.cpp \
-    src/QuitCommand.cpp
+    src/QuitCommand.cpp \
+    src/Profiler.cpp \
+    src/StatsCommand.cpp \
+    src/ResetCommand.cpp \
+    src/RunCommand.cpp \
+    src/RunConnection.cpp \
+    src/JankMonitor.cpp \
+    src/JankCommand.cpp \
+    src/MemorySampler.cpp \
+    src/MemCommand.cpp \
+    src/LeakTracker.cpp \
+    src/LeakCommand.cpp \
+    src/ProbeCommand.cpp \
+    src/Recorder.cpp \
+    src/OutboundCommand.cpp \
+    src/GestureCommand.cpp \
+    src/TypeCommand.cpp \
+    src/MonkeyCommand.cpp \
+    src/AutoResponder.cpp \
+    src/AutoRespondCommand.cpp \
+    src/ObjectRegistry.cpp \
+    src/PropertyCache.cpp
 
 HEADERS +=\
     include/CascadesTest.h \
@@ -82,7 +103,28 @@ HEADERS +=\
     include/ListCommand.h \
     include/SegmentCommand.h \
     include/SystemDialogCommand.h \
-    include/QuitCommand.h
+    include/QuitCommand.h \
+    include/Profiler.h \
+    include/StatsCommand.h \
+    include/ResetCommand.h \
+    include/RunCommand.h \
+    include/RunConnection.h \
+    include/JankMonitor.h \
+    include/JankCommand.h \
+    include/MemorySampler.h \
+    include/MemCommand.h \
+    include/LeakTracker.h \
+    include/LeakCommand.h \
+    include/ProbeCommand.h \
+    include/Recorder.h \
+    include/OutboundCommand.h \
+    include/GestureCommand.h \
+    include/TypeCommand.h \
+    include/MonkeyCommand.h \
+    include/AutoResponder.h \
+    include/AutoRespondCommand.h \
+    include/ObjectRegistry.h \
+    include/PropertyCache.h
 
 unix:!symbian {
     maemo5 {
@@ -0,0 +1,271 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#ifndef OPTIMISER_H_
+#define OPTIMISER_H_
+
+#include <QPointF>
+#include <QString>
+#include <QStringList>
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+namespace optimiser
+{
+    /*!
+     * \brief The ScriptOptimiser class rewrites a script recorded by the
+     * @c record command so that it replays faster.
+     *
+     * A recording has a @c touch line per receiver for every touch
+     * sample and a @c sleep line before every event. The optimiser:
+     * - turns a touch that goes down and up on the same target without
+     * moving into a single @c click (or @c longClick if it was held)
+     * - drops @c Move samples that haven't moved from the last one kept,
+     * always keeping the last one before the touch goes up
+     * - merges consecutive @c sleep lines
+     * - replaces a @c sleep before assertions with CLI retries so the
+     * assertions pass as soon as the application is ready
+     *
+     * @since test-cascades 1.1.5
+     */
+    class ScriptOptimiser
+    {
+        public:
+            /*!
+             * \brief ScriptOptimiser Create a new optimiser
+             *
+             * \param moveTolerance Samples closer than this (in pixels) are
+             * treated as not having moved
+             * \param longClickMs Touches held for at least this long become
+             * a @c longClick
+             * \param retryIntervalMs The retry interval used in place of a
+             * sleep before assertions, 0 to leave the sleeps alone
+             * \param useTaps @c true to replace touches with @c tap down and
+             * @c tap up rather than @c click
+             *
+             * @since test-cascades 1.1.5
+             */
+            ScriptOptimiser(const int moveTolerance,
+                            const int longClickMs,
+                            const int retryIntervalMs,
+                            const bool useTaps);
+            /*!
+             * \brief ~ScriptOptimiser Destructor
+             *
+             * @since test-cascades 1.1.5
+             */
+            virtual ~ScriptOptimiser();
+            /*!
+             * \brief optimise Optimise a script
+             *
+             * \param script The recorded lines
+             *
+             * \return The optimised lines
+             *
+             * @since test-cascades 1.1.5
+             */
+            QStringList optimise(const QStringList& script);
+            /*!
+             * \brief mergedSleeps The number of sleep lines merged away
+             *
+             * @since test-cascades 1.1.5
+             */
+            int mergedSleeps() const
+            {
+                return this->sleepsMerged;
+            }
+            /*!
+             * \brief droppedMoves The number of touch Move lines dropped
+             *
+             * @since test-cascades 1.1.5
+             */
+            int droppedMoves() const
+            {
+                return this->movesDropped;
+            }
+            /*!
+             * \brief clicks The number of touches replaced by clicks or taps
+             *
+             * @since test-cascades 1.1.5
+             */
+            int clicks() const
+            {
+                return this->touchesReplaced;
+            }
+            /*!
+             * \brief waits The number of sleeps replaced by retries
+             *
+             * @since test-cascades 1.1.5
+             */
+            int waits() const
+            {
+                return this->sleepsReplaced;
+            }
+        protected:
+        private:
+            /*!
+             * \brief The TouchType enum matches bb::cascades::TouchType
+             */
+            enum TouchType
+            {
+                DOWN = 0,
+                MOVE = 1,
+                UP = 2,
+                CANCEL = 3
+            };
+            /*!
+             * \brief The TouchLine struct is a parsed @c touch line
+             */
+            struct TouchLine
+            {
+                /*!
+                 * \brief valid @c false if the line isn't a touch line
+                 */
+                bool valid;
+                /*!
+                 * \brief screen The screen position of the touch
+                 */
+                QPointF screen;
+                /*!
+                 * \brief type The touch type
+                 */
+                int type;
+                /*!
+                 * \brief target The path of the touch target
+                 */
+                QString target;
+            };
+            /*!
+             * \brief parseTouch Parse a touch line
+             *
+             * \param line The line
+             *
+             * \return The touch, not valid if it isn't a touch line
+             *
+             * @since test-cascades 1.1.5
+             */
+            static TouchLine parseTouch(const QString& line);
+            /*!
+             * \brief parseSleep Parse a sleep line
+             *
+             * \param line The line
+             * \param ms Set to the sleep time
+             *
+             * \return @c true if it's a sleep line
+             *
+             * @since test-cascades 1.1.5
+             */
+            static bool parseSleep(const QString& line, int * const ms);
+            /*!
+             * \brief isAssertion Check for an assertion
+             *
+             * \param line The line
+             *
+             * \return @c true if it's a @c test line
+             *
+             * @since test-cascades 1.1.5
+             */
+            static bool isAssertion(const QString& line);
+            /*!
+             * \brief gestureEnd Find the end of a touch that starts with a
+             * @c Down on @c start
+             *
+             * \param lines The script
+             * \param start The index of the @c Down line
+             *
+             * \return The index after the last @c Up line of the touch or
+             * -1 if something else happens before the touch goes up
+             *
+             * @since test-cascades 1.1.5
+             */
+            static int gestureEnd(const QStringList& lines, const int start);
+            /*!
+             * \brief collapseTouches Replace stationary touches and drop
+             * redundant Move samples
+             *
+             * \param lines The script
+             *
+             * \return The new script
+             *
+             * @since test-cascades 1.1.5
+             */
+            QStringList collapseTouches(const QStringList& lines);
+            /*!
+             * \brief thinMoves Copy a touch dropping Move samples that
+             * haven't moved
+             *
+             * \param lines The script
+             * \param start The index of the @c Down line
+             * \param end The index after the last @c Up line
+             * \param out Where to copy the lines to
+             *
+             * @since test-cascades 1.1.5
+             */
+            void thinMoves(const QStringList& lines,
+                           const int start,
+                           const int end,
+                           QStringList * const out);
+            /*!
+             * \brief mergeSleeps Merge consecutive sleep lines
+             *
+             * \param lines The script
+             *
+             * \return The new script
+             *
+             * @since test-cascades 1.1.5
+             */
+            QStringList mergeSleeps(const QStringList& lines);
+            /*!
+             * \brief sleepsToWaits Replace sleeps before assertions with
+             * retries
+             *
+             * \param lines The script
+             *
+             * \return The new script
+             *
+             * @since test-cascades 1.1.5
+             */
+            QStringList sleepsToWaits(const QStringList& lines);
+            /*!
+             * \brief moveTolerance The distance that doesn't count as moving
+             */
+            const int moveTolerance;
+            /*!
+             * \brief longClickMs The time a touch is held for a long click
+             */
+            const int longClickMs;
+            /*!
+             * \brief retryIntervalMs The retry interval used for waits
+             */
+            const int retryIntervalMs;
+            /*!
+             * \brief useTaps @c true to use taps rather than clicks
+             */
+            const bool useTaps;
+            /*!
+             * \brief sleepsMerged The number of sleep lines merged away
+             */
+            int sleepsMerged;
+            /*!
+             * \brief movesDropped The number of Move lines dropped
+             */
+            int movesDropped;
+            /*!
+             * \brief touchesReplaced The number of touches replaced
+             */
+            int touchesReplaced;
+            /*!
+             * \brief sleepsReplaced The number of sleeps replaced by retries
+             */
+            int sleepsReplaced;
+    };
+}  // namespace optimiser
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
+
+#endif  // OPTIMISER_H_
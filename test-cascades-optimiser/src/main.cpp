@@ -0,0 +1,120 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#include <QCoreApplication>
+#include <QFile>
+#include <QStringList>
+
+#include "include/optimiser.h"
+
+using truphone::test::cascades::optimiser::ScriptOptimiser;
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QStringList args = a.arguments();
+    args.removeFirst();
+
+    if (args.size() < 2)
+    {
+        qWarning("test-cascades-optimiser <recorded script> <output script>");
+        qWarning("                        [--tolerance <px>] [--long-click <ms>]");
+        qWarning("                        [--retry-interval <ms>] [--tap]");
+        qWarning("----------------------------------------------------");
+        qWarning("test-cascades-optimiser rewrites a script recorded with --record so");
+        qWarning("that it replays faster. Touches that don't move become clicks (or");
+        qWarning("taps with --tap), Move samples that don't move are dropped, sleeps");
+        qWarning("are merged and sleeps before assertions become retries.");
+        qWarning("--retry-interval 0 leaves the sleeps before assertions alone.");
+        return -1;
+    }
+
+    const QString inputFile = args.takeFirst();
+    const QString outputFile = args.takeFirst();
+    int tolerance = 4;
+    int longClickMs = 1000;
+    int retryIntervalMs = 100;
+    bool useTaps = false;
+
+    while (not args.isEmpty())
+    {
+        const QString option = args.takeFirst();
+        if (option == "--tap")
+        {
+            useTaps = true;
+            continue;
+        }
+        if (args.isEmpty())
+        {
+            qWarning("%s needs a value", qPrintable(option));
+            return -2;
+        }
+        bool ok = false;
+        const int value = args.takeFirst().toInt(&ok);
+        if (not ok or value < 0)
+        {
+            qWarning("%s needs a number", qPrintable(option));
+            return -2;
+        }
+        if (option == "--tolerance")
+        {
+            tolerance = value;
+        }
+        else if (option == "--long-click")
+        {
+            longClickMs = value;
+        }
+        else if (option == "--retry-interval")
+        {
+            retryIntervalMs = value;
+        }
+        else
+        {
+            qWarning("Unknown option %s", qPrintable(option));
+            return -2;
+        }
+    }
+
+    QFile input(inputFile);
+    if (not input.open(QIODevice::ReadOnly bitor QIODevice::Text))
+    {
+        qWarning("Recorded script can't be opened");
+        return -3;
+    }
+    QStringList script;
+    while (not input.atEnd())
+    {
+        script.append(QString::fromUtf8(input.readLine()));
+    }
+    input.close();
+
+    ScriptOptimiser optimiser(tolerance, longClickMs, retryIntervalMs, useTaps);
+    const QStringList optimised = optimiser.optimise(script);
+
+    QFile output(outputFile);
+    if (not output.open(QIODevice::WriteOnly bitor QIODevice::Truncate))
+    {
+        qWarning("Output script can't be opened");
+        return -4;
+    }
+    QByteArray data;
+    foreach (const QString& line, optimised)
+    {
+        data += line.toUtf8() + "\r\n";
+    }
+    if (output.write(data) not_eq data.size())
+    {
+        qWarning("Failed to write the output script");
+        return -5;
+    }
+    output.close();
+
+    qWarning("%d lines in, %d lines out", script.size(), optimised.size());
+    qWarning("%d touches became clicks, %d Move lines dropped, %d sleeps merged,"
+             " %d sleeps became retries",
+             optimiser.clicks(),
+             optimiser.droppedMoves(),
+             optimiser.mergedSleeps(),
+             optimiser.waits());
+    return 0;
+}
@@ -0,0 +1,355 @@
+/**
+ * Copyright 2014 Truphone
+ */
+#include "include/optimiser.h"
+
+namespace truphone
+{
+namespace test
+{
+namespace cascades
+{
+namespace optimiser
+{
+    ScriptOptimiser::ScriptOptimiser(const int tolerance,
+                                     const int longClick,
+                                     const int retryInterval,
+                                     const bool taps)
+        : moveTolerance(tolerance),
+          longClickMs(longClick),
+          retryIntervalMs(retryInterval),
+          useTaps(taps),
+          sleepsMerged(0),
+          movesDropped(0),
+          touchesReplaced(0),
+          sleepsReplaced(0)
+    {
+    }
+
+    ScriptOptimiser::~ScriptOptimiser()
+    {
+    }
+
+    QStringList ScriptOptimiser::optimise(const QStringList& script)
+    {
+        this->sleepsMerged = 0;
+        this->movesDropped = 0;
+        this->touchesReplaced = 0;
+        this->sleepsReplaced = 0;
+
+        QStringList lines;
+        foreach (const QString& line, script)
+        {
+            const QString trimmed = line.trimmed();
+            if (not trimmed.isEmpty())
+            {
+                lines.append(trimmed);
+            }
+        }
+        // dropping touch samples leaves sleeps next to each other
+        // so they're merged afterwards
+        lines = this->collapseTouches(lines);
+        lines = this->mergeSleeps(lines);
+        return this->sleepsToWaits(lines);
+    }
+
+    ScriptOptimiser::TouchLine ScriptOptimiser::parseTouch(const QString& line)
+    {
+        TouchLine touch;
+        touch.valid = false;
+        touch.type = CANCEL;
+        // touch sx sy wx wy lx ly type receiver target
+        const QStringList tokens = line.split(' ', QString::SkipEmptyParts);
+        if (tokens.size() == 10 and tokens.at(0) == "touch")
+        {
+            bool xOk = false;
+            bool yOk = false;
+            bool typeOk = false;
+            touch.screen = QPointF(tokens.at(1).toDouble(&xOk),
+                                   tokens.at(2).toDouble(&yOk));
+            touch.type = tokens.at(7).toInt(&typeOk);
+            touch.target = tokens.at(9);
+            touch.valid = xOk and yOk and typeOk;
+        }
+        return touch;
+    }
+
+    bool ScriptOptimiser::parseSleep(const QString& line, int * const ms)
+    {
+        const QStringList tokens = line.split(' ', QString::SkipEmptyParts);
+        if (tokens.size() not_eq 2 or tokens.at(0) not_eq "sleep")
+        {
+            return false;
+        }
+        bool ok = false;
+        *ms = tokens.at(1).toInt(&ok);
+        return ok and *ms >= 0;
+    }
+
+    bool ScriptOptimiser::isAssertion(const QString& line)
+    {
+        return line == "test" or line.startsWith("test ");
+    }
+
+    int ScriptOptimiser::gestureEnd(const QStringList& lines, const int start)
+    {
+        const QString target = parseTouch(lines.at(start)).target;
+        bool up = false;
+        for (int i = start + 1 ; i < lines.size() ; i++)
+        {
+            const TouchLine sample = parseTouch(lines.at(i));
+            const bool sameTarget = sample.valid and sample.target == target;
+            if (sameTarget and sample.type == UP)
+            {
+                // one line per receiver
+                up = true;
+                continue;
+            }
+            if (up)
+            {
+                return i;
+            }
+            int ms = 0;
+            if ((sameTarget and (sample.type == DOWN or sample.type == MOVE))
+                    or parseSleep(lines.at(i), &ms)
+                    or isAssertion(lines.at(i)))
+            {
+                continue;
+            }
+            // i.e. cancelled, another target or another command
+            return -1;
+        }
+        return up ? lines.size() : -1;
+    }
+
+    QStringList ScriptOptimiser::collapseTouches(const QStringList& lines)
+    {
+        QStringList out;
+        int i = 0;
+        while (i < lines.size())
+        {
+            const TouchLine down = parseTouch(lines.at(i));
+            const int end = (down.valid and down.type == DOWN) ? gestureEnd(lines, i) : -1;
+            if (end < 0)
+            {
+                out.append(lines.at(i));
+                i++;
+                continue;
+            }
+
+            bool moved = false;
+            int heldMs = 0;
+            QStringList assertions;
+            for (int j = i ; j < end ; j++)
+            {
+                int ms = 0;
+                if (parseSleep(lines.at(j), &ms))
+                {
+                    heldMs += ms;
+                }
+                else if (isAssertion(lines.at(j)))
+                {
+                    assertions.append(lines.at(j));
+                }
+                else if ((parseTouch(lines.at(j)).screen - down.screen).manhattanLength()
+                         > this->moveTolerance)
+                {
+                    moved = true;
+                }
+            }
+
+            if (moved)
+            {
+                this->thinMoves(lines, i, end, &out);
+            }
+            else
+            {
+                // the assertions checked the state when the touch went down
+                out += assertions;
+                if (heldMs >= this->longClickMs)
+                {
+                    out.append("longClick " + down.target);
+                }
+                else if (this->useTaps)
+                {
+                    out.append("tap down " + down.target);
+                    out.append("tap up " + down.target);
+                }
+                else
+                {
+                    out.append("click " + down.target);
+                }
+                this->touchesReplaced++;
+            }
+            i = end;
+        }
+        return out;
+    }
+
+    void ScriptOptimiser::thinMoves(const QStringList& lines,
+                                    const int start,
+                                    const int end,
+                                    QStringList * const out)
+    {
+        // find the first line of the last Move sample so the
+        // touch goes up where it was released
+        int lastMove = end;
+        QPointF lastMoveAt;
+        for (int i = end - 1 ; i >= start ; i--)
+        {
+            const TouchLine sample = parseTouch(lines.at(i));
+            if (sample.valid and sample.type == MOVE)
+            {
+                if (lastMove < end and sample.screen not_eq lastMoveAt)
+                {
+                    break;
+                }
+                lastMove = i;
+                lastMoveAt = sample.screen;
+            }
+            else if (lastMove < end)
+            {
+                break;
+            }
+        }
+
+        QPointF kept;
+        QPointF sampleAt;
+        int sampleType = CANCEL;
+        bool inSample = false;
+        bool keeping = true;
+        for (int i = start ; i < end ; i++)
+        {
+            const TouchLine touch = parseTouch(lines.at(i));
+            if (not touch.valid)
+            {
+                out->append(lines.at(i));
+                inSample = false;
+                continue;
+            }
+            // the receivers of one sample follow each other
+            if (not (inSample and touch.screen == sampleAt and touch.type == sampleType))
+            {
+                inSample = true;
+                sampleAt = touch.screen;
+                sampleType = touch.type;
+                keeping = touch.type not_eq MOVE
+                        or i >= lastMove
+                        or (touch.screen - kept).manhattanLength() > this->moveTolerance;
+                if (keeping)
+                {
+                    kept = touch.screen;
+                }
+            }
+            if (keeping)
+            {
+                out->append(lines.at(i));
+            }
+            else
+            {
+                this->movesDropped++;
+            }
+        }
+    }
+
+    QStringList ScriptOptimiser::mergeSleeps(const QStringList& lines)
+    {
+        QStringList out;
+        bool sleeping = false;
+        int totalMs = 0;
+        foreach (const QString& line, lines)
+        {
+            int ms = 0;
+            if (parseSleep(line, &ms))
+            {
+                if (sleeping)
+                {
+                    this->sleepsMerged++;
+                }
+                sleeping = true;
+                totalMs += ms;
+                continue;
+            }
+            if (sleeping)
+            {
+                out.append(QString("sleep %1").arg(totalMs));
+                sleeping = false;
+                totalMs = 0;
+            }
+            out.append(line);
+        }
+        if (sleeping)
+        {
+            out.append(QString("sleep %1").arg(totalMs));
+        }
+        return out;
+    }
+
+    QStringList ScriptOptimiser::sleepsToWaits(const QStringList& lines)
+    {
+        if (this->retryIntervalMs <= 0)
+        {
+            return lines;
+        }
+
+        // the script's own settings, an empty value is the CLI default
+        bool retry = false;
+        QString interval;
+        QString maxIntervals;
+
+        QStringList out;
+        for (int i = 0 ; i < lines.size() ; i++)
+        {
+            const QString& line = lines.at(i);
+            const QStringList tokens = line.split(' ', QString::SkipEmptyParts);
+            if (tokens.size() >= 2 and tokens.at(0) == "cli-setting")
+            {
+                const QString value = tokens.size() > 2 ? tokens.at(2) : QString();
+                if (tokens.at(1) == "retry")
+                {
+                    retry = (value == "true" or value.toInt() > 0);
+                }
+                else if (tokens.at(1) == "retry-interval")
+                {
+                    interval = value;
+                }
+                else if (tokens.at(1) == "retry-max-intervals")
+                {
+                    maxIntervals = value;
+                }
+                out.append(line);
+                continue;
+            }
+
+            int ms = 0;
+            // if the script is already retrying the sleep is left alone
+            // as it may be there for the retries to succeed
+            if (not retry
+                    and parseSleep(line, &ms)
+                    and i + 1 < lines.size()
+                    and isAssertion(lines.at(i + 1)))
+            {
+                const int intervals = qMax(1, (ms + this->retryIntervalMs - 1)
+                                           / this->retryIntervalMs);
+                out.append("cli-setting retry true");
+                out.append(QString("cli-setting retry-interval %1").arg(this->retryIntervalMs));
+                out.append(QString("cli-setting retry-max-intervals %1").arg(intervals));
+                while (i + 1 < lines.size() and isAssertion(lines.at(i + 1)))
+                {
+                    i++;
+                    out.append(lines.at(i));
+                }
+                out.append("cli-setting retry");
+                out.append(("cli-setting retry-interval " + interval).trimmed());
+                out.append(("cli-setting retry-max-intervals " + maxIntervals).trimmed());
+                this->sleepsReplaced++;
+                continue;
+            }
+            out.append(line);
+        }
+        return out;
+    }
+}  // namespace optimiser
+}  // namespace cascades
+}  // namespace test
+}  // namespace truphone
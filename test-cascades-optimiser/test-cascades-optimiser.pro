@@ -0,0 +1,25 @@
+#-------------------------------------------------
+#
+# Offline optimiser for scripts recorded
+# with test-cascades-cli --record
+#
+#-------------------------------------------------
+
+QT       += core
+
+QT       -= gui
+
+TARGET = test-cascades-optimiser
+CONFIG   += console
+CONFIG   -= app_bundle
+
+INCLUDEPATH += include
+
+TEMPLATE = app
+
+
+SOURCES += src/main.cpp \
+    src/optimiser.cpp
+
+HEADERS += \
+    include/optimiser.h